@@ -0,0 +1,153 @@
+classdef NeuroRobot_brain
+   
+    properties
+        % Handle of the brain inside mex
+        handle
+    end
+    
+    methods
+        
+        % Constructor
+        function brainObject = NeuroRobot_brain()
+            brainObject.handle = NeuroRobot_BrainBridge( 'init' );
+        end
+        
+        % Sets neuron parameters and state, resizes the brain if the number of neurons changed
+        function setNeurons(this, a, b, c, d, v, u)
+            NeuroRobot_BrainBridge( 'setNeurons', this.handle, a, b, c, d, v, u );
+        end
+        
+        % Reads membrane potential and recovery variable
+        function [v, u] = getState(this)
+            [v, u] = NeuroRobot_BrainBridge( 'getState', this.handle );
+        end
+        
+        % Sets nneurons x nneurons synaptic weights, full or sparse, only nonzero weights are stored
+        function setConnectome(this, connectome)
+            NeuroRobot_BrainBridge( 'setConnectome', this.handle, connectome );
+        end
+        
+        % Reads synaptic weights
+        function connectome = getConnectome(this)
+            connectome = NeuroRobot_BrainBridge( 'getConnectome', this.handle );
+        end
+        
+        % Sets plastic synapses from nneurons x nneurons x 3 da_connectome, call after setConnectome
+        % Returns linear indices of plastic synapses in connectome, order of weights returned by learn
+        function plastic_index = setPlasticity(this, da_connectome)
+            plastic_index = NeuroRobot_BrainBridge( 'setPlasticity', this.handle, da_connectome );
+        end
+        
+        % Learning (STDP) and forgetting of plastic synapses after a step, learned weights are used by following steps
+        % changes has [presynaptic postsynaptic weight cause] rows for synapses which rounded weight changed,
+        % cause is 1 for reinforcement and 2 for forgetting
+        % plastic_w and plastic_intensity are connectome and da_connectome(:, :, 3) values of all plastic synapses
+        function [changes, plastic_w, plastic_intensity] = learn(this, firing, steps_since_last_spike, reward, pulse_period, ltp_recency_th_in_steps, permanent_memory_th, max_w)
+            [changes, plastic_w, plastic_intensity] = NeuroRobot_BrainBridge( 'learn', this.handle, firing, steps_since_last_spike, reward, pulse_period, ltp_recency_th_in_steps, permanent_memory_th, max_w );
+        end
+        
+        % Seeds noise generator used when noise is not forwarded to step, uint64 or double
+        % Every brain gets a random seed, the same seed replays the same noise bit-exactly
+        function setSeed(this, seed)
+            NeuroRobot_BrainBridge( 'setSeed', this.handle, seed );
+        end
+        
+        % Reads seed of noise generator as uint64, needed to replay a run
+        function seed = getSeed(this)
+            seed = NeuroRobot_BrainBridge( 'getSeed', this.handle );
+        end
+        
+        % Splits neurons between threads, results do not depend on number of threads when noise is forwarded to step
+        % Returns number of threads actually used
+        function numberOfThreads = setNumberOfThreads(this, numberOfThreads)
+            numberOfThreads = NeuroRobot_BrainBridge( 'setNumberOfThreads', this.handle, numberOfThreads );
+        end
+        
+        % Switches neuron state and weights to float32 (true) or float64 (false)
+        % float32 halves memory traffic, spikes differ from MATLAB within rounding
+        function setSinglePrecision(this, singlePrecision)
+            NeuroRobot_BrainBridge( 'setSinglePrecision', this.handle, singlePrecision );
+        end
+        
+        % Runs ms_per_step ms of simulation
+        % sensoryCurrent columns are added in order, e.g. [vis_I dist_I audio_I]
+        % noise is randn(nneurons, ms_per_step), results are the same as in update_brain loop for the same noise
+        % Without noise (or with empty noise), it is generated inside from the seed
+        % reward is used by basal ganglia selection, spikes_step is gated by selected network once setBasalGanglia is called
+        function [spikes_step, I_step] = step(this, ms_per_step, sensoryCurrent, noise, reward)
+            if nargin < 4
+                noise = [];
+            end
+            if nargin < 5
+                reward = 0;
+            end
+            [spikes_step, I_step] = NeuroRobot_BrainBridge( 'step', this.handle, ms_per_step, sensoryCurrent, noise, reward );
+        end
+        
+        % Sets networks of basal ganglia selection, network_drive is nnetworks x 3
+        % With bg_brain networks compete and spikes of neurons outside selected network and network 1 are removed from step output,
+        % without it only bg_neurons are silenced
+        function setBasalGanglia(this, network_ids, bg_neurons, network_drive, bg_brain)
+            NeuroRobot_BrainBridge( 'setBasalGanglia', this.handle, network_ids, bg_neurons, network_drive, bg_brain );
+        end
+        
+        % Reads result of basal ganglia selection of last step
+        % activity_changes is 1 for networks activated and -1 for networks deactivated in last step
+        function [this_network, network_drive, activity_changes, down_neurons] = getSelection(this)
+            [this_network, network_drive, activity_changes, down_neurons] = NeuroRobot_BrainBridge( 'getSelection', this.handle );
+        end
+        
+        % Records spikes of every step compressed, memory stays flat for any run time (recording = 0 stops it)
+        % Spikes of last retention_ms ms (default 10 min) are kept in memory, whole run is written to file if given
+        function setRecording(this, recording, retention_ms, file)
+            if nargin < 3
+                retention_ms = [];
+            end
+            if nargin < 4
+                NeuroRobot_BrainBridge( 'setRecording', this.handle, recording, retention_ms );
+            else
+                NeuroRobot_BrainBridge( 'setRecording', this.handle, recording, retention_ms, file );
+            end
+        end
+        
+        % Reads recorded spikes of ms from_ms to to_ms, ms are counted from 1 since recording started
+        % neurons and times are columns, like [neurons, times] = find(spikes_loop)
+        function [neurons, times, recorded_ms] = getSpikes(this, from_ms, to_ms)
+            [neurons, times, recorded_ms] = NeuroRobot_BrainBridge( 'getSpikes', this.handle, from_ms, to_ms );
+        end
+        
+        % Number of recorded ms and bytes of spikes in memory
+        function [recorded_ms, memory_bytes] = getRecordedMs(this)
+            [recorded_ms, memory_bytes] = NeuroRobot_BrainBridge( 'getRecordedMs', this.handle );
+        end
+        
+        % Frees the brain inside mex
+        function release(this)
+            NeuroRobot_BrainBridge( 'release', this.handle );
+        end
+    end
+    
+    methods (Static)
+        
+        % Reads brain image (.nrb), returns the same brain struct as load of .mat brain except network
+        function brain = loadImage(path)
+            brain = NeuroRobot_BrainBridge( 'loadImage', path );
+        end
+        
+        % Reads spikes of ms from_ms to to_ms from file written by setRecording
+        function [neurons, times] = readSpikeFile(path, from_ms, to_ms)
+            if nargin < 2
+                from_ms = 1;
+            end
+            if nargin < 3
+                to_ms = inf;
+            end
+            [neurons, times] = NeuroRobot_BrainBridge( 'readSpikeFile', path, from_ms, to_ms );
+        end
+        
+        % Writes double and logical fields of brain struct as brain image (.nrb), mostly empty arrays are stored sparse
+        function saveImage(path, brain)
+            NeuroRobot_BrainBridge( 'saveImage', path, brain );
+        end
+    end
+end
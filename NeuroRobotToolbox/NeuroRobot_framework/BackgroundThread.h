@@ -9,49 +9,128 @@
 #ifndef _BackgroundThread_h
 #define _BackgroundThread_h
 
+#include "Core/ThreadSettings.h"
+#include "Core/Semaphore.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <thread>
 #include <iostream>
 
 /// Defines the base class for threading from MEX files.
-/// Only run() needs to be overloaded.
+/// Only run() needs to be overloaded. `run()` has to return soon after `stop()`, derived class calls `join()` in its destructor,
+/// before its members used by `run()` are destroyed.
 class BackgroundThread {
     
 private:
-    int _running = false;
     
-    /// Start `run()` and set flags
-    void start()
+    std::thread thread;
+    
+    /// Stop token, checked by `run()`
+    std::atomic<bool> running;
+    
+    /// Signalled by `stop()`, wakes threads sleeping in `sleepUntil()`
+    Semaphore stopSignal;
+    
+    /// Scheduling of worker, applied by worker itself when it starts
+    ThreadSettings threadSettings;
+    std::string threadSettingsError;
+    
+    /// Apply scheduling, report result to `startThreaded()` and run worker
+    void start(std::promise<std::string> *settingsApplied)
     {
-        if (!isRunning()) {
-            _running = true;
-            this->run();
+        std::string error;
+        if (!threadSettings.isDefault()) {
+            applyThreadSettings(threadSettings, error);
         }
+        settingsApplied->set_value(error);
+        this->run();
     }
     
 public:
+    
+    BackgroundThread()
+    : running(false)
+    {
+    }
+    
+    virtual ~BackgroundThread()
+    {
+        join();
+    }
 
     /// Overload this. The actual worker thread method
     virtual void run() = 0;
+    
+    /// Scheduling of worker, used by the next `startThreaded()`.
+    void setThreadSettings(const ThreadSettings &settings)
+    {
+        threadSettings = settings;
+    }
+    
+    /// Reason why scheduling of the last started worker could not be applied, empty on success.
+    const std::string &readThreadSettingsError()
+    {
+        return threadSettingsError;
+    }
 
-    /// Run `start()` in a background thread
+    /// Run `run()` in a background thread. Returns when scheduling of the thread is applied.
     void startThreaded()
     {
-        if (!isRunning()) {
-            std::thread processThread(&BackgroundThread::start, this);
-            processThread.detach();
+        if (isRunning()) { return; }
+        
+        /// Worker of previous start is finished after stop
+        if (thread.joinable()) {
+            thread.join();
         }
+        /// Signal of previous stop is consumed, so sleeps of the new worker are not cut short
+        while (stopSignal.tryWait()) {}
+        running = true;
+        std::promise<std::string> settingsApplied;
+        thread = std::thread(&BackgroundThread::start, this, &settingsApplied);
+        threadSettingsError = settingsApplied.get_future().get();
     }
     
     /// @return Whether worker is running
     bool isRunning()
     {
-        return _running;
+        return running.load(std::memory_order_acquire);
     }
     
-    /// Stop the worker
+    /// Ask worker to stop, does not wait.
     void stop()
     {
-        _running = false;
+        running.store(false, std::memory_order_release);
+        stopSignal.signal();
+    }
+    
+    /// Sleep until `deadline` or until `stop()`, whichever comes first.
+    /// Used by worker and by tasks of worker on other threads instead of plain sleep, so `join()` does not wait for their sleeps.
+    /// @return Whether worker is still running
+    bool sleepUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        if (stopSignal.waitUntil(deadline)) {
+            /// Pass signal on, so every other sleeping thread and every later sleep returns immediately too
+            stopSignal.signal();
+        }
+        return isRunning();
+    }
+    
+    /// Sleep for `duration` or until `stop()`, whichever comes first.
+    /// @return Whether worker is still running
+    bool sleepFor(std::chrono::steady_clock::duration duration)
+    {
+        return sleepUntil(std::chrono::steady_clock::now() + duration);
+    }
+    
+    /// Stop worker and wait until `run()` returns.
+    void join()
+    {
+        stop();
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+            thread.join();
+        }
     }
 };
 
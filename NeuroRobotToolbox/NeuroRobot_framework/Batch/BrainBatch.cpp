@@ -0,0 +1,300 @@
+//
+//  BrainBatch.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Runs many brains without GUI, e.g. all of ./Brains (brain images or .mat files) or variants saved from brain_gen_build_*.m, and writes what they did.
+//  Every brain runs `--seeds` times with different noise and initial state, every run is one job.
+//  Brains are loaded first (libmat is not thread safe), then jobs run in parallel, one brain simulation per core.
+//  Idle workers take the next job from a shared queue ordered from the largest brain down, so no core waits on a long brain at the end.
+//
+//  Every step does what `update_brain.m` and `update_motors.m` do at runtime: sensory currents, simulation,
+//  basal ganglia selection, learning and motor output. Input is recorded by runtime (`data.vis_pref_vals`, `data.this_distance`
+//  of ./Data/*.mat with `save_data_and_commands`) or synthetic.
+//
+//  Written to output folder:
+//      summary.csv                         one row per run: neurons, synapses, spike rates, share of active neurons, motor activity
+//      <brain>_<seed>_motors.csv           motor_command of every step: right torque, right direction, left torque, left direction
+//      <brain>_<seed>_firing.csv           spikes and spike rate (Hz) of every neuron
+//
+//  Usage:
+//      BrainBatch [--steps 600] [--seeds 1] [--threads all] [--input recorded.mat] [--output BatchResults] [--no-learning] [--no-bg] brain.nrb|brain.mat ...
+//
+//  Build (macOS, from NeuroRobotToolbox folder, MATLAB libraries for .mat files):
+//      clang++ -std=c++14 -O3 NeuroRobot_framework/Batch/BrainBatch.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -I$MATLAB/extern/include -L$MATLAB/bin/maci64 -lmat -lmx -Wl,-rpath,$MATLAB/bin/maci64 -o BrainBatch
+//
+
+#include "Batch/BrainFile.h"
+#include "Batch/SensoryInput.h"
+#include "Brain/BrainSimulation.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+/// Runtime constants of `neurorobot.m`.
+const static double pulsePeriod = 0.1;
+const static unsigned int msPerStep = 100;
+const static double maxWeight = 100;
+const static double permanentMemoryThreshold = 24;
+const static double ltpRecencyThresholdInSteps = 20;
+
+struct BatchOptions {
+    size_t numberOfSteps = 600;
+    unsigned int numberOfSeeds = 1;
+    unsigned int numberOfThreads = 0;
+    std::string inputPath;
+    std::string outputFolder = "BatchResults";
+    bool learning = true;
+    bool basalGanglia = true;
+    std::vector<std::string> brainPaths;
+};
+
+/// One run of one brain.
+struct Job {
+    const BrainDescription *brain;
+    unsigned int seed;
+
+    /// Summary row, filled by the job
+    std::string summary;
+    bool done = false;
+};
+
+static std::string runName(const Job &job)
+{
+    return job.brain->name + "_" + std::to_string(job.seed);
+}
+
+/// Runs one brain for all steps and writes its files.
+static void runJob(Job &job, const BatchOptions &options, const SensoryInput &recordedInput, bool hasRecordedInput)
+{
+    const BrainDescription &brain = *job.brain;
+    const size_t n = brain.numberOfNeurons;
+    std::mt19937_64 generator(job.seed);
+
+    /// Initial state of `load_or_initialize_brain.m`
+    std::vector<double> v(n), u(n);
+    std::normal_distribution<double> normal;
+    for (size_t i = 0; i < n; i++) {
+        v[i] = brain.c[i] + 5 * normal(generator);
+        u[i] = brain.b[i] * v[i];
+    }
+
+    /// `update_brain.m` clamps whole connectome, learning clamps only plastic synapses, other weights do not change
+    std::vector<double> weights(brain.weights);
+    for (double &weight : weights) {
+        weight = std::min(weight, maxWeight);
+    }
+
+    BrainSimulation simulation;
+    simulation.setNumberOfThreads(1);
+    simulation.setSeed(job.seed);
+    simulation.setNeurons(n, brain.a.data(), brain.b.data(), brain.c.data(), brain.d.data(), v.data(), u.data());
+    simulation.setSparseConnectome(brain.columnPointers.data(), brain.rowIndices.data(), weights.data());
+    if (options.learning) {
+        simulation.setSparsePlasticity(brain.daColumnPointers.data(), brain.daRowIndices.data(), brain.daValues.data());
+    }
+    simulation.setBasalGanglia(brain.networkIds.data(), brain.basalGangliaNeurons.data(), brain.numberOfNetworks, brain.networkDrive.data(), options.basalGanglia);
+
+    SensoryInput input = hasRecordedInput ? recordedInput : SensoryInput(brain.numberOfVisualPreferences, job.seed);
+    SynapticPlasticity::Parameters learningParameters = { pulsePeriod, ltpRecencyThresholdInSteps, permanentMemoryThreshold, maxWeight };
+
+    std::vector<double> sensoryCurrent;
+    std::vector<uint8_t> spikes(n * msPerStep);
+    std::vector<double> currents(n * msPerStep);
+    std::vector<uint8_t> firing(n);
+    std::vector<double> stepsSinceLastSpike(n, NAN);
+    std::vector<uint32_t> spikesPerNeuron(n, 0);
+    std::vector<SynapticPlasticity::Change> changes;
+
+    std::ofstream motors(options.outputFolder + "/" + runName(job) + "_motors.csv");
+    motors << "step,right_torque,right_dir,left_torque,left_dir\n";
+
+    size_t movingSteps = 0;
+    double torqueSum = 0;
+    for (size_t step = 0; step < options.numberOfSteps; step++) {
+        input.currents(step, brain, sensoryCurrent);
+        simulation.step(msPerStep, sensoryCurrent.data(), 2, NULL, 0, spikes.data(), currents.data());
+
+        for (size_t i = 0; i < n; i++) {
+            firing[i] = 0;
+        }
+        for (size_t t = 0; t < msPerStep; t++) {
+            const uint8_t *spikesNow = &spikes[t * n];
+            for (size_t i = 0; i < n; i++) {
+                spikesPerNeuron[i] += spikesNow[i];
+                firing[i] |= spikesNow[i];
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (firing[i]) { stepsSinceLastSpike[i] = 0; }
+            stepsSinceLastSpike[i] = stepsSinceLastSpike[i] + 1;
+        }
+
+        if (options.learning) {
+            changes.clear();
+            simulation.learn(firing.data(), stepsSinceLastSpike.data(), 0, learningParameters, changes);
+        }
+
+        MotorCommand command = motorCommand(brain, firing.data());
+        motors << step + 1 << "," << command.rightTorque << "," << command.rightDirection << "," << command.leftTorque << "," << command.leftDirection << "\n";
+        torqueSum += command.leftTorque + command.rightTorque;
+        movingSteps += command.leftTorque || command.rightTorque;
+    }
+
+    /// Firing statistics
+    const double seconds = options.numberOfSteps * pulsePeriod;
+    std::ofstream firingFile(options.outputFolder + "/" + runName(job) + "_firing.csv");
+    firingFile << "neuron,spikes,rate_hz\n";
+    size_t totalSpikes = 0;
+    size_t activeNeurons = 0;
+    for (size_t i = 0; i < n; i++) {
+        firingFile << i + 1 << "," << spikesPerNeuron[i] << "," << spikesPerNeuron[i] / seconds << "\n";
+        totalSpikes += spikesPerNeuron[i];
+        activeNeurons += spikesPerNeuron[i] > 0;
+    }
+
+    std::ostringstream summary;
+    summary << brain.name << "," << job.seed << "," << n << "," << brain.numberOfSynapses() << "," << options.numberOfSteps
+        << "," << (n ? totalSpikes / seconds / n : 0)
+        << "," << (n ? (double)activeNeurons / n : 0)
+        << "," << (double)movingSteps / options.numberOfSteps
+        << "," << torqueSum / (2.0 * options.numberOfSteps);
+    job.summary = summary.str();
+}
+
+static bool parseOptions(int argc, char *argv[], BatchOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--steps" && hasValue) {
+            options.numberOfSteps = (size_t)atol(argv[++i]);
+        } else if (argument == "--seeds" && hasValue) {
+            options.numberOfSeeds = (unsigned int)atoi(argv[++i]);
+        } else if (argument == "--threads" && hasValue) {
+            options.numberOfThreads = (unsigned int)atoi(argv[++i]);
+        } else if (argument == "--input" && hasValue) {
+            options.inputPath = argv[++i];
+        } else if (argument == "--output" && hasValue) {
+            options.outputFolder = argv[++i];
+        } else if (argument == "--no-learning") {
+            options.learning = false;
+        } else if (argument == "--no-bg") {
+            options.basalGanglia = false;
+        } else if (argument.compare(0, 2, "--") == 0) {
+            return false;
+        } else {
+            options.brainPaths.push_back(argument);
+        }
+    }
+    return !options.brainPaths.empty() && options.numberOfSteps > 0 && options.numberOfSeeds > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    BatchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " [--steps 600] [--seeds 1] [--threads all] [--input recorded.mat] [--output BatchResults] [--no-learning] [--no-bg] brain.nrb|brain.mat ..." << std::endl;
+        return 1;
+    }
+
+#ifdef _WIN32
+    _mkdir(options.outputFolder.c_str());
+#else
+    mkdir(options.outputFolder.c_str(), 0755);
+#endif
+
+    std::string error;
+    SensoryInput recordedInput(0, 0);
+    bool hasRecordedInput = !options.inputPath.empty();
+    if (hasRecordedInput && !recordedInput.loadRecorded(options.inputPath, error)) {
+        std::cout << error << std::endl;
+        return 1;
+    }
+
+    /// Brains are loaded on this thread, libmat is not thread safe
+    std::vector<BrainDescription> brains;
+    brains.reserve(options.brainPaths.size());
+    for (const std::string &path : options.brainPaths) {
+        BrainDescription brain;
+        if (loadBrain(path, brain, error)) {
+            brains.push_back(std::move(brain));
+        } else {
+            std::cout << "Skipping " << path << ": " << error << std::endl;
+        }
+    }
+
+    /// Largest brains first, so the last jobs are short
+    std::vector<Job> jobs;
+    for (const BrainDescription &brain : brains) {
+        for (unsigned int seed = 1; seed <= options.numberOfSeeds; seed++) {
+            Job job;
+            job.brain = &brain;
+            job.seed = seed;
+            jobs.push_back(job);
+        }
+    }
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job &first, const Job &second) {
+        return first.brain->numberOfNeurons + first.brain->numberOfSynapses() > second.brain->numberOfNeurons + second.brain->numberOfSynapses();
+    });
+
+    unsigned int numberOfThreads = options.numberOfThreads ? options.numberOfThreads : std::max(1u, std::thread::hardware_concurrency());
+    numberOfThreads = std::min(numberOfThreads, (unsigned int)std::max<size_t>(jobs.size(), 1));
+    std::cout << brains.size() << " brains, " << jobs.size() << " runs of " << options.numberOfSteps << " steps on " << numberOfThreads << " threads" << std::endl;
+
+    std::atomic<size_t> nextJob(0);
+    std::atomic<size_t> finishedJobs(0);
+    std::mutex printMutex;
+    auto begin = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        for (size_t index = nextJob++; index < jobs.size(); index = nextJob++) {
+            runJob(jobs[index], options, recordedInput, hasRecordedInput);
+            jobs[index].done = true;
+
+            std::lock_guard<std::mutex> lock(printMutex);
+            std::cout << "[" << ++finishedJobs << "/" << jobs.size() << "] " << runName(jobs[index]) << std::endl;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numberOfThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::ofstream summary(options.outputFolder + "/summary.csv");
+    summary << "brain,seed,neurons,synapses,steps,mean_rate_hz,active_neurons,moving_steps,mean_torque\n";
+    for (const Job &job : jobs) {
+        if (job.done) {
+            summary << job.summary << "\n";
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Done in " << std::fixed << std::setprecision(1) << seconds << " s, results in " << options.outputFolder << std::endl;
+    return 0;
+}
@@ -0,0 +1,269 @@
+//
+//  BrainFile.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BrainFile.h"
+#include "Brain/BrainImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <set>
+#include <mat.h>
+
+/// Columns of `neuron_contacts` which drive motors, `update_motors.m`.
+const static size_t leftForwardContacts[2] = { 5, 7 };
+const static size_t rightForwardContacts[2] = { 9, 11 };
+const static size_t leftBackwardContacts[2] = { 6, 8 };
+const static size_t rightBackwardContacts[2] = { 10, 12 };
+const static double maxTorque = 250;
+
+/// Finds variable of brain by name, as section of brain image or as view of MATLAB array.
+typedef std::function<bool(const char *name, BrainImage::Section &field)> FieldFinder;
+
+/// Reads double or logical field as full array, sparse fields are expanded.
+static bool readArray(const FieldFinder &find, const char *name, std::vector<double> &values, BrainImage::Section &field)
+{
+    if (!find(name, field)) { return false; }
+
+    size_t numberOfElements = field.numberOfElements();
+    if (field.sparse) {
+        const size_t rows = field.dimensions[0];
+        const size_t columns = field.dimensions[1] * field.dimensions[2];
+        values.assign(numberOfElements, 0);
+        for (size_t column = 0; column < columns; column++) {
+            for (size_t i = field.columnPointers[column]; i < field.columnPointers[column + 1]; i++) {
+                values[column * rows + field.rowIndices[i]] = field.values[i];
+            }
+        }
+    } else if (field.type == BrainImage::SectionTypeDouble) {
+        const double *data = (const double *)field.data;
+        values.assign(data, data + numberOfElements);
+    } else {
+        const uint8_t *data = (const uint8_t *)field.data;
+        values.assign(data, data + numberOfElements);
+    }
+    return true;
+}
+
+/// Reads field of brain which must hold `numberOfElements` values.
+static bool readField(const FieldFinder &find, const char *name, size_t numberOfElements, std::vector<double> &values, std::string &error)
+{
+    BrainImage::Section field;
+    if (!readArray(find, name, values, field) || values.size() != numberOfElements) {
+        error = std::string("Field ") + name + " is missing or has wrong size.";
+        return false;
+    }
+    return true;
+}
+
+/// Reads double field into CSC over all columns of all pages, from full or sparse array, only nonzero values.
+/// @param pages Number of pages of result, missing pages are empty
+static bool readSparse(const FieldFinder &find, const char *name, size_t pages, std::vector<size_t> &columnPointers, std::vector<size_t> &rowIndices, std::vector<double> &weights)
+{
+    BrainImage::Section field;
+    if (!find(name, field) || field.type != BrainImage::SectionTypeDouble) { return false; }
+
+    const size_t rows = field.dimensions[0];
+    const size_t columns = field.dimensions[1] * field.dimensions[2];
+    columnPointers.assign(1, 0);
+    rowIndices.clear();
+    weights.clear();
+    for (size_t column = 0; column < columns; column++) {
+        if (field.sparse) {
+            for (size_t i = field.columnPointers[column]; i < field.columnPointers[column + 1]; i++) {
+                if (field.values[i] == 0) { continue; }
+                rowIndices.push_back(field.rowIndices[i]);
+                weights.push_back(field.values[i]);
+            }
+        } else {
+            const double *values = (const double *)field.data + column * rows;
+            for (size_t row = 0; row < rows; row++) {
+                if (values[row] == 0) { continue; }
+                rowIndices.push_back(row);
+                weights.push_back(values[row]);
+            }
+        }
+        columnPointers.push_back(rowIndices.size());
+    }
+    columnPointers.resize(field.dimensions[1] * pages + 1, rowIndices.size());
+    return true;
+}
+
+static bool readBrain(const FieldFinder &find, BrainDescription &brain, std::string &error)
+{
+    BrainImage::Section field;
+    if (!find("nneurons", field) || field.numberOfElements() != 1 || field.type != BrainImage::SectionTypeDouble || field.sparse) {
+        error = "Field nneurons is missing.";
+        return false;
+    }
+    const size_t n = (size_t)*(const double *)field.data;
+    brain.numberOfNeurons = n;
+
+    if (!readField(find, "a", n, brain.a, error)) { return false; }
+    if (!readField(find, "b", n, brain.b, error)) { return false; }
+    if (!readField(find, "c", n, brain.c, error)) { return false; }
+    if (!readField(find, "d", n, brain.d, error)) { return false; }
+    if (!readField(find, "network_ids", n, brain.networkIds, error)) { return false; }
+    if (!readField(find, "dist_prefs", n, brain.distancePreferences, error)) { return false; }
+
+    if (!find("connectome", field) || field.dimensions[0] != n || field.dimensions[1] != n || field.dimensions[2] != 1
+        || !readSparse(find, "connectome", 1, brain.columnPointers, brain.rowIndices, brain.weights)) {
+        error = "Field connectome is missing or is not a double nneurons x nneurons matrix.";
+        return false;
+    }
+
+    /// Old brains have only two pages of `da_connectome`, learning intensity starts at zero
+    if (!find("da_connectome", field) || field.dimensions[0] != n || field.dimensions[1] != n || (field.dimensions[2] != 3 && field.dimensions[2] != 2)
+        || !readSparse(find, "da_connectome", 3, brain.daColumnPointers, brain.daRowIndices, brain.daValues)) {
+        error = "Field da_connectome is missing or has wrong size.";
+        return false;
+    }
+
+    if (!readArray(find, "neuron_contacts", brain.neuronContacts, field) || field.dimensions[0] != n) {
+        error = "Field neuron_contacts is missing or has wrong size.";
+        return false;
+    }
+    brain.numberOfContacts = field.dimensions[1] * field.dimensions[2];
+
+    if (!readArray(find, "vis_prefs", brain.visualPreferences, field) || field.dimensions[0] != n || brain.visualPreferences.size() % (2 * n)) {
+        error = "Field vis_prefs is missing or has wrong size.";
+        return false;
+    }
+    brain.numberOfVisualPreferences = n ? brain.visualPreferences.size() / (2 * n) : 0;
+
+    if (!readArray(find, "bg_neurons", brain.basalGangliaNeurons, field) || brain.basalGangliaNeurons.size() != n) {
+        brain.basalGangliaNeurons.assign(n, 0);
+    }
+
+    /// `nnetworks = length(unique(network_ids))`, drive is reset if it does not fit, only first `nnetworks` rows compete
+    const size_t networks = std::set<double>(brain.networkIds.begin(), brain.networkIds.end()).size();
+    brain.numberOfNetworks = networks;
+    std::vector<double> drive;
+    brain.networkDrive.assign(networks * 3, 0);
+    if (readArray(find, "network_drive", drive, field) && !drive.empty() && field.dimensions[0] >= networks && field.dimensions[1] == 3) {
+        const size_t rows = field.dimensions[0];
+        for (size_t column = 0; column < 3; column++) {
+            for (size_t network = 0; network < networks; network++) {
+                brain.networkDrive[column * networks + network] = drive[column * rows + network];
+            }
+        }
+    }
+
+    return true;
+}
+
+/// Name is file name without folder and extension
+static std::string brainName(const std::string &path)
+{
+    size_t nameBegin = path.find_last_of("/\\");
+    nameBegin = nameBegin == std::string::npos ? 0 : nameBegin + 1;
+    size_t nameEnd = path.rfind('.');
+    return path.substr(nameBegin, nameEnd == std::string::npos || nameEnd < nameBegin ? std::string::npos : nameEnd - nameBegin);
+}
+
+bool loadBrainFromMat(const std::string &path, BrainDescription &brain, std::string &error)
+{
+    MATFile *file = matOpen(path.c_str(), "r");
+    if (!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    mxArray *brainStruct = matGetVariable(file, "brain");
+    bool loaded = false;
+    if (!brainStruct || !mxIsStruct(brainStruct)) {
+        error = "File has no brain struct.";
+    } else {
+        /// MATLAB arrays are viewed the same way as sections of brain image, without copying
+        FieldFinder find = [brainStruct](const char *name, BrainImage::Section &field) {
+            const mxArray *array = mxGetField(brainStruct, 0, name);
+            if (!array || !(mxIsDouble(array) || mxIsLogical(array)) || mxIsComplex(array) || mxGetNumberOfDimensions(array) > 3) { return false; }
+
+            const mwSize *dimensions = mxGetDimensions(array);
+            field = BrainImage::Section();
+            field.name = name;
+            field.type = mxIsDouble(array) ? BrainImage::SectionTypeDouble : BrainImage::SectionTypeLogical;
+            field.numberOfDimensions = mxGetNumberOfDimensions(array);
+            for (size_t dimension = 0; dimension < 3; dimension++) {
+                field.dimensions[dimension] = dimension < field.numberOfDimensions ? dimensions[dimension] : 1;
+            }
+            field.sparse = mxIsSparse(array);
+            if (field.sparse) {
+                if (!mxIsDouble(array)) { return false; }
+                field.columnPointers = mxGetJc(array);
+                field.rowIndices = mxGetIr(array);
+                field.values = mxGetPr(array);
+                field.numberOfNonzeros = field.columnPointers[field.dimensions[1]];
+            } else {
+                field.data = mxGetData(array);
+            }
+            return true;
+        };
+        loaded = readBrain(find, brain, error);
+    }
+
+    if (brainStruct) { mxDestroyArray(brainStruct); }
+    matClose(file);
+
+    brain.name = brainName(path);
+    return loaded;
+}
+
+bool loadBrainFromImage(const std::string &path, BrainDescription &brain, std::string &error)
+{
+    BrainImage image;
+    if (!image.open(path, error)) { return false; }
+
+    FieldFinder find = [&image](const char *name, BrainImage::Section &field) {
+        const BrainImage::Section *section = image.find(name);
+        if (!section) { return false; }
+        field = *section;
+        return true;
+    };
+    bool loaded = readBrain(find, brain, error);
+
+    brain.name = brainName(path);
+    return loaded;
+}
+
+bool loadBrain(const std::string &path, BrainDescription &brain, std::string &error)
+{
+    const std::string extension = ".nrb";
+    if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return loadBrainFromImage(path, brain, error);
+    }
+    return loadBrainFromMat(path, brain, error);
+}
+
+/// Torque and direction of one motor from forward and backward drive, `update_motors.m`.
+static void motorOutput(double forward, double backward, double &torque, double &direction)
+{
+    double difference = forward * 2.5 - backward * 2.5;
+    direction = difference < 0 ? 2 : 1;
+    torque = std::min(std::fabs(difference), maxTorque);
+}
+
+MotorCommand motorCommand(const BrainDescription &brain, const uint8_t *firing)
+{
+    const size_t n = brain.numberOfNeurons;
+    auto contactSum = [&](const size_t contacts[2]) {
+        double sum = 0;
+        for (size_t k = 0; k < 2; k++) {
+            if (contacts[k] >= brain.numberOfContacts) { continue; }
+            const double *column = &brain.neuronContacts[contacts[k] * n];
+            for (size_t i = 0; i < n; i++) {
+                if (firing[i]) { sum += column[i]; }
+            }
+        }
+        return sum / 2;
+    };
+
+    MotorCommand command;
+    motorOutput(contactSum(leftForwardContacts), contactSum(leftBackwardContacts), command.leftTorque, command.leftDirection);
+    motorOutput(contactSum(rightForwardContacts), contactSum(rightBackwardContacts), command.rightTorque, command.rightDirection);
+    return command;
+}
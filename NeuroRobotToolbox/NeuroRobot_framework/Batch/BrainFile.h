@@ -0,0 +1,89 @@
+//
+//  BrainFile.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BrainFile_h
+#define BrainFile_h
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Brain as saved by `save_brain.m`, only variables needed to run it without GUI.
+/// Matrices are column-major, like in MATLAB.
+struct BrainDescription {
+
+    /// File name without folder and extension, `brain_name`
+    std::string name;
+
+    size_t numberOfNeurons = 0;
+
+    /// Izhikevich parameters
+    std::vector<double> a, b, c, d;
+
+    /// `connectome` in CSC form, column is postsynaptic neuron, only nonzero weights
+    std::vector<size_t> columnPointers;
+    std::vector<size_t> rowIndices;
+    std::vector<double> weights;
+
+    /// `da_connectome` in CSC form, `numberOfNeurons` x `numberOfNeurons * 3`, pages one after another
+    std::vector<size_t> daColumnPointers;
+    std::vector<size_t> daRowIndices;
+    std::vector<double> daValues;
+
+    /// `network_ids`, `bg_neurons` and `network_drive` (`numberOfNetworks` x 3)
+    std::vector<double> networkIds;
+    std::vector<double> basalGangliaNeurons;
+    std::vector<double> networkDrive;
+    size_t numberOfNetworks = 0;
+
+    /// `neuron_contacts`, `numberOfNeurons` x `numberOfContacts`
+    std::vector<double> neuronContacts;
+    size_t numberOfContacts = 0;
+
+    /// `vis_prefs`, `numberOfNeurons` x `numberOfVisualPreferences` x 2 (cameras)
+    std::vector<double> visualPreferences;
+    size_t numberOfVisualPreferences = 0;
+
+    /// `dist_prefs`
+    std::vector<double> distancePreferences;
+
+    /// Number of stored synapses.
+    size_t numberOfSynapses() const { return weights.size(); }
+};
+
+/// `motor_command` of one step, [right torque, right direction, left torque, left direction].
+/// Direction is 1 forward and 2 backward.
+struct MotorCommand {
+    double rightTorque, rightDirection, leftTorque, leftDirection;
+};
+
+/// Motor output of fired neurons through motor columns of `neuron_contacts`, like `update_motors.m`.
+/// @param brain Brain
+/// @param firing Nonzero for every neuron which fired in the step, `numberOfNeurons` values
+/// @return Torque and direction of both motors
+MotorCommand motorCommand(const BrainDescription &brain, const uint8_t *firing);
+
+/// Loads brain saved by `save_brain.m` (variable `brain` in .mat file). Needs MATLAB `libmat` and `libmx`.
+/// Missing optional fields get the same defaults as `load_or_initialize_brain.m`.
+/// @param path Path of .mat file
+/// @param brain Loaded brain
+/// @param error Reason when loading fails
+/// @return True on success
+bool loadBrainFromMat(const std::string &path, BrainDescription &brain, std::string &error);
+
+/// Loads brain saved as brain image (.nrb), see `BrainImage`. Does not need MATLAB libraries.
+/// @param path Path of .nrb file
+/// @param brain Loaded brain
+/// @param error Reason when loading fails
+/// @return True on success
+bool loadBrainFromImage(const std::string &path, BrainDescription &brain, std::string &error);
+
+/// Loads .nrb brain image or .mat brain, by file extension.
+bool loadBrain(const std::string &path, BrainDescription &brain, std::string &error);
+
+#endif /* BrainFile_h */
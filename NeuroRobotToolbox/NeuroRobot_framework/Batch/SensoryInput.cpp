@@ -0,0 +1,129 @@
+//
+//  SensoryInput.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "SensoryInput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mat.h>
+
+/// Largest distance reported by distance sensor, `this_distance` at start of runtime.
+const static double maxDistance = 4000;
+
+/// Largest value of one visual preference, scores of `process_visual_input.m` are scaled to 50.
+const static double maxVisualValue = 50;
+
+/// Chance per step that a synthetic object appears or disappears for one preference and camera.
+const static double objectToggleProbability = 0.05;
+
+/// `sigmoid.m`
+static double sigmoid(double x, double c, double a)
+{
+    return 1 / (1 + std::exp(-a * (x - c)));
+}
+
+SensoryInput::SensoryInput(size_t numberOfVisualPreferences_, uint64_t seed)
+: numberOfVisualPreferences(numberOfVisualPreferences_)
+, generator(seed)
+{
+    syntheticVisualValues.assign(numberOfVisualPreferences * 2, 0);
+}
+
+bool SensoryInput::loadRecorded(const std::string &path, std::string &error)
+{
+    MATFile *file = matOpen(path.c_str(), "r");
+    if (!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    bool loaded = false;
+    mxArray *data = matGetVariable(file, "data");
+    const mxArray *visual = data && mxIsStruct(data) ? mxGetField(data, 0, "vis_pref_vals") : NULL;
+    const mxArray *distance = data && mxIsStruct(data) ? mxGetField(data, 0, "this_distance") : NULL;
+    if (!visual || !distance || !mxIsDouble(visual) || !mxIsDouble(distance) || mxGetM(visual) == 0) {
+        error = "File has no data.vis_pref_vals and data.this_distance, record them with save_data_and_commands.";
+    } else {
+        numberOfVisualPreferences = mxGetM(visual);
+        size_t steps = std::min(mxGetNumberOfElements(visual) / (numberOfVisualPreferences * 2), mxGetNumberOfElements(distance));
+        visualValues.assign(mxGetPr(visual), mxGetPr(visual) + steps * numberOfVisualPreferences * 2);
+        distances.assign(mxGetPr(distance), mxGetPr(distance) + steps);
+        recorded = steps > 0;
+        loaded = recorded;
+        if (!loaded) { error = "Recorded input has no steps."; }
+    }
+
+    if (data) { mxDestroyArray(data); }
+    matClose(file);
+    return loaded;
+}
+
+size_t SensoryInput::numberOfSteps() const
+{
+    return recorded ? distances.size() : 0;
+}
+
+void SensoryInput::nextSyntheticStep()
+{
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for (double &value : syntheticVisualValues) {
+        if (uniform(generator) < objectToggleProbability) {
+            value = value ? 0 : uniform(generator) * maxVisualValue;
+        }
+    }
+
+    syntheticDistance += std::normal_distribution<double>(0, 200)(generator);
+    syntheticDistance = std::min(std::max(syntheticDistance, 0.0), maxDistance);
+}
+
+void SensoryInput::currents(size_t step, const BrainDescription &brain, std::vector<double> &currents)
+{
+    const double *values;
+    double distance;
+    if (recorded) {
+        step %= distances.size();
+        values = &visualValues[step * numberOfVisualPreferences * 2];
+        distance = distances[step];
+    } else {
+        nextSyntheticStep();
+        values = syntheticVisualValues.data();
+        distance = syntheticDistance;
+    }
+
+    sensorCurrents(brain, values, numberOfVisualPreferences, distance, currents);
+}
+
+void SensoryInput::sensorCurrents(const BrainDescription &brain, const double *values, size_t numberOfVisualValues, double distance, std::vector<double> &currents)
+{
+    const size_t n = brain.numberOfNeurons;
+    currents.assign(n * 2, 0);
+    double *visualCurrent = currents.data();
+    double *distanceCurrent = currents.data() + n;
+
+    /// Visual input current, sum of values of preferred features of both cameras
+    const size_t preferences = std::min(numberOfVisualValues, brain.numberOfVisualPreferences);
+    for (size_t camera = 0; camera < 2; camera++) {
+        for (size_t preference = 0; preference < preferences; preference++) {
+            const double *prefers = &brain.visualPreferences[(camera * brain.numberOfVisualPreferences + preference) * n];
+            double value = values[camera * numberOfVisualValues + preference];
+            for (size_t i = 0; i < n; i++) {
+                if (prefers[i]) {
+                    visualCurrent[i] += value;
+                }
+            }
+        }
+    }
+
+    /// Distance sensor input current
+    const double distanceThresholds[3] = { 200, 500, 800 };
+    for (size_t i = 0; i < n; i++) {
+        int preference = (int)brain.distancePreferences[i];
+        if (preference >= 1 && preference <= 3) {
+            distanceCurrent[i] = sigmoid(distance, distanceThresholds[preference - 1], -0.8) * 50;
+        }
+    }
+}
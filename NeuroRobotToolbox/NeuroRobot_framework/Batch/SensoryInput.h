@@ -0,0 +1,71 @@
+//
+//  SensoryInput.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SensoryInput_h
+#define SensoryInput_h
+
+#include "BrainFile.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+/// Sensor values of every brain step, recorded by runtime or synthetic, turned into sensory currents like `update_brain.m`.
+class SensoryInput {
+
+private:
+
+    /// `vis_pref_vals` of every step, `numberOfVisualPreferences` x 2 (cameras) x `numberOfSteps`
+    std::vector<double> visualValues;
+    size_t numberOfVisualPreferences = 0;
+
+    /// `this_distance` of every step
+    std::vector<double> distances;
+
+    /// Recorded input is replayed from the start when it runs out
+    bool recorded = false;
+
+    /// Synthetic input state
+    std::mt19937_64 generator;
+    std::vector<double> syntheticVisualValues;
+    double syntheticDistance = 4000;
+
+    /// Sensor values of synthetic step, objects of random colors come and go and distance drifts.
+    void nextSyntheticStep();
+
+public:
+
+    /// Synthetic input.
+    /// @param numberOfVisualPreferences `n_vis_prefs`
+    /// @param seed Seed of random sensor values
+    SensoryInput(size_t numberOfVisualPreferences, uint64_t seed);
+
+    /// Loads input recorded by runtime (`data.vis_pref_vals` and `data.this_distance` of ./Data/*.mat). Needs MATLAB `libmat` and `libmx`.
+    /// @param path Path of .mat file
+    /// @param error Reason when loading fails
+    /// @return True on success
+    bool loadRecorded(const std::string &path, std::string &error);
+
+    /// Number of recorded steps, 0 for synthetic input.
+    size_t numberOfSteps() const;
+
+    /// Sensory currents of step, `[vis_I dist_I]`.
+    /// @param step Brain step from 0, synthetic input has to be read step after step
+    /// @param brain Brain which receives the input
+    /// @param currents Output, column-major `numberOfNeurons` x 2 matrix
+    void currents(size_t step, const BrainDescription &brain, std::vector<double> &currents);
+
+    /// Sensory currents of sensor values, `[vis_I dist_I]`.
+    /// @param brain Brain which receives the input
+    /// @param visualValues `vis_pref_vals`, column-major `numberOfVisualValues` x 2 (cameras)
+    /// @param numberOfVisualValues Rows of `visualValues`, only preferences which both brain and values have are used
+    /// @param distance `this_distance`
+    /// @param currents Output, column-major `numberOfNeurons` x 2 matrix, memory is reused
+    static void sensorCurrents(const BrainDescription &brain, const double *visualValues, size_t numberOfVisualValues, double distance, std::vector<double> &currents);
+};
+
+#endif /* SensoryInput_h */
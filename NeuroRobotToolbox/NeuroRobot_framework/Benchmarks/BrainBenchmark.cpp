@@ -0,0 +1,282 @@
+//
+//  BrainBenchmark.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Runs a random sparse brain on `BrainSimulation` with 1, 2, 4 ... threads and reports how the simulation scales.
+//  Neurons are regular spiking, every neuron has the same number of random postsynaptic targets.
+//  The same noise is forwarded to every run, so every thread count must give exactly the same spikes and state.
+//  The last rows use noise generated inside `BrainSimulation` from a fixed seed, which must also match for every thread count.
+//
+//  Reported per precision and thread count: wall time of one brain step (`ms_per_step` simulated ms), speedup and parallel efficiency
+//  against one float64 thread, share of the 10 Hz `pulse_period` used by the simulation and whether results match one thread.
+//
+//  Afterwards float32 is checked against float64 reference. Spikes of the first step are compared one by one
+//  (trajectories drift apart after that). Over the whole run spikes of single neurons are dominated by noise once trajectories
+//  drift apart, so only statistics of the population are compared: total firing rate and distribution of firing rates of neurons
+//  (sorted rates, neuron identity is ignored). Their difference is compared to the spread between two float64 runs with
+//  different noise seeds, float32 passes if it is not more than `tolerance` % of total spikes above that spread.
+//  Exit code is 1 if it is.
+//
+//  The check is meaningful from around 1000 neurons and 5 steps, where seed spread is about 1 % of spikes and falls with size.
+//  With a few hundred neurons or fewer seed spread grows to several % and only gross errors of float32 are caught.
+//
+//  Usage:
+//      BrainBenchmark [neurons = 10000] [synapses per neuron = 100] [max threads = 8] [steps = 20] [tolerance % = 1]
+//
+//  Build (macOS, from NeuroRobotToolbox folder, drop -mavx2 for scalar kernels):
+//      clang++ -std=c++14 -O3 -mavx2 NeuroRobot_framework/Benchmarks/BrainBenchmark.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -o BrainBenchmark
+//
+
+#include "Brain/BrainSimulation.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+/// Simulated ms per brain step, `ms_per_step` for `pulse_period = 0.1`.
+const static unsigned int msPerStep = 100;
+
+/// Random brain in the form `BrainSimulation` takes it.
+struct RandomBrain {
+    size_t numberOfNeurons;
+    std::vector<double> a, b, c, d, v, u;
+
+    /// Synapses in CSC form, column is postsynaptic neuron
+    std::vector<size_t> columnPointers;
+    std::vector<size_t> rowIndices;
+    std::vector<double> weights;
+
+    /// Sensory current, one column
+    std::vector<double> sensoryCurrent;
+
+    /// Standard normal noise for every step
+    std::vector<std::vector<double>> noise;
+};
+
+static RandomBrain makeBrain(size_t numberOfNeurons, size_t synapsesPerNeuron, unsigned int numberOfSteps)
+{
+    RandomBrain brain;
+    brain.numberOfNeurons = numberOfNeurons;
+    brain.a.assign(numberOfNeurons, 0.02);
+    brain.b.assign(numberOfNeurons, 0.2);
+    brain.c.assign(numberOfNeurons, -65);
+    brain.d.assign(numberOfNeurons, 8);
+    brain.v.assign(numberOfNeurons, -65);
+    brain.u.assign(numberOfNeurons, -13);
+
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<size_t> neuronDistribution(0, numberOfNeurons - 1);
+    std::uniform_real_distribution<double> weightDistribution(-3, 6);
+    std::normal_distribution<double> normalDistribution;
+
+    /// Every neuron gets on average `synapsesPerNeuron` presynaptic neurons, rows in a column are ascending
+    std::vector<std::vector<size_t>> presynaptic(numberOfNeurons);
+    for (size_t pre = 0; pre < numberOfNeurons; pre++) {
+        for (size_t i = 0; i < synapsesPerNeuron; i++) {
+            presynaptic[neuronDistribution(generator)].push_back(pre);
+        }
+    }
+    brain.columnPointers.push_back(0);
+    for (size_t post = 0; post < numberOfNeurons; post++) {
+        size_t previous = (size_t)-1;
+        for (size_t pre : presynaptic[post]) {
+            if (pre == previous) { continue; }
+            brain.rowIndices.push_back(pre);
+            brain.weights.push_back(weightDistribution(generator));
+            previous = pre;
+        }
+        brain.columnPointers.push_back(brain.rowIndices.size());
+    }
+
+    brain.sensoryCurrent.resize(numberOfNeurons);
+    for (double &current : brain.sensoryCurrent) {
+        current = std::uniform_real_distribution<double>(0, 4)(generator);
+    }
+
+    brain.noise.resize(numberOfSteps);
+    for (std::vector<double> &stepNoise : brain.noise) {
+        stepNoise.resize(numberOfNeurons * msPerStep);
+        for (double &value : stepNoise) {
+            value = normalDistribution(generator);
+        }
+    }
+    return brain;
+}
+
+/// Results of one run.
+struct RunResult {
+    double stepMs = 0;
+    size_t numberOfSpikes = 0;
+    std::vector<double> finalV;
+
+    /// Spikes per neuron over timed steps
+    std::vector<uint32_t> spikesPerNeuron;
+
+    /// Spikes of the first step
+    std::vector<uint8_t> firstRaster;
+};
+
+/// Runs all steps with `numberOfThreads` threads.
+/// @param internalNoise Noise is generated by `BrainSimulation` instead of being forwarded
+/// @param seed Seed of noise generated by `BrainSimulation`
+static RunResult runBrain(const RandomBrain &brain, unsigned int numberOfThreads, bool singlePrecision, bool internalNoise, uint64_t seed = 1)
+{
+    const size_t n = brain.numberOfNeurons;
+    RunResult result;
+
+    BrainSimulation simulation;
+    simulation.setSinglePrecision(singlePrecision);
+    simulation.setNeurons(n, brain.a.data(), brain.b.data(), brain.c.data(), brain.d.data(), brain.v.data(), brain.u.data());
+    simulation.setSparseConnectome(brain.columnPointers.data(), brain.rowIndices.data(), brain.weights.data());
+    simulation.setNumberOfThreads(numberOfThreads);
+    simulation.setSeed(seed);
+
+    std::vector<uint8_t> spikes(n * msPerStep);
+    std::vector<double> currents(n * msPerStep);
+
+    /// First step warms up caches and thread pool
+    simulation.step(msPerStep, brain.sensoryCurrent.data(), 1, internalNoise ? NULL : brain.noise[0].data(), 0, spikes.data(), currents.data());
+    result.firstRaster = spikes;
+
+    result.spikesPerNeuron.assign(n, 0);
+    double elapsedMs = 0;
+    for (size_t step = 1; step < brain.noise.size(); step++) {
+        auto begin = std::chrono::steady_clock::now();
+        simulation.step(msPerStep, brain.sensoryCurrent.data(), 1, internalNoise ? NULL : brain.noise[step].data(), 0, spikes.data(), currents.data());
+        elapsedMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        for (size_t t = 0; t < msPerStep; t++) {
+            for (size_t i = 0; i < n; i++) {
+                result.spikesPerNeuron[i] += spikes[t * n + i];
+            }
+        }
+    }
+    for (uint32_t count : result.spikesPerNeuron) {
+        result.numberOfSpikes += count;
+    }
+    result.stepMs = elapsedMs / (brain.noise.size() - 1);
+
+    result.finalV.resize(n);
+    std::vector<double> finalU(n);
+    simulation.getState(result.finalV.data(), finalU.data());
+
+    return result;
+}
+
+/// Difference of population statistics of two runs, in % of spikes of `reference`.
+struct RateDifference {
+    /// Difference of total number of spikes
+    double population = 0;
+    /// Distance between distributions of spikes per neuron, sum of differences of sorted counts
+    double distribution = 0;
+};
+
+static RateDifference compareRates(const RunResult &reference, const RunResult &result)
+{
+    RateDifference difference;
+    if (reference.numberOfSpikes == 0) { return difference; }
+
+    std::vector<uint32_t> referenceCounts = reference.spikesPerNeuron;
+    std::vector<uint32_t> resultCounts = result.spikesPerNeuron;
+    std::sort(referenceCounts.begin(), referenceCounts.end());
+    std::sort(resultCounts.begin(), resultCounts.end());
+
+    double distance = 0;
+    for (size_t i = 0; i < referenceCounts.size(); i++) {
+        distance += std::fabs((double)resultCounts[i] - (double)referenceCounts[i]);
+    }
+    difference.population = std::fabs((double)result.numberOfSpikes - (double)reference.numberOfSpikes) / reference.numberOfSpikes * 100;
+    difference.distribution = distance / reference.numberOfSpikes * 100;
+    return difference;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t numberOfNeurons = argc > 1 ? (size_t)atol(argv[1]) : 10000;
+    size_t synapsesPerNeuron = argc > 2 ? (size_t)atol(argv[2]) : 100;
+    unsigned int maxThreads = argc > 3 ? (unsigned int)atoi(argv[3]) : 8;
+    unsigned int numberOfSteps = argc > 4 ? (unsigned int)atoi(argv[4]) : 20;
+    double tolerance = argc > 5 ? atof(argv[5]) : 1;
+    if (numberOfNeurons == 0 || numberOfSteps < 2) {
+        std::cout << "Usage: " << argv[0] << " [neurons = 10000] [synapses per neuron = 100] [max threads = 8] [steps = 20] [tolerance % = 1]" << std::endl;
+        return 1;
+    }
+
+    RandomBrain brain = makeBrain(numberOfNeurons, synapsesPerNeuron, numberOfSteps);
+    std::cout << "neurons: " << numberOfNeurons << ", synapses: " << brain.weights.size() << ", " << msPerStep << " ms per step, " << numberOfSteps << " steps, " << neuronKernelsInstructionSet() << " kernels" << std::endl;
+    std::cout << std::setw(10) << "precision"
+        << std::setw(8) << "threads"
+        << std::setw(12) << "ms/step"
+        << std::setw(10) << "speedup"
+        << std::setw(12) << "efficiency"
+        << std::setw(12) << "% of pulse"
+        << std::setw(12) << "spikes/s"
+        << std::setw(11) << "identical"
+        << std::endl;
+
+    double referenceMs = 0;
+    RunResult doubleReference;
+    RunResult singleReference;
+    for (int mode = 0; mode < 3; mode++) {
+        bool singlePrecision = mode == 1;
+        bool internalNoise = mode == 2;
+        std::vector<double> singleThreadV;
+
+        for (unsigned int numberOfThreads = 1; numberOfThreads <= maxThreads; numberOfThreads *= 2) {
+            RunResult result = runBrain(brain, numberOfThreads, singlePrecision, internalNoise);
+            if (numberOfThreads == 1) {
+                singleThreadV = result.finalV;
+                if (singlePrecision) {
+                    singleReference = result;
+                } else if (!internalNoise) {
+                    doubleReference = result;
+                    referenceMs = result.stepMs;
+                }
+            }
+
+            std::cout << std::fixed << std::setprecision(2)
+                << std::setw(10) << (internalNoise ? "philox" : singlePrecision ? "float32" : "float64")
+                << std::setw(8) << numberOfThreads
+                << std::setw(12) << result.stepMs
+                << std::setw(10) << referenceMs / result.stepMs
+                << std::setw(12) << referenceMs / result.stepMs / numberOfThreads * 100
+                << std::setw(12) << result.stepMs / msPerStep * 100
+                << std::setw(12) << (double)result.numberOfSpikes / ((numberOfSteps - 1) * msPerStep / 1000.0)
+                << std::setw(11) << (result.finalV == singleThreadV ? "yes" : "NO")
+                << std::endl;
+        }
+    }
+
+    /// Spikes of first step, matched one by one
+    size_t doubleSpikes = 0;
+    size_t singleSpikes = 0;
+    size_t matchedSpikes = 0;
+    for (size_t i = 0; i < doubleReference.firstRaster.size(); i++) {
+        doubleSpikes += doubleReference.firstRaster[i];
+        singleSpikes += singleReference.firstRaster[i];
+        matchedSpikes += doubleReference.firstRaster[i] & singleReference.firstRaster[i];
+    }
+    double rasterAgreement = doubleSpikes + singleSpikes ? 2.0 * matchedSpikes / (doubleSpikes + singleSpikes) : 1;
+
+    /// Firing rates over whole run, against spread of float64 between seeds of generated noise
+    RunResult otherSeed = runBrain(brain, 1, false, true, 2);
+    RunResult philoxReference = runBrain(brain, 1, false, true, 1);
+    RateDifference seedSpread = compareRates(philoxReference, otherSeed);
+    RateDifference precisionError = compareRates(doubleReference, singleReference);
+    bool passed = precisionError.population <= seedSpread.population + tolerance
+        && precisionError.distribution <= seedSpread.distribution + tolerance;
+
+    std::cout << "float32 vs float64: first step spike agreement " << rasterAgreement * 100 << " %" << std::endl;
+    std::cout << "float32 vs float64: population rate " << precisionError.population << " %, rate distribution " << precisionError.distribution << " %" << std::endl;
+    std::cout << "float64 seed 1 vs 2: population rate " << seedSpread.population << " %, rate distribution " << seedSpread.distribution << " %" << std::endl;
+    std::cout << "float32 " << (passed ? "PASS" : "FAIL") << " (tolerance " << tolerance << " % above seed spread)" << std::endl;
+
+    return passed ? 0 : 1;
+}
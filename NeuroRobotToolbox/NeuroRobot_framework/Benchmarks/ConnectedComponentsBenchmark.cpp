@@ -0,0 +1,250 @@
+//
+//  ConnectedComponentsBenchmark.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Labels random masks of network input size (227 x 227) and of full eye (720 x 720) with `ConnectedComponents`
+//  and with pixel by pixel flood fill, which is how `bwconncomp` walks the mask.
+//  Masks are smoothed noise thresholded at different levels, from few colour blobs to half of the image set,
+//  and plain noise, which is the worst case for runs.
+//
+//  Reported per mask: runs, components, time of `label()` for all components and for the largest one,
+//  time of flood fill, and whether areas, bounding boxes and centroids of all components match flood fill.
+//  Memory allocations are counted after the first call, `label()` must not allocate for masks of the same size.
+//  Exit code is 1 if results differ or memory is allocated.
+//
+//  Usage:
+//      ConnectedComponentsBenchmark [repetitions = 200]
+//
+//  Build (macOS, from NeuroRobotToolbox folder):
+//      clang++ -std=c++14 -O2 NeuroRobot_framework/Benchmarks/ConnectedComponentsBenchmark.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp -INeuroRobot_framework -o ConnectedComponentsBenchmark
+//
+
+#include "Vision/ConnectedComponents.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+
+/// Number of memory allocations since start.
+static size_t numberOfAllocations = 0;
+
+void *operator new(size_t size)
+{
+    numberOfAllocations++;
+    void *memory = malloc(size ? size : 1);
+    if (!memory) { throw std::bad_alloc(); }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+/// Mask of smoothed noise, set where noise is above `level`, or plain noise with `level` share of set pixels if `smooth` is 0.
+static std::vector<uint8_t> makeMask(unsigned int size, double level, unsigned int smooth, std::mt19937 &generator)
+{
+    std::uniform_real_distribution<double> distribution(0, 1);
+    std::vector<double> noise((size_t)size * size);
+    for (double &value : noise) {
+        value = distribution(generator);
+    }
+
+    /// Box blur along rows and columns makes blobs of about `smooth` px
+    for (unsigned int pass = 0; smooth && pass < 2; pass++) {
+        std::vector<double> blurred(noise.size());
+        for (unsigned int y = 0; y < size; y++) {
+            for (unsigned int x = 0; x < size; x++) {
+                double sum = 0;
+                unsigned int count = 0;
+                for (int offset = -(int)smooth; offset <= (int)smooth; offset++) {
+                    int position = (int)(pass ? y : x) + offset;
+                    if (position < 0 || position >= (int)size) { continue; }
+                    sum += pass ? noise[(size_t)position * size + x] : noise[(size_t)y * size + position];
+                    count++;
+                }
+                blurred[(size_t)y * size + x] = sum / count;
+            }
+        }
+        noise.swap(blurred);
+    }
+
+    std::vector<uint8_t> mask(noise.size());
+    for (size_t i = 0; i < noise.size(); i++) {
+        mask[i] = smooth ? noise[i] > level : noise[i] < level;
+    }
+    return mask;
+}
+
+/// Components found by 8-connected flood fill in column-major order, like `bwconncomp`.
+static std::vector<ConnectedComponents::Component> floodFill(const std::vector<uint8_t> &mask, unsigned int size)
+{
+    std::vector<ConnectedComponents::Component> components;
+    std::vector<uint8_t> visited(mask.size(), 0);
+    std::vector<uint32_t> stack;
+    for (unsigned int x = 0; x < size; x++) {
+        for (unsigned int y = 0; y < size; y++) {
+            size_t index = (size_t)y * size + x;
+            if (!mask[index] || visited[index]) { continue; }
+
+            ConnectedComponents::Component component = ConnectedComponents::Component();
+            component.firstRow = component.firstColumn = UINT32_MAX;
+            component.firstIndex = (uint64_t)x * size + y;
+            double sumOfRows = 0;
+            double sumOfColumns = 0;
+            visited[index] = 1;
+            stack.assign(1, (uint32_t)index);
+            while (!stack.empty()) {
+                uint32_t pixel = stack.back();
+                stack.pop_back();
+                unsigned int row = pixel / size;
+                unsigned int column = pixel % size;
+                component.area++;
+                component.firstRow = std::min(component.firstRow, row);
+                component.lastRow = std::max(component.lastRow, row);
+                component.firstColumn = std::min(component.firstColumn, column);
+                component.lastColumn = std::max(component.lastColumn, column);
+                sumOfRows += row;
+                sumOfColumns += column;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        int neighbourRow = (int)row + dy;
+                        int neighbourColumn = (int)column + dx;
+                        if (neighbourRow < 0 || neighbourColumn < 0 || neighbourRow >= (int)size || neighbourColumn >= (int)size) { continue; }
+                        size_t neighbour = (size_t)neighbourRow * size + neighbourColumn;
+                        if (mask[neighbour] && !visited[neighbour]) {
+                            visited[neighbour] = 1;
+                            stack.push_back((uint32_t)neighbour);
+                        }
+                    }
+                }
+            }
+            component.centroidRow = sumOfRows / component.area;
+            component.centroidColumn = sumOfColumns / component.area;
+            components.push_back(component);
+        }
+    }
+    return components;
+}
+
+static bool isSame(const std::vector<ConnectedComponents::Component> &components, const std::vector<ConnectedComponents::Component> &reference)
+{
+    if (components.size() != reference.size()) { return false; }
+    for (size_t i = 0; i < components.size(); i++) {
+        const ConnectedComponents::Component &component = components[i];
+        const ConnectedComponents::Component &other = reference[i];
+        if (component.area != other.area || component.firstIndex != other.firstIndex
+            || component.firstRow != other.firstRow || component.lastRow != other.lastRow
+            || component.firstColumn != other.firstColumn || component.lastColumn != other.lastColumn
+            || std::fabs(component.centroidRow - other.centroidRow) > 1e-9 || std::fabs(component.centroidColumn - other.centroidColumn) > 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Function>
+static double measureMs(unsigned int repetitions, Function function)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < repetitions; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / repetitions;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int repetitions = argc > 1 ? (unsigned int)atoi(argv[1]) : 200;
+    if (repetitions == 0) {
+        std::cout << "Usage: " << argv[0] << " [repetitions = 200]" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::setw(6) << "size"
+        << std::setw(14) << "mask"
+        << std::setw(9) << "set %"
+        << std::setw(9) << "runs"
+        << std::setw(8) << "blobs"
+        << std::setw(10) << "all ms"
+        << std::setw(10) << "top1 ms"
+        << std::setw(10) << "fill ms"
+        << std::setw(10) << "speedup"
+        << std::setw(8) << "allocs"
+        << std::setw(7) << "same"
+        << std::endl;
+
+    struct MaskType {
+        const char *name;
+        double level;
+        unsigned int smooth;
+    };
+    const MaskType maskTypes[] = {
+        { "few blobs", 0.54, 6 },
+        { "many blobs", 0.52, 3 },
+        { "half set", 0.5, 2 },
+        { "noise 30 %", 0.3, 0 },
+    };
+    const unsigned int sizes[] = { 227, 720 };
+
+    std::mt19937 generator(1);
+    bool passed = true;
+    for (unsigned int size : sizes) {
+        for (const MaskType &maskType : maskTypes) {
+            std::vector<uint8_t> mask = makeMask(size, maskType.level, maskType.smooth, generator);
+            size_t setPixels = 0;
+            for (uint8_t pixel : mask) {
+                setPixels += pixel;
+            }
+
+            ConnectedComponents components;
+            std::vector<ConnectedComponents::Component> reference = floodFill(mask, size);
+            bool same = isSame(components.label(mask.data(), size, size), reference);
+
+            /// First call above allocated buffers, following calls must not allocate
+            size_t allocationsBefore = numberOfAllocations;
+            double allMs = measureMs(repetitions, [&] { components.label(mask.data(), size, size); });
+            double topMs = measureMs(repetitions, [&] { components.label(mask.data(), size, size, 1); });
+            size_t allocations = numberOfAllocations - allocationsBefore;
+            double fillMs = measureMs(std::max(1u, repetitions / 10), [&] { floodFill(mask, size); });
+
+            /// Largest component is the first of equal largest ones in `bwconncomp` order
+            const std::vector<ConnectedComponents::Component> &largest = components.label(mask.data(), size, size, 1);
+            size_t expected = 0;
+            for (size_t i = 1; i < reference.size(); i++) {
+                if (reference[i].area > reference[expected].area) { expected = i; }
+            }
+            same = same && (reference.empty() ? largest.empty() : largest.size() == 1 && isSame(largest, std::vector<ConnectedComponents::Component>(1, reference[expected])));
+            passed = passed && same && allocations == 0;
+
+            std::cout << std::fixed << std::setprecision(3)
+                << std::setw(6) << size
+                << std::setw(14) << maskType.name
+                << std::setw(9) << std::setprecision(1) << 100.0 * setPixels / mask.size()
+                << std::setw(9) << components.numberOfRuns()
+                << std::setw(8) << reference.size()
+                << std::setw(10) << std::setprecision(3) << allMs
+                << std::setw(10) << topMs
+                << std::setw(10) << fillMs
+                << std::setw(10) << std::setprecision(1) << fillMs / allMs
+                << std::setw(8) << allocations
+                << std::setw(7) << (same ? "yes" : "NO")
+                << std::endl;
+        }
+    }
+
+    std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+//
+//  FleetBenchmark.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Starts N `NeuroRobotManager` objects in one process against local sources and reports how the fleet scales.
+//  Video comes from a replayed recording (paced to its timestamps) or from a local RTSP emulator,
+//  serial telemetry comes from an in-process TCP emulator per robot.
+//
+//  Reported per level: average and minimum frame rate per robot, CPU time per robot (dominated by decoding),
+//  CPU time of the consumer thread which polls all robots, p50/p99 latency from packet arrival to the moment the consumer
+//  sees the frame, share of telemetry lines never seen by the consumer and resident memory growth per robot.
+//  CPU time per robot is process CPU time (user + system of all threads) without the consumer thread, divided by wall time.
+//  Threads of telemetry emulators are included, they sleep between lines.
+//
+//  Usage:
+//      FleetBenchmark <video file or url> [seconds per level = 10] [max robots = 32]
+//
+//  Build (macOS, from NeuroRobotToolbox folder, add -pthread on Linux):
+//      clang++ -std=c++14 -O2 NeuroRobot_framework/Benchmarks/FleetBenchmark.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp -INeuroRobot_framework -Ilibraries/mac/boost/1.70.0/include -Llibraries/mac/boost/1.70.0/lib -Ilibraries/mac/ffmpeg/include -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale -o FleetBenchmark
+//
+
+#include "NeuroRobotManager.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+#include <boost/asio.hpp>
+
+#ifdef __APPLE__
+    #include <mach/mach.h>
+#elif defined(_WIN32)
+    #include <Windows.h>
+    #include <Psapi.h>
+#endif
+
+#ifndef _WIN32
+    #include <sys/resource.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+using boost::asio::ip::tcp;
+
+/// Telemetry rate of emulated robot in Hz.
+const static int telemetryRate = 50;
+
+/// Consumer polling period in us, stands in for MATLAB reading shared memory.
+const static int pollingPeriodUs = 1000;
+
+/// Resident memory of the process in bytes.
+static size_t residentMemory()
+{
+#ifdef __APPLE__
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) { return 0; }
+    return info.resident_size;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+    return counters.WorkingSetSize;
+#else
+    long pages = 0;
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) { return 0; }
+    if (fscanf(file, "%*s %ld", &pages) != 1) { pages = 0; }
+    fclose(file);
+    return (size_t)pages * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+#ifdef _WIN32
+static double fileTimeSeconds(const FILETIME &time)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return value.QuadPart * 1e-7;
+}
+#endif
+
+/// CPU time (user + system) of all threads of the process in seconds.
+static double processCpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) { return 0; }
+    return fileTimeSeconds(kernel) + fileTimeSeconds(user);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+/// CPU time (user + system) of the calling thread in seconds.
+static double threadCpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) { return 0; }
+    return fileTimeSeconds(kernel) + fileTimeSeconds(user);
+#else
+    struct timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) { return 0; }
+    return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+}
+
+/// Emulates serial socket of one robot.
+/// Sends increasing sequence numbers with `telemetryRate`, so the receiver can count what it missed.
+class TelemetryEmulator {
+
+private:
+
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    void run()
+    {
+        boost::system::error_code ec;
+        tcp::socket socket(io_context);
+        acceptor.accept(socket, ec);
+        if (ec) { return; }
+
+        /// Robot starts sending after it receives header
+        uint8_t header[2];
+        boost::asio::read(socket, boost::asio::buffer(header, 2), ec);
+
+        auto nextTime = std::chrono::steady_clock::now();
+        while (running && !ec) {
+            std::string line = std::to_string(sent.load() + 1) + "\r\n";
+            boost::asio::write(socket, boost::asio::buffer(line), ec);
+            if (!ec) { sent++; }
+
+            nextTime += std::chrono::microseconds(1000000 / telemetryRate);
+            std::this_thread::sleep_until(nextTime);
+        }
+        socket.close(ec);
+    }
+
+public:
+
+    /// Number of sent telemetry lines.
+    std::atomic<uint64_t> sent;
+
+    TelemetryEmulator()
+    : acceptor(io_context, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0))
+    , running(true)
+    , sent(0)
+    {
+        thread = std::thread(&TelemetryEmulator::run, this);
+    }
+
+    ~TelemetryEmulator()
+    {
+        running = false;
+        boost::system::error_code ec;
+        acceptor.close(ec);
+        thread.join();
+    }
+
+    /// Port on which emulator listens.
+    std::string port()
+    {
+        return std::to_string(acceptor.local_endpoint().port());
+    }
+};
+
+/// Measurements of one robot during one level.
+struct RobotStats {
+    uint64_t firstFrame = 0;
+    uint64_t lastFrame = 0;
+    uint64_t firstTelemetry = 0;
+    uint64_t lastTelemetry = 0;
+    uint64_t receivedTelemetry = 0;
+    std::vector<double> latenciesMs;
+};
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) { return 0; }
+    std::sort(values.begin(), values.end());
+    size_t index = (size_t)(p / 100.0 * (values.size() - 1));
+    return values[index];
+}
+
+/// Runs one level of benchmark with `numberOfRobots` robots and prints one row of results.
+static void runLevel(const std::string& videoSource, int numberOfRobots, int seconds)
+{
+    size_t memoryBefore = residentMemory();
+
+    std::vector<TelemetryEmulator*> emulators;
+    std::vector<NeuroRobotManager*> robots;
+    for (int i = 0; i < numberOfRobots; i++) {
+        TelemetryEmulator* emulator = new TelemetryEmulator();
+        emulators.push_back(emulator);
+        robots.push_back(new NeuroRobotManager("127.0.0.1", emulator->port(), nullptr, nullptr, videoSource));
+    }
+    for (NeuroRobotManager* robot : robots) {
+        robot->start();
+    }
+
+    /// Let streams settle before measuring
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    std::vector<RobotStats> stats(numberOfRobots);
+    std::vector<uint8_t> frameCopy;
+    for (int i = 0; i < numberOfRobots; i++) {
+        stats[i].firstFrame = stats[i].lastFrame = robots[i]->videoFrameCounter();
+    }
+
+    double cpuBegin = processCpuSeconds();
+    double consumerCpuBegin = threadCpuSeconds();
+    auto wallBegin = std::chrono::steady_clock::now();
+    auto wallEnd = wallBegin + std::chrono::seconds(seconds);
+
+    while (std::chrono::steady_clock::now() < wallEnd) {
+        for (int i = 0; i < numberOfRobots; i++) {
+            RobotStats& robotStats = stats[i];
+
+            std::chrono::steady_clock::time_point packetTime;
+            uint64_t frameCounter = robots[i]->videoFrameCounter(&packetTime);
+            if (frameCounter != robotStats.lastFrame) {
+                /// Copy the frame under its lock like MATLAB does, it is a part of the cost per robot
+                frameCopy.resize(robots[i]->videoFrameBytes());
+                robots[i]->readVideoFrame(frameCopy.data(), frameCopy.size());
+
+                double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packetTime).count();
+                robotStats.latenciesMs.push_back(latencyMs);
+                robotStats.lastFrame = frameCounter;
+            }
+
+            size_t totalBytes = 0;
+            char* serialData = robots[i]->readSerial(&totalBytes);
+            uint64_t telemetry = totalBytes ? strtoull(serialData, NULL, 10) : 0;
+            if (telemetry > robotStats.lastTelemetry) {
+                if (!robotStats.firstTelemetry) { robotStats.firstTelemetry = telemetry; }
+                robotStats.lastTelemetry = telemetry;
+                robotStats.receivedTelemetry++;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(pollingPeriodUs));
+    }
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallBegin).count();
+    double consumerCpuSeconds = threadCpuSeconds() - consumerCpuBegin;
+    double cpuSeconds = processCpuSeconds() - cpuBegin - consumerCpuSeconds;
+    size_t memoryAfter = residentMemory();
+
+    /// Aggregate
+    double sumFps = 0;
+    double minFps = 1e9;
+    double telemetryExpected = 0;
+    double telemetryReceived = 0;
+    std::vector<double> latencies;
+    for (int i = 0; i < numberOfRobots; i++) {
+        double fps = (stats[i].lastFrame - stats[i].firstFrame) / wallSeconds;
+        sumFps += fps;
+        minFps = std::min(minFps, fps);
+        if (stats[i].firstTelemetry) {
+            telemetryExpected += stats[i].lastTelemetry - stats[i].firstTelemetry + 1;
+            telemetryReceived += stats[i].receivedTelemetry;
+        }
+        latencies.insert(latencies.end(), stats[i].latenciesMs.begin(), stats[i].latenciesMs.end());
+    }
+    double telemetryDropRate = telemetryExpected > 0 ? 1 - telemetryReceived / telemetryExpected : 1;
+
+    std::cout << std::fixed << std::setprecision(2)
+        << std::setw(6) << numberOfRobots
+        << std::setw(10) << sumFps / numberOfRobots
+        << std::setw(10) << minFps
+        << std::setw(12) << cpuSeconds / wallSeconds / numberOfRobots * 100
+        << std::setw(12) << consumerCpuSeconds / wallSeconds * 100
+        << std::setw(10) << percentile(latencies, 50)
+        << std::setw(10) << percentile(latencies, 99)
+        << std::setw(10) << telemetryDropRate * 100
+        << std::setw(12) << (double)(memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0) / numberOfRobots / (1024 * 1024)
+        << std::endl;
+
+    for (NeuroRobotManager* robot : robots) {
+        robot->stop();
+        delete robot;
+    }
+    for (TelemetryEmulator* emulator : emulators) {
+        delete emulator;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <video file or url> [seconds per level = 10] [max robots = 32]" << std::endl;
+        return 1;
+    }
+    std::string videoSource = argv[1];
+    int seconds = argc > 2 ? atoi(argv[2]) : 10;
+    int maxRobots = argc > 3 ? atoi(argv[3]) : 32;
+
+    std::cout << "source: " << videoSource << ", " << seconds << " s per level, telemetry " << telemetryRate << " Hz" << std::endl;
+    std::cout << std::setw(6) << "robots"
+        << std::setw(10) << "fps avg"
+        << std::setw(10) << "fps min"
+        << std::setw(12) << "cpu %/robot"
+        << std::setw(12) << "consumer %"
+        << std::setw(10) << "lat p50"
+        << std::setw(10) << "lat p99"
+        << std::setw(10) << "tlm drop%"
+        << std::setw(12) << "MB/robot"
+        << std::endl;
+
+    for (int numberOfRobots = 1; numberOfRobots <= maxRobots; numberOfRobots *= 2) {
+        runLevel(videoSource, numberOfRobots, seconds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+//  WakeUpBenchmark.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Measures wake-up latency of a worker thread, like cyclictest: the worker sleeps until the next due time of a fixed
+//  period and records how late it wakes up. Busy threads on every CPU stand in for MATLAB and other load of lab PCs.
+//  The worker runs once with default scheduling and once with the given `ThreadSettings`, so the effect of pinning and
+//  real-time priority on the machine is visible before they are used for decode and socket workers.
+//
+//  Reported per run: wake-ups, p50/p99/p99.9 and max latency in us, and wake-ups later than one period.
+//
+//  Usage:
+//      WakeUpBenchmark [seconds = 10] [period us = 1000] [busy threads = CPUs] [cpu = -1] [priority = 0] [nice = 0]
+//
+//  Build (macOS, from NeuroRobotToolbox folder, add -pthread on Linux):
+//      clang++ -std=c++14 -O2 NeuroRobot_framework/Benchmarks/WakeUpBenchmark.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp -INeuroRobot_framework -o WakeUpBenchmark
+//
+
+#include "Core/ThreadSettings.h"
+#include "Core/LatencyHistogram.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock Clock;
+
+struct RunResult {
+    LatencyHistogram::Summary summary;
+    uint64_t latePeriods = 0;
+    std::string error;
+};
+
+/// Worker which wakes up every `period` for `duration` with `settings` and records its lateness.
+static void runWorker(const ThreadSettings &settings, Clock::duration period, Clock::duration duration, LatencyHistogram &latency, RunResult &result)
+{
+    if (!settings.isDefault()) {
+        applyThreadSettings(settings, result.error);
+    }
+
+    const uint64_t periodUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(period).count();
+    const Clock::time_point end = Clock::now() + duration;
+    Clock::time_point due = Clock::now() + period;
+    while (due < end) {
+        std::this_thread::sleep_until(due);
+        const int64_t lateUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due).count();
+        latency.record(lateUs > 0 ? (uint64_t)lateUs : 0);
+        result.latePeriods += (uint64_t)lateUs > periodUs;
+        due += period;
+    }
+}
+
+/// One run of worker next to `busyThreads` spinning threads.
+static RunResult measure(const ThreadSettings &settings, Clock::duration period, Clock::duration duration, unsigned int busyThreads)
+{
+    std::atomic<bool> busy(true);
+    std::vector<std::thread> load;
+    for (unsigned int i = 0; i < busyThreads; i++) {
+        load.emplace_back([&busy] {
+            volatile uint64_t counter = 0;
+            while (busy.load(std::memory_order_relaxed)) {
+                counter = counter + 1;
+            }
+        });
+    }
+
+    LatencyHistogram latency;
+    RunResult result;
+    std::thread worker(runWorker, std::cref(settings), period, duration, std::ref(latency), std::ref(result));
+    worker.join();
+
+    busy = false;
+    for (std::thread &thread : load) {
+        thread.join();
+    }
+    result.summary = latency.summary();
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 10;
+    int periodUs = argc > 2 ? atoi(argv[2]) : 1000;
+    unsigned int busyThreads = argc > 3 ? (unsigned int)atoi(argv[3]) : std::thread::hardware_concurrency();
+    ThreadSettings settings;
+    settings.cpu = argc > 4 ? atoi(argv[4]) : -1;
+    settings.priority = argc > 5 ? atoi(argv[5]) : 0;
+    settings.nice = argc > 6 ? atoi(argv[6]) : 0;
+
+    if (seconds <= 0 || periodUs <= 0) {
+        std::cout << "Usage: " << argv[0] << " [seconds = 10] [period us = 1000] [busy threads = CPUs] [cpu = -1] [priority = 0] [nice = 0]" << std::endl;
+        return 1;
+    }
+
+    const Clock::duration period = std::chrono::microseconds(periodUs);
+    const Clock::duration duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+    std::cout << "period " << periodUs << " us, " << busyThreads << " busy threads, " << seconds << " s per run" << std::endl;
+    std::cout << std::setw(12) << "scheduling"
+        << std::setw(10) << "wake-ups"
+        << std::setw(10) << "p50 us"
+        << std::setw(10) << "p99 us"
+        << std::setw(10) << "p99.9 us"
+        << std::setw(10) << "max us"
+        << std::setw(8) << "late"
+        << std::endl;
+
+    const char *names[] = { "default", "settings" };
+    const ThreadSettings runs[] = { ThreadSettings(), settings };
+    for (unsigned int run = 0; run < 2; run++) {
+        if (run == 1 && settings.isDefault()) { break; }
+
+        RunResult result = measure(runs[run], period, duration, busyThreads);
+        std::cout << std::setw(12) << names[run]
+            << std::setw(10) << result.summary.count
+            << std::setw(10) << result.summary.p50Us
+            << std::setw(10) << result.summary.p99Us
+            << std::setw(10) << result.summary.p999Us
+            << std::setw(10) << result.summary.maxUs
+            << std::setw(8) << result.latePeriods
+            << std::endl;
+        if (!result.error.empty()) {
+            std::cout << "    not applied: " << result.error << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+//
+//  BasalGanglia.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BasalGanglia.h"
+
+#include <algorithm>
+
+/// Drive of a network is kept in 0 ... `maxDrive`.
+const static double maxDrive = 250;
+
+void BasalGanglia::set(size_t numberOfNeurons_, const double *networkIds, const double *basalGangliaNeurons_, size_t numberOfNetworks_, const double *drive_, bool enabled_)
+{
+    numberOfNeurons = numberOfNeurons_;
+    numberOfNetworks = numberOfNetworks_;
+    enabled = enabled_;
+
+    /// Lists are built once, so gating does not scan all neurons every step
+    size_t numberOfLists = numberOfNetworks;
+    neuronNetworks.resize(numberOfNeurons);
+    for (size_t i = 0; i < numberOfNeurons; i++) {
+        neuronNetworks[i] = (uint32_t)networkIds[i];
+        numberOfLists = std::max(numberOfLists, (size_t)neuronNetworks[i]);
+    }
+    networkNeurons.assign(numberOfLists, std::vector<uint32_t>());
+    basalGangliaNeurons.assign(numberOfLists, std::vector<uint32_t>());
+    for (size_t i = 0; i < numberOfNeurons; i++) {
+        if (neuronNetworks[i] == 0) { continue; }
+
+        networkNeurons[neuronNetworks[i] - 1].push_back((uint32_t)i);
+        if (basalGangliaNeurons_[i]) {
+            basalGangliaNeurons[neuronNetworks[i] - 1].push_back((uint32_t)i);
+        }
+    }
+
+    drive.assign(drive_, drive_ + numberOfNetworks * 3);
+    activityChanges.assign(numberOfNetworks, ActivityChangeNone);
+    selectedNetwork = 0;
+}
+
+void BasalGanglia::clear()
+{
+    numberOfNeurons = 0;
+    numberOfNetworks = 0;
+    neuronNetworks.clear();
+    networkNeurons.clear();
+    basalGangliaNeurons.clear();
+    drive.clear();
+    activityChanges.clear();
+    selectedNetwork = 0;
+}
+
+bool BasalGanglia::isSet()
+{
+    return numberOfNeurons > 0;
+}
+
+void BasalGanglia::setSeed(uint64_t seed)
+{
+    generator.seed(seed);
+}
+
+double BasalGanglia::uniform()
+{
+    return std::uniform_real_distribution<double>(0, 1)(generator);
+}
+
+double BasalGanglia::normal()
+{
+    return std::normal_distribution<double>()(generator);
+}
+
+void BasalGanglia::select(const double *currents, unsigned int msPerStep, double reward)
+{
+    const size_t networks = numberOfNetworks;
+    double *networkDrive = drive.data();
+    double *active = drive.data() + networks;
+    double *accumulatedReward = drive.data() + 2 * networks;
+
+    std::fill(activityChanges.begin(), activityChanges.end(), ActivityChangeNone);
+
+    double threshold = 50 + normal() * 15;
+
+    /// Network 1 does not compete
+    for (size_t network = 1; network < networks; network++) {
+
+        /// Sensory boost, half of summed mean current of basal ganglia neurons
+        if (network < basalGangliaNeurons.size() && !basalGangliaNeurons[network].empty()) {
+            double boost = 0;
+            for (uint32_t neuron : basalGangliaNeurons[network]) {
+                double current = 0;
+                for (unsigned int t = 0; t < msPerStep; t++) {
+                    current += currents[t * numberOfNeurons + neuron];
+                }
+                boost += current / msPerStep;
+            }
+            networkDrive[network] = networkDrive[network] + boost * 0.5;
+        }
+
+        if (active[network] == 0) {
+            networkDrive[network] = networkDrive[network] + uniform() * 2;
+            bool anyActive = std::any_of(active, active + networks, [](double value) { return value != 0; });
+            if (networkDrive[network] > threshold && !anyActive) {
+                networkDrive[network] = networkDrive[network] + 150;
+                active[network] = 1;
+                activityChanges[network] = ActivityChangeActivated;
+            }
+        } else if (active[network] == 1) {
+            /// Inhibit other networks and withdraw some own drive, reward keeps network active
+            double inhibition = uniform() * 2.5;
+            for (size_t other = 0; other < networks; other++) {
+                if (other != network) {
+                    networkDrive[other] = networkDrive[other] - inhibition;
+                }
+            }
+            networkDrive[network] = networkDrive[network] - uniform() * 3.5;
+            networkDrive[network] = networkDrive[network] + reward * 2.5;
+            if (networkDrive[network] < threshold) {
+                networkDrive[network] = 0;
+                active[network] = 0;
+                activityChanges[network] = ActivityChangeDeactivated;
+            }
+            accumulatedReward[network] = accumulatedReward[network] + reward;
+        }
+    }
+
+    for (size_t network = 0; network < networks; network++) {
+        networkDrive[network] = std::min(std::max(networkDrive[network], 0.0), maxDrive);
+    }
+
+    /// Active network loses drive if another network has more
+    double *firstActive = std::find_if(active, active + networks, [](double value) { return value != 0; });
+    size_t strongest = std::max_element(networkDrive, networkDrive + networks) - networkDrive;
+    if (firstActive != active + networks) {
+        selectedNetwork = (int)(firstActive - active) + 1;
+        if ((size_t)(selectedNetwork - 1) != strongest) {
+            double reduction = 30 * uniform();
+            for (size_t network = 0; network < networks; network++) {
+                networkDrive[network] = networkDrive[network] - reduction;
+            }
+        }
+    } else {
+        selectedNetwork = -1;
+    }
+}
+
+void BasalGanglia::setSpikes(uint8_t *spikes, unsigned int msPerStep, const std::vector<uint32_t> &neurons, uint8_t value)
+{
+    for (unsigned int t = 0; t < msPerStep; t++) {
+        uint8_t *spikesNow = spikes + t * numberOfNeurons;
+        for (uint32_t neuron : neurons) {
+            spikesNow[neuron] = value;
+        }
+    }
+}
+
+void BasalGanglia::gate(unsigned int msPerStep, const double *currents, double reward, uint8_t *spikes)
+{
+    selectedNetwork = 0;
+    if (enabled) {
+        select(currents, msPerStep, reward);
+
+        /// Down neurons still spiked to synapses during the step, only output is silenced
+        for (size_t network = 1; network < networkNeurons.size(); network++) {
+            if ((int)network + 1 != selectedNetwork) {
+                setSpikes(spikes, msPerStep, networkNeurons[network], 0);
+            }
+        }
+    }
+
+    /// Basal ganglia neurons show which network is selected
+    for (size_t network = 0; network < basalGangliaNeurons.size(); network++) {
+        setSpikes(spikes, msPerStep, basalGangliaNeurons[network], (int)network + 1 == selectedNetwork ? 1 : 0);
+    }
+}
+
+int BasalGanglia::getSelectedNetwork()
+{
+    return selectedNetwork;
+}
+
+const std::vector<double> &BasalGanglia::getDrive()
+{
+    return drive;
+}
+
+const std::vector<int8_t> &BasalGanglia::getActivityChanges()
+{
+    return activityChanges;
+}
+
+size_t BasalGanglia::size()
+{
+    return numberOfNetworks;
+}
+
+bool BasalGanglia::isDown(uint32_t neuron)
+{
+    int network = (int)neuronNetworks[neuron];
+    return enabled && network != selectedNetwork && network != 1;
+}
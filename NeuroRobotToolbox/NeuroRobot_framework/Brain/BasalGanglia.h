@@ -0,0 +1,108 @@
+//
+//  BasalGanglia.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BasalGanglia_h
+#define BasalGanglia_h
+
+#include <vector>
+#include <random>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Native port of basal ganglia network selection (`bg_brain`) of `update_brain.m`.
+/// Networks compete with drive built from input current of their basal ganglia neurons, one network at a time is active.
+/// Spikes of neurons in other networks, except network 1, are removed from the step output.
+/// Networks are numbered from 1 like `network_ids`.
+class BasalGanglia {
+
+public:
+
+    /// Activity change of network in the last step.
+    typedef enum {
+        ActivityChangeNone = 0,
+        ActivityChangeActivated = 1,
+        ActivityChangeDeactivated = -1
+    } ActivityChange;
+
+private:
+
+    size_t numberOfNeurons = 0;
+    size_t numberOfNetworks = 0;
+
+    /// Competition runs only for `bg_brain`, otherwise only basal ganglia neurons are silenced
+    bool enabled = false;
+
+    /// Network of every neuron from 1
+    std::vector<uint32_t> neuronNetworks;
+
+    /// Neurons and basal ganglia neurons of every network, index 0 is network 1
+    std::vector<std::vector<uint32_t>> networkNeurons;
+    std::vector<std::vector<uint32_t>> basalGangliaNeurons;
+
+    /// `network_drive`, column-major `numberOfNetworks` x 3: drive, active, accumulated reward
+    std::vector<double> drive;
+
+    /// `this_network`, 0 when disabled and -1 when no network is active
+    int selectedNetwork = 0;
+
+    std::vector<int8_t> activityChanges;
+
+    std::mt19937_64 generator;
+
+    double uniform();
+    double normal();
+
+    /// Updates drives and selects network, `update_brain.m` BG select.
+    void select(const double *currents, unsigned int msPerStep, double reward);
+
+    /// Sets spikes of all `neurons` in every ms of the step to `value`.
+    void setSpikes(uint8_t *spikes, unsigned int msPerStep, const std::vector<uint32_t> &neurons, uint8_t value);
+
+public:
+
+    /// Set networks.
+    /// @param numberOfNeurons Number of neurons
+    /// @param networkIds `network_ids`, network of every neuron from 1
+    /// @param basalGangliaNeurons `bg_neurons`, nonzero for basal ganglia neurons
+    /// @param numberOfNetworks `nnetworks`
+    /// @param drive `network_drive`, column-major `numberOfNetworks` x 3
+    /// @param enabled `bg_brain`
+    void set(size_t numberOfNeurons, const double *networkIds, const double *basalGangliaNeurons, size_t numberOfNetworks, const double *drive, bool enabled);
+
+    /// Remove networks, step output is no longer gated.
+    void clear();
+
+    /// True if networks were set.
+    bool isSet();
+
+    /// Seed of random drive changes and threshold.
+    void setSeed(uint64_t seed);
+
+    /// Runs selection on step output and removes spikes of deselected networks.
+    /// @param msPerStep Number of simulated ms
+    /// @param currents Column-major `numberOfNeurons` x `msPerStep` matrix of total input current
+    /// @param reward Reward of this step
+    /// @param spikes Column-major `numberOfNeurons` x `msPerStep` spikes, gated in place
+    void gate(unsigned int msPerStep, const double *currents, double reward, uint8_t *spikes);
+
+    /// `this_network` after last step.
+    int getSelectedNetwork();
+
+    /// `network_drive`, column-major `numberOfNetworks` x 3.
+    const std::vector<double> &getDrive();
+
+    /// Activity change of every network in last step.
+    const std::vector<int8_t> &getActivityChanges();
+
+    /// Number of networks.
+    size_t size();
+
+    /// True if spikes of neuron are removed by selection, `down_neurons` of `update_brain.m`.
+    bool isDown(uint32_t neuron);
+};
+
+#endif /* BasalGanglia_h */
@@ -0,0 +1,423 @@
+//
+//  BrainImage.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BrainImage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static_assert(sizeof(size_t) == sizeof(uint64_t), "Sparse sections are used in place as size_t arrays.");
+
+const static char magic[8] = { 'N', 'R', 'B', 'R', 'A', 'I', 'N', 0 };
+const static uint32_t byteOrderMark = 0x01020304;
+const static size_t alignment = 64;
+const static size_t maxNameLength = 32;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t numberOfSections;
+    uint32_t reserved;
+    uint64_t fileSize;
+    uint8_t padding[32];
+};
+
+struct SectionHeader {
+    char name[maxNameLength];
+    uint32_t type;
+    uint32_t sparse;
+    uint64_t dimensions[3];
+    uint64_t offset;
+    uint64_t numberOfNonzeros;
+};
+
+static_assert(sizeof(FileHeader) == 64, "File header must keep its size.");
+static_assert(sizeof(SectionHeader) == 80, "Section header must keep its size.");
+
+static size_t aligned(size_t offset)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static size_t elementSize(uint32_t type)
+{
+    return type == BrainImage::SectionTypeLogical ? 1 : sizeof(double);
+}
+
+//MARK:- BrainImage
+
+BrainImage::~BrainImage()
+{
+    close();
+}
+
+bool BrainImage::open(const std::string &path, std::string &error)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE fileMapping = size.QuadPart ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    const void *view = fileMapping ? MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view) {
+        if (fileMapping) { CloseHandle(fileMapping); }
+        CloseHandle(file);
+        error = "Cannot map " + path;
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = fileMapping;
+    mapping = (const uint8_t *)view;
+    mappingSize = (size_t)size.QuadPart;
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    struct stat status;
+    void *view = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        view = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    /// Mapping stays valid after file is closed
+    ::close(file);
+    if (view == MAP_FAILED) {
+        error = "Cannot map " + path;
+        return false;
+    }
+    mapping = (const uint8_t *)view;
+    mappingSize = (size_t)status.st_size;
+#endif
+
+    if (!readSections(error)) {
+        error = path + ": " + error;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BrainImage::close()
+{
+    sections.clear();
+    if (!mapping) { return; }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    mappingHandle = NULL;
+    fileHandle = NULL;
+#else
+    munmap((void *)mapping, mappingSize);
+#endif
+    mapping = NULL;
+    mappingSize = 0;
+}
+
+bool BrainImage::readSections(std::string &error)
+{
+    const FileHeader *header = (const FileHeader *)mapping;
+    if (mappingSize < sizeof(FileHeader) || memcmp(header->magic, magic, sizeof(magic))) {
+        error = "Not a brain image.";
+        return false;
+    }
+    if (header->byteOrderMark != byteOrderMark || header->version != version) {
+        error = "Brain image version " + std::to_string(header->version) + " is not supported, convert brain again.";
+        return false;
+    }
+    if (header->fileSize != mappingSize || header->numberOfSections > (mappingSize - sizeof(FileHeader)) / sizeof(SectionHeader)) {
+        error = "Brain image is truncated.";
+        return false;
+    }
+
+    /// Every section is checked once here, so use of sections never reads outside of file
+    const SectionHeader *sectionHeaders = (const SectionHeader *)(mapping + sizeof(FileHeader));
+    for (uint32_t i = 0; i < header->numberOfSections; i++) {
+        const SectionHeader &sectionHeader = sectionHeaders[i];
+        Section section = {};
+        section.name.assign(sectionHeader.name, strnlen(sectionHeader.name, maxNameLength));
+        section.sparse = sectionHeader.sparse != 0;
+        section.numberOfDimensions = 3;
+        for (size_t dimension = 0; dimension < 3; dimension++) {
+            section.dimensions[dimension] = (size_t)sectionHeader.dimensions[dimension];
+        }
+        while (section.numberOfDimensions > 2 && section.dimensions[section.numberOfDimensions - 1] == 1) {
+            section.numberOfDimensions--;
+        }
+
+        const size_t rows = section.dimensions[0];
+        const size_t pages = section.dimensions[2];
+        bool valid = !pages || section.dimensions[1] <= SIZE_MAX / pages;
+        const size_t columns = valid ? section.dimensions[1] * pages : 0;
+        const size_t offset = (size_t)sectionHeader.offset;
+        valid = valid && offset % alignment == 0 && offset <= mappingSize && (!columns || rows <= SIZE_MAX / columns);
+        if (valid && !section.sparse) {
+            valid = (sectionHeader.type == SectionTypeDouble || sectionHeader.type == SectionTypeLogical)
+                && section.numberOfElements() <= (mappingSize - offset) / elementSize(sectionHeader.type);
+            section.data = mapping + offset;
+        } else if (valid) {
+            const size_t nonzeros = (size_t)sectionHeader.numberOfNonzeros;
+            const size_t rowIndicesOffset = aligned(offset + (columns + 1) * sizeof(uint64_t));
+            const size_t valuesOffset = aligned(rowIndicesOffset + nonzeros * sizeof(uint64_t));
+            valid = sectionHeader.type == SectionTypeDouble && columns < mappingSize && nonzeros <= mappingSize
+                && valuesOffset + nonzeros * sizeof(double) <= mappingSize;
+            if (valid) {
+                section.columnPointers = (const size_t *)(mapping + offset);
+                section.rowIndices = (const size_t *)(mapping + rowIndicesOffset);
+                section.values = (const double *)(mapping + valuesOffset);
+                section.numberOfNonzeros = nonzeros;
+                valid = section.columnPointers[0] == 0 && section.columnPointers[columns] == nonzeros;
+                for (size_t column = 0; valid && column < columns; column++) {
+                    valid = section.columnPointers[column] <= section.columnPointers[column + 1];
+                }
+                for (size_t j = 0; valid && j < nonzeros; j++) {
+                    valid = section.rowIndices[j] < rows;
+                }
+            }
+        }
+
+        if (!valid) {
+            error = "Section " + section.name + " is damaged.";
+            return false;
+        }
+        section.type = (SectionType)sectionHeader.type;
+        sections.push_back(section);
+    }
+    return true;
+}
+
+const std::vector<BrainImage::Section> &BrainImage::getSections() const
+{
+    return sections;
+}
+
+const BrainImage::Section *BrainImage::find(const std::string &name) const
+{
+    for (const Section &section : sections) {
+        if (section.name == name) { return &section; }
+    }
+    return NULL;
+}
+
+const double *BrainImage::doubles(const std::string &name, size_t numberOfElements) const
+{
+    const Section *section = find(name);
+    if (!section || section->sparse || section->type != SectionTypeDouble || section->numberOfElements() != numberOfElements) { return NULL; }
+    return (const double *)section->data;
+}
+
+//MARK:- BrainImageWriter
+
+void BrainImageWriter::addDoubles(const std::string &name, const size_t dimensions[3], const double *values)
+{
+    const size_t rows = dimensions[0];
+    const size_t columns = dimensions[1] * dimensions[2];
+
+    size_t numberOfNonzeros = 0;
+    for (size_t i = 0; i < rows * columns; i++) {
+        numberOfNonzeros += values[i] != 0;
+    }
+
+    /// Sparse when column pointers, row indices and values take less than half of dense values
+    if ((columns + 1 + numberOfNonzeros * 2) * 2 < rows * columns) {
+        std::vector<size_t> columnPointers(1, 0);
+        std::vector<size_t> rowIndices;
+        std::vector<double> nonzeros;
+        columnPointers.reserve(columns + 1);
+        rowIndices.reserve(numberOfNonzeros);
+        nonzeros.reserve(numberOfNonzeros);
+        for (size_t column = 0; column < columns; column++) {
+            for (size_t row = 0; row < rows; row++) {
+                if (values[column * rows + row] == 0) { continue; }
+                rowIndices.push_back(row);
+                nonzeros.push_back(values[column * rows + row]);
+            }
+            columnPointers.push_back(rowIndices.size());
+        }
+        addSparseDoubles(name, dimensions, columnPointers.data(), rowIndices.data(), nonzeros.data());
+        return;
+    }
+
+    PendingSection section;
+    section.name = name;
+    section.type = BrainImage::SectionTypeDouble;
+    std::copy(dimensions, dimensions + 3, section.dimensions);
+    section.sparse = false;
+    section.data.assign((const uint8_t *)values, (const uint8_t *)(values + rows * columns));
+    sections.push_back(std::move(section));
+}
+
+void BrainImageWriter::addSparseDoubles(const std::string &name, const size_t dimensions[3], const size_t *columnPointers, const size_t *rowIndices, const double *values)
+{
+    const size_t columns = dimensions[1] * dimensions[2];
+    const size_t numberOfNonzeros = columnPointers[columns];
+
+    PendingSection section;
+    section.name = name;
+    section.type = BrainImage::SectionTypeDouble;
+    std::copy(dimensions, dimensions + 3, section.dimensions);
+    section.sparse = true;
+    section.columnPointers.assign(columnPointers, columnPointers + columns + 1);
+    section.rowIndices.assign(rowIndices, rowIndices + numberOfNonzeros);
+    section.values.assign(values, values + numberOfNonzeros);
+    sections.push_back(std::move(section));
+}
+
+void BrainImageWriter::addLogicals(const std::string &name, const size_t dimensions[3], const uint8_t *values)
+{
+    PendingSection section;
+    section.name = name;
+    section.type = BrainImage::SectionTypeLogical;
+    std::copy(dimensions, dimensions + 3, section.dimensions);
+    section.sparse = false;
+    section.data.assign(values, values + dimensions[0] * dimensions[1] * dimensions[2]);
+    sections.push_back(std::move(section));
+}
+
+bool BrainImageWriter::verify(const std::string &path, std::string &error) const
+{
+    BrainImage image;
+    if (!image.open(path, error)) {
+        error = "Written brain image cannot be opened: " + error;
+        return false;
+    }
+
+    const std::vector<BrainImage::Section> &writtenSections = image.getSections();
+    bool equal = writtenSections.size() == sections.size();
+    for (size_t i = 0; equal && i < sections.size(); i++) {
+        const PendingSection &section = sections[i];
+        const BrainImage::Section &written = writtenSections[i];
+        equal = written.name == section.name && written.type == section.type && written.sparse == section.sparse;
+        for (size_t dimension = 0; equal && dimension < 3; dimension++) {
+            equal = written.dimensions[dimension] == section.dimensions[dimension];
+        }
+        if (equal && section.sparse) {
+            equal = written.numberOfNonzeros == section.values.size()
+                && !memcmp(written.columnPointers, section.columnPointers.data(), section.columnPointers.size() * sizeof(uint64_t))
+                && !memcmp(written.rowIndices, section.rowIndices.data(), section.rowIndices.size() * sizeof(uint64_t))
+                && !memcmp(written.values, section.values.data(), section.values.size() * sizeof(double));
+        } else if (equal) {
+            equal = !memcmp(written.data, section.data.data(), section.data.size());
+        }
+        if (!equal) {
+            error = "Section " + section.name + " differs after writing.";
+        }
+    }
+    if (equal && writtenSections.size() != sections.size()) {
+        equal = false;
+        error = "Written brain image has " + std::to_string(writtenSections.size()) + " sections instead of " + std::to_string(sections.size()) + ".";
+    }
+    return equal;
+}
+
+bool BrainImageWriter::write(const std::string &path, std::string &error)
+{
+    /// Offsets of all sections
+    std::vector<SectionHeader> sectionHeaders(sections.size());
+    size_t offset = aligned(sizeof(FileHeader) + sections.size() * sizeof(SectionHeader));
+    for (size_t i = 0; i < sections.size(); i++) {
+        const PendingSection &section = sections[i];
+        if (section.name.size() >= maxNameLength) {
+            error = "Name " + section.name + " is too long.";
+            return false;
+        }
+
+        SectionHeader &sectionHeader = sectionHeaders[i];
+        memset(&sectionHeader, 0, sizeof(SectionHeader));
+        memcpy(sectionHeader.name, section.name.c_str(), section.name.size());
+        sectionHeader.type = section.type;
+        sectionHeader.sparse = section.sparse;
+        for (size_t dimension = 0; dimension < 3; dimension++) {
+            sectionHeader.dimensions[dimension] = section.dimensions[dimension];
+        }
+        sectionHeader.offset = offset;
+        if (section.sparse) {
+            sectionHeader.numberOfNonzeros = section.values.size();
+            offset = aligned(offset + section.columnPointers.size() * sizeof(uint64_t));
+            offset = aligned(offset + section.rowIndices.size() * sizeof(uint64_t));
+            offset = aligned(offset + section.values.size() * sizeof(double));
+        } else {
+            offset = aligned(offset + section.data.size());
+        }
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(FileHeader));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = BrainImage::version;
+    header.byteOrderMark = byteOrderMark;
+    header.numberOfSections = (uint32_t)sections.size();
+    header.fileSize = offset;
+
+    /// Written next to the old file and renamed, brains mapped from the old file keep their data
+    const std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot write " + path;
+        return false;
+    }
+
+    const char zeros[alignment] = {};
+    auto writeAligned = [&](const void *data, size_t size) {
+        file.write((const char *)data, size);
+        file.write(zeros, aligned((size_t)file.tellp()) - (size_t)file.tellp());
+    };
+
+    file.write((const char *)&header, sizeof(FileHeader));
+    writeAligned(sectionHeaders.data(), sectionHeaders.size() * sizeof(SectionHeader));
+    for (const PendingSection &section : sections) {
+        if (section.sparse) {
+            writeAligned(section.columnPointers.data(), section.columnPointers.size() * sizeof(uint64_t));
+            writeAligned(section.rowIndices.data(), section.rowIndices.size() * sizeof(uint64_t));
+            writeAligned(section.values.data(), section.values.size() * sizeof(double));
+        } else {
+            writeAligned(section.data.data(), section.data.size());
+        }
+    }
+    file.close();
+
+    if (!file) {
+        std::remove(temporaryPath.c_str());
+        error = "Cannot write " + path;
+        return false;
+    }
+    if (!verify(temporaryPath, error)) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    if (!MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (std::rename(temporaryPath.c_str(), path.c_str())) {
+#endif
+        std::remove(temporaryPath.c_str());
+        error = "Cannot replace " + path;
+        return false;
+    }
+    return true;
+}
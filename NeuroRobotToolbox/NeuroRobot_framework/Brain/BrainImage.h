@@ -0,0 +1,141 @@
+//
+//  BrainImage.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BrainImage_h
+#define BrainImage_h
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Brain saved as binary file (.nrb) which is mapped to memory instead of read.
+///
+/// Every numeric or logical variable of `brain` struct is one section, up to 3 dimensions, column-major like in MATLAB.
+/// Mostly empty double arrays (`connectome`, `da_connectome`) are stored sparse, as CSC over all columns of all pages,
+/// so they can be given to `BrainSimulation::setSparseConnectome()` and `setSparsePlasticity()` without copying.
+///
+/// Layout, little-endian, every section starts at 64-byte boundary:
+///     FileHeader | SectionHeader x numberOfSections | sections
+///     dense section:  values
+///     sparse section: column pointers (uint64, columns + 1) | row indices (uint64) | values (double)
+class BrainImage {
+
+public:
+
+    const static uint32_t version = 1;
+
+    typedef enum {
+        SectionTypeDouble = 1,
+        SectionTypeLogical = 2
+    } SectionType;
+
+    /// Section of mapped file, pointers are valid while file is open.
+    struct Section {
+        std::string name;
+        SectionType type;
+        /// Size of every dimension, unused dimensions are 1
+        size_t dimensions[3];
+        size_t numberOfDimensions;
+        bool sparse;
+
+        /// Dense values
+        const void *data;
+
+        /// Sparse values, `dimensions[0]` rows x `dimensions[1] * dimensions[2]` columns
+        const size_t *columnPointers;
+        const size_t *rowIndices;
+        const double *values;
+        size_t numberOfNonzeros;
+
+        /// Number of elements including zeros.
+        size_t numberOfElements() const { return dimensions[0] * dimensions[1] * dimensions[2]; }
+    };
+
+private:
+
+    const uint8_t *mapping = NULL;
+    size_t mappingSize = 0;
+    std::vector<Section> sections;
+
+#ifdef _WIN32
+    void *fileHandle = NULL;
+    void *mappingHandle = NULL;
+#endif
+
+    bool readSections(std::string &error);
+
+public:
+
+    BrainImage() {}
+    ~BrainImage();
+    BrainImage(const BrainImage &) = delete;
+    BrainImage &operator=(const BrainImage &) = delete;
+
+    /// Maps file to memory and checks its layout, values of dense sections are not read until they are used.
+    /// @param path Path of .nrb file
+    /// @param error Reason when opening fails
+    /// @return True on success
+    bool open(const std::string &path, std::string &error);
+
+    /// Unmaps file, pointers of sections become invalid.
+    void close();
+
+    /// All sections, in the order they were written.
+    const std::vector<Section> &getSections() const;
+
+    /// Section by name, NULL if there is no such section.
+    const Section *find(const std::string &name) const;
+
+    /// Dense double section with expected number of elements, NULL if missing, sparse or of other size.
+    const double *doubles(const std::string &name, size_t numberOfElements) const;
+};
+
+/// Collects sections and writes them as .nrb file.
+class BrainImageWriter {
+
+private:
+
+    struct PendingSection {
+        std::string name;
+        BrainImage::SectionType type;
+        size_t dimensions[3];
+        bool sparse;
+        std::vector<uint8_t> data;
+        std::vector<uint64_t> columnPointers;
+        std::vector<uint64_t> rowIndices;
+        std::vector<double> values;
+    };
+
+    std::vector<PendingSection> sections;
+
+    /// Opens written file and compares all its sections with added ones, so a file which `BrainImage` rejects or
+    /// reads differently never replaces a good one.
+    bool verify(const std::string &path, std::string &error) const;
+
+public:
+
+    /// Adds double array, stored sparse when that takes less than half of the space.
+    /// @param name Section name, shorter than 32 characters
+    /// @param dimensions Size of 3 dimensions, unused dimensions are 1
+    /// @param values Column-major values
+    void addDoubles(const std::string &name, const size_t dimensions[3], const double *values);
+
+    /// Adds sparse double array, `dimensions[0]` rows x `dimensions[1] * dimensions[2]` columns in CSC form.
+    void addSparseDoubles(const std::string &name, const size_t dimensions[3], const size_t *columnPointers, const size_t *rowIndices, const double *values);
+
+    /// Adds logical array, one byte per element.
+    void addLogicals(const std::string &name, const size_t dimensions[3], const uint8_t *values);
+
+    /// Writes all added sections and checks that they are read back unchanged.
+    /// @param path Path of .nrb file, replaced if it exists
+    /// @param error Reason when writing fails
+    /// @return True on success
+    bool write(const std::string &path, std::string &error);
+};
+
+#endif /* BrainImage_h */
@@ -0,0 +1,574 @@
+//
+//  BrainSimulation.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "BrainSimulation.h"
+#include "../Core/Barrier.h"
+#include "../Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+/// Copies array, converting precision.
+template <typename Destination, typename Source>
+static void convertArray(AlignedVector<Destination> &destination, const Source *source, size_t numberOfElements)
+{
+    destination.resize(numberOfElements);
+    for (size_t i = 0; i < numberOfElements; i++) {
+        destination[i] = (Destination)source[i];
+    }
+}
+
+/// Copies array out, converting precision.
+template <typename Destination, typename Source>
+static void convertArray(Destination *destination, const AlignedVector<Source> &source, size_t numberOfElements)
+{
+    for (size_t i = 0; i < numberOfElements; i++) {
+        destination[i] = (Destination)source[i];
+    }
+}
+
+/// Copies all arrays, converting precision.
+template <typename Destination, typename Source>
+static void convertNeurons(NeuronArrays<Destination> &destination, const NeuronArrays<Source> &source)
+{
+    convertArray(destination.a, source.a.data(), source.a.size());
+    convertArray(destination.b, source.b.data(), source.b.size());
+    convertArray(destination.c, source.c.data(), source.c.size());
+    convertArray(destination.d, source.d.data(), source.d.size());
+    convertArray(destination.v, source.v.data(), source.v.size());
+    convertArray(destination.u, source.u.data(), source.u.size());
+    convertArray(destination.weights, source.weights.data(), source.weights.size());
+    destination.current.resize(source.current.size());
+    destination.synapticCurrent.resize(source.synapticCurrent.size());
+}
+
+template <typename Real>
+static void setNeuronArrays(NeuronArrays<Real> &neurons, size_t numberOfNeurons, const double *a, const double *b, const double *c, const double *d, const double *v, const double *u)
+{
+    neurons.resize(numberOfNeurons);
+    convertArray(neurons.a, a, numberOfNeurons);
+    convertArray(neurons.b, b, numberOfNeurons);
+    convertArray(neurons.c, c, numberOfNeurons);
+    convertArray(neurons.d, d, numberOfNeurons);
+    convertArray(neurons.v, v, numberOfNeurons);
+    convertArray(neurons.u, u, numberOfNeurons);
+}
+
+template <typename Real>
+static void setWeights(NeuronArrays<Real> &neurons, const std::vector<double> &columnWeights, const std::vector<uint32_t> &synapseIndices)
+{
+    neurons.weights.resize(columnWeights.size());
+    for (size_t i = 0; i < columnWeights.size(); i++) {
+        neurons.weights[synapseIndices[i]] = (Real)columnWeights[i];
+    }
+}
+
+template <typename Real>
+static void getWeights(const NeuronArrays<Real> &neurons, size_t numberOfNeurons, const std::vector<uint32_t> &rowPointers, const std::vector<uint32_t> &postsynapticNeurons, double *weights)
+{
+    const size_t n = numberOfNeurons;
+
+    std::fill(weights, weights + n * n, 0.0);
+    for (size_t pre = 0; pre < n; pre++) {
+        for (uint32_t synapse = rowPointers[pre]; synapse < rowPointers[pre + 1]; synapse++) {
+            weights[postsynapticNeurons[synapse] * n + pre] = (double)neurons.weights[synapse];
+        }
+    }
+}
+
+BrainSimulation::BrainSimulation()
+{
+    std::random_device randomDevice;
+    setSeed(((uint64_t)randomDevice() << 32) | randomDevice());
+
+    buildPartitions();
+}
+
+BrainSimulation::~BrainSimulation()
+{
+}
+
+void BrainSimulation::setNeurons(size_t numberOfNeurons_, const double *a, const double *b, const double *c, const double *d, const double *v, const double *u)
+{
+    if (numberOfNeurons_ != numberOfNeurons) {
+        numberOfNeurons = numberOfNeurons_;
+
+        /// New size has no synapses until connectome is set
+        rowPointers.assign(numberOfNeurons + 1, 0);
+        columnPointers.assign(numberOfNeurons + 1, 0);
+        postsynapticNeurons.clear();
+        presynapticNeurons.clear();
+        synapseIndices.clear();
+        doubleNeurons.weights.clear();
+        singleNeurons.weights.clear();
+        plasticity.clear();
+        plasticSynapseIndices.clear();
+        basalGanglia.clear();
+        if (spikeRecorder) {
+            spikeRecorder->clear();
+        }
+
+        buildPartitions();
+    }
+
+    if (singlePrecision) {
+        setNeuronArrays(singleNeurons, numberOfNeurons, a, b, c, d, v, u);
+    } else {
+        setNeuronArrays(doubleNeurons, numberOfNeurons, a, b, c, d, v, u);
+    }
+}
+
+void BrainSimulation::getState(double *v, double *u)
+{
+    if (singlePrecision) {
+        convertArray(v, singleNeurons.v, numberOfNeurons);
+        convertArray(u, singleNeurons.u, numberOfNeurons);
+    } else {
+        std::memcpy(v, doubleNeurons.v.data(), numberOfNeurons * sizeof(double));
+        std::memcpy(u, doubleNeurons.u.data(), numberOfNeurons * sizeof(double));
+    }
+}
+
+void BrainSimulation::buildRowsFromColumns(const std::vector<double> &columnWeights)
+{
+    const size_t n = numberOfNeurons;
+    const size_t synapses = columnWeights.size();
+
+    /// Count synapses per presynaptic neuron
+    rowPointers.assign(n + 1, 0);
+    for (size_t i = 0; i < synapses; i++) {
+        rowPointers[presynapticNeurons[i] + 1]++;
+    }
+    for (size_t pre = 0; pre < n; pre++) {
+        rowPointers[pre + 1] += rowPointers[pre];
+    }
+
+    /// Going through columns in order keeps every row ordered by postsynaptic neuron
+    postsynapticNeurons.resize(synapses);
+    synapseIndices.resize(synapses);
+    std::vector<uint32_t> nextInRow(rowPointers.begin(), rowPointers.end() - 1);
+    for (size_t post = 0; post < n; post++) {
+        for (uint32_t i = columnPointers[post]; i < columnPointers[post + 1]; i++) {
+            uint32_t synapse = nextInRow[presynapticNeurons[i]]++;
+            postsynapticNeurons[synapse] = (uint32_t)post;
+            synapseIndices[i] = synapse;
+        }
+    }
+
+    if (singlePrecision) {
+        setWeights(singleNeurons, columnWeights, synapseIndices);
+    } else {
+        setWeights(doubleNeurons, columnWeights, synapseIndices);
+    }
+
+    buildPartitions();
+}
+
+void BrainSimulation::buildPartitions()
+{
+    const size_t n = numberOfNeurons;
+    const unsigned int partitions = numberOfPartitions;
+
+    /// Partitions start at multiples of `simdNeuronBlock`, so every thread starts on an aligned cache line
+    partitionBegin.resize(partitions + 1);
+    for (unsigned int p = 0; p < partitions; p++) {
+        partitionBegin[p] = n * p / partitions / simdNeuronBlock * simdNeuronBlock;
+    }
+    partitionBegin[partitions] = n;
+
+    /// Rows are ordered by postsynaptic neuron, so every row splits into contiguous parts
+    rowSplit.resize(n * (partitions + 1));
+    for (size_t pre = 0; pre < n; pre++) {
+        uint32_t *split = &rowSplit[pre * (partitions + 1)];
+        const uint32_t *rowBegin = postsynapticNeurons.data() + rowPointers[pre];
+        const uint32_t *rowEnd = postsynapticNeurons.data() + rowPointers[pre + 1];
+        for (unsigned int p = 0; p < partitions; p++) {
+            split[p] = rowPointers[pre] + (uint32_t)(std::lower_bound(rowBegin, rowEnd, (uint32_t)partitionBegin[p]) - rowBegin);
+        }
+        split[partitions] = rowPointers[pre + 1];
+    }
+
+    for (int parity = 0; parity < 2; parity++) {
+        firedNow[parity].resize(partitions);
+        for (unsigned int p = 0; p < partitions; p++) {
+            firedNow[parity][p].reserve(partitionBegin[p + 1] - partitionBegin[p]);
+        }
+    }
+}
+
+void BrainSimulation::setConnectome(const double *weights, bool keepPlasticity)
+{
+    const size_t n = numberOfNeurons;
+    std::vector<double> columnWeights;
+
+    columnPointers.assign(n + 1, 0);
+    presynapticNeurons.clear();
+    for (size_t post = 0; post < n; post++) {
+        const double *column = &weights[post * n];
+        for (size_t pre = 0; pre < n; pre++) {
+            if (column[pre] != 0) {
+                presynapticNeurons.push_back((uint32_t)pre);
+                columnWeights.push_back(column[pre]);
+            }
+        }
+        columnPointers[post + 1] = (uint32_t)presynapticNeurons.size();
+    }
+
+    if (!keepPlasticity) {
+        plasticity.clear();
+    }
+    plasticSynapseIndices.clear();
+    buildRowsFromColumns(columnWeights);
+    if (keepPlasticity) {
+        indexPlasticSynapses();
+    }
+}
+
+void BrainSimulation::setSparseConnectome(const size_t *columnPointers_, const size_t *rowIndices, const double *values)
+{
+    const size_t n = numberOfNeurons;
+    std::vector<double> columnWeights;
+    columnWeights.reserve(columnPointers_[n]);
+
+    columnPointers.assign(n + 1, 0);
+    presynapticNeurons.clear();
+    presynapticNeurons.reserve(columnPointers_[n]);
+    for (size_t post = 0; post < n; post++) {
+        for (size_t i = columnPointers_[post]; i < columnPointers_[post + 1]; i++) {
+            if (values[i] != 0) {
+                presynapticNeurons.push_back((uint32_t)rowIndices[i]);
+                columnWeights.push_back(values[i]);
+            }
+        }
+        columnPointers[post + 1] = (uint32_t)presynapticNeurons.size();
+    }
+
+    plasticity.clear();
+    plasticSynapseIndices.clear();
+    buildRowsFromColumns(columnWeights);
+}
+
+void BrainSimulation::getConnectome(double *weights)
+{
+    if (singlePrecision) {
+        getWeights(singleNeurons, numberOfNeurons, rowPointers, postsynapticNeurons, weights);
+    } else {
+        getWeights(doubleNeurons, numberOfNeurons, rowPointers, postsynapticNeurons, weights);
+    }
+}
+
+int64_t BrainSimulation::findSynapse(uint32_t presynapticNeuron, uint32_t postsynapticNeuron)
+{
+    /// Column is ordered by presynaptic neuron
+    auto columnBegin = presynapticNeurons.begin() + columnPointers[postsynapticNeuron];
+    auto columnEnd = presynapticNeurons.begin() + columnPointers[postsynapticNeuron + 1];
+    auto found = std::lower_bound(columnBegin, columnEnd, presynapticNeuron);
+    if (found == columnEnd || *found != presynapticNeuron) { return -1; }
+
+    return synapseIndices[found - presynapticNeurons.begin()];
+}
+
+double BrainSimulation::synapseWeight(uint32_t synapse)
+{
+    return singlePrecision ? (double)singleNeurons.weights[synapse] : doubleNeurons.weights[synapse];
+}
+
+void BrainSimulation::addZeroSynapses(const std::vector<std::pair<uint32_t, uint32_t>> &synapses)
+{
+    const size_t n = numberOfNeurons;
+    std::vector<uint32_t> mergedColumnPointers(n + 1, 0);
+    std::vector<uint32_t> mergedPresynapticNeurons;
+    std::vector<double> columnWeights;
+    mergedPresynapticNeurons.reserve(presynapticNeurons.size() + synapses.size());
+    columnWeights.reserve(presynapticNeurons.size() + synapses.size());
+
+    /// Merge stored and new synapses column by column, both are ordered by presynaptic neuron
+    auto added = synapses.begin();
+    for (uint32_t post = 0; post < n; post++) {
+        uint32_t i = columnPointers[post];
+        while (i < columnPointers[post + 1] || (added != synapses.end() && added->first == post)) {
+            bool takeAdded = added != synapses.end() && added->first == post && (i == columnPointers[post + 1] || added->second < presynapticNeurons[i]);
+            if (takeAdded) {
+                mergedPresynapticNeurons.push_back(added->second);
+                columnWeights.push_back(0);
+                added++;
+            } else {
+                mergedPresynapticNeurons.push_back(presynapticNeurons[i]);
+                columnWeights.push_back(synapseWeight(synapseIndices[i]));
+                i++;
+            }
+        }
+        mergedColumnPointers[post + 1] = (uint32_t)mergedPresynapticNeurons.size();
+    }
+
+    columnPointers.swap(mergedColumnPointers);
+    presynapticNeurons.swap(mergedPresynapticNeurons);
+    buildRowsFromColumns(columnWeights);
+}
+
+void BrainSimulation::setPlasticity(const double *daConnectome)
+{
+    plasticity.set(numberOfNeurons, daConnectome);
+    indexPlasticSynapses();
+}
+
+void BrainSimulation::setSparsePlasticity(const size_t *columnPointers, const size_t *rowIndices, const double *values)
+{
+    plasticity.setSparse(numberOfNeurons, columnPointers, rowIndices, values);
+    indexPlasticSynapses();
+}
+
+void BrainSimulation::indexPlasticSynapses()
+{
+    const size_t numberOfPlasticSynapses = plasticity.size();
+
+    /// Plastic synapses with zero weight are not stored, they get stored so learning can change their weight
+    std::vector<std::pair<uint32_t, uint32_t>> missingSynapses;
+    for (size_t i = 0; i < numberOfPlasticSynapses; i++) {
+        if (findSynapse(plasticity.presynapticNeuron(i), plasticity.postsynapticNeuron(i)) < 0) {
+            missingSynapses.push_back(std::make_pair(plasticity.postsynapticNeuron(i), plasticity.presynapticNeuron(i)));
+        }
+    }
+    if (!missingSynapses.empty()) {
+        addZeroSynapses(missingSynapses);
+    }
+
+    plasticSynapseIndices.resize(numberOfPlasticSynapses);
+    for (size_t i = 0; i < numberOfPlasticSynapses; i++) {
+        plasticSynapseIndices[i] = (uint32_t)findSynapse(plasticity.presynapticNeuron(i), plasticity.postsynapticNeuron(i));
+        plasticity.setWeight(i, synapseWeight(plasticSynapseIndices[i]));
+    }
+}
+
+SynapticPlasticity &BrainSimulation::getPlasticity()
+{
+    return plasticity;
+}
+
+void BrainSimulation::learn(const uint8_t *firing, const double *stepsSinceLastSpike, double reward, const SynapticPlasticity::Parameters &parameters, std::vector<SynapticPlasticity::Change> &changes)
+{
+    plasticity.learn(firing, stepsSinceLastSpike, reward, parameters, changes);
+
+    /// Only plastic synapses can change
+    const std::vector<double> &plasticWeights = plasticity.getWeights();
+    for (size_t i = 0; i < plasticWeights.size(); i++) {
+        if (singlePrecision) {
+            singleNeurons.weights[plasticSynapseIndices[i]] = (float)plasticWeights[i];
+        } else {
+            doubleNeurons.weights[plasticSynapseIndices[i]] = plasticWeights[i];
+        }
+    }
+}
+
+size_t BrainSimulation::numberOfSynapses()
+{
+    return postsynapticNeurons.size();
+}
+
+void BrainSimulation::setBasalGanglia(const double *networkIds, const double *basalGangliaNeurons, size_t numberOfNetworks, const double *drive, bool enabled)
+{
+    basalGanglia.set(numberOfNeurons, networkIds, basalGangliaNeurons, numberOfNetworks, drive, enabled);
+}
+
+BasalGanglia &BrainSimulation::getBasalGanglia()
+{
+    return basalGanglia;
+}
+
+void BrainSimulation::setRecording(bool recording)
+{
+    if (!recording) {
+        spikeRecorder.reset();
+    } else if (!spikeRecorder) {
+        spikeRecorder.reset(new SpikeRecorder());
+    }
+}
+
+SpikeRecorder *BrainSimulation::getSpikeRecorder()
+{
+    return spikeRecorder.get();
+}
+
+void BrainSimulation::setSeed(uint64_t seed)
+{
+    noiseGenerator.setSeed(seed);
+    basalGanglia.setSeed(seed);
+    simulatedMs = 0;
+}
+
+uint64_t BrainSimulation::getSeed()
+{
+    return noiseGenerator.getSeed();
+}
+
+void BrainSimulation::setNumberOfThreads(unsigned int numberOfThreads_)
+{
+    /// More partitions than CPUs only wait for each other at every ms
+    unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (numberOfThreads_ > maxThreads) { numberOfThreads_ = maxThreads; }
+    if (numberOfThreads_ < 1) { numberOfThreads_ = 1; }
+
+    if (numberOfThreads_ != numberOfPartitions) {
+        numberOfPartitions = numberOfThreads_;
+        buildPartitions();
+
+        /// Caller's thread simulates partition 0, every other partition has its own worker
+        partitionWorkers.reset();
+        if (numberOfPartitions > 1) {
+            partitionWorkers.reset(new ThreadPool(numberOfPartitions - 1));
+        }
+    }
+}
+
+unsigned int BrainSimulation::numberOfThreads()
+{
+    return numberOfPartitions;
+}
+
+void BrainSimulation::setSinglePrecision(bool singlePrecision_)
+{
+    if (singlePrecision_ == singlePrecision) { return; }
+
+    singlePrecision = singlePrecision_;
+    if (singlePrecision) {
+        convertNeurons(singleNeurons, doubleNeurons);
+        doubleNeurons.clear();
+    } else {
+        convertNeurons(doubleNeurons, singleNeurons);
+        singleNeurons.clear();
+    }
+}
+
+bool BrainSimulation::isSinglePrecision()
+{
+    return singlePrecision;
+}
+
+void BrainSimulation::step(unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, double reward, uint8_t *spikes, double *currents)
+{
+    std::memset(spikes, 0, numberOfNeurons * msPerStep);
+
+    if (singlePrecision) {
+        runStep(singleNeurons, msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, spikes, currents);
+    } else {
+        runStep(doubleNeurons, msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, spikes, currents);
+    }
+
+    if (basalGanglia.isSet()) {
+        basalGanglia.gate(msPerStep, currents, reward, spikes);
+    }
+    if (spikeRecorder) {
+        spikeRecorder->record(spikes, numberOfNeurons, msPerStep);
+    }
+
+    simulatedMs += msPerStep;
+}
+
+template <typename Real>
+void BrainSimulation::runStep(NeuronArrays<Real> &neurons, unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, uint8_t *spikes, double *currents)
+{
+    Barrier barrier(numberOfPartitions);
+    if (numberOfPartitions == 1) {
+        stepPartition(neurons, 0, msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, spikes, currents, barrier);
+        return;
+    }
+
+    std::mutex mutexPending;
+    std::condition_variable pendingCondition;
+    unsigned int numberOfPending = numberOfPartitions - 1;
+
+    for (unsigned int p = 1; p < numberOfPartitions; p++) {
+        partitionWorkers->enqueue([=, &neurons, &barrier, &mutexPending, &pendingCondition, &numberOfPending] {
+            stepPartition(neurons, p, msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, spikes, currents, barrier);
+
+            std::lock_guard<std::mutex> lock(mutexPending);
+            numberOfPending--;
+            pendingCondition.notify_one();
+        });
+    }
+    stepPartition(neurons, 0, msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, spikes, currents, barrier);
+
+    std::unique_lock<std::mutex> lock(mutexPending);
+    pendingCondition.wait(lock, [&numberOfPending] { return numberOfPending == 0; });
+}
+
+template <typename Real>
+void BrainSimulation::stepPartition(NeuronArrays<Real> &neurons, unsigned int partition, unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, uint8_t *spikes, double *currents, Barrier &barrier)
+{
+    const size_t n = numberOfNeurons;
+    const size_t begin = partitionBegin[partition];
+    const size_t end = partitionBegin[partition + 1];
+    const unsigned int splitStride = numberOfPartitions + 1;
+
+    Real *current = neurons.current.data();
+    Real *synapticCurrent = neurons.synapticCurrent.data();
+    const Real *weights = neurons.weights.data();
+
+    /// Operations are in the same order as in `update_brain.m`, so results match MATLAB for the same noise.
+    for (unsigned int t = 0; t < msPerStep; t++) {
+        std::vector<std::vector<uint32_t>> &fired = firedNow[t & 1];
+
+        /// Add noise
+        if (noise) {
+            for (size_t i = begin; i < end; i++) {
+                current[i] = (Real)noiseAmplitude * (Real)noise[t * n + i];
+            }
+        } else {
+            noiseGenerator.fill(current, begin, end, simulatedMs + t, (Real)noiseAmplitude);
+        }
+
+        /// Find spiking neurons, reset their v to c and adjust u by d
+        std::vector<uint32_t> &firedInPartition = fired[partition];
+        firedInPartition.clear();
+        resetFiredNeurons(neurons, begin, end, &spikes[t * n], firedInPartition);
+
+        /// Spikes of all partitions are known after this point
+        barrier.wait();
+
+        /// Add spiking synaptic weights to neuronal inputs, summed in ascending order of presynaptic neurons like `sum(connectome(fired_now,:), 1)`.
+        /// Only synapses of fired neurons which target this partition are visited, skipped zero weights do not change the sums.
+        size_t numberOfFired = 0;
+        for (unsigned int p = 0; p < numberOfPartitions; p++) {
+            numberOfFired += fired[p].size();
+        }
+        if (numberOfFired) {
+            std::fill(synapticCurrent + begin, synapticCurrent + end, (Real)0);
+            for (unsigned int p = 0; p < numberOfPartitions; p++) {
+                for (uint32_t pre : fired[p]) {
+                    const uint32_t *split = &rowSplit[pre * splitStride];
+                    for (uint32_t synapse = split[partition]; synapse < split[partition + 1]; synapse++) {
+                        synapticCurrent[postsynapticNeurons[synapse]] += weights[synapse];
+                    }
+                }
+            }
+            for (size_t i = begin; i < end; i++) {
+                current[i] = current[i] + synapticCurrent[i];
+            }
+        }
+
+        /// Add sensory input currents
+        for (size_t k = 0; k < numberOfSensoryInputs; k++) {
+            const double *input = &sensoryCurrent[k * n];
+            for (size_t i = begin; i < end; i++) {
+                current[i] = current[i] + (Real)input[i];
+            }
+        }
+        for (size_t i = begin; i < end; i++) {
+            currents[t * n + i] = (double)current[i];
+        }
+
+        /// Update v in two half steps, then u
+        updateNeurons(neurons, begin, end);
+    }
+}
+
+size_t BrainSimulation::size()
+{
+    return numberOfNeurons;
+}
@@ -0,0 +1,232 @@
+//
+//  BrainSimulation.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef BrainSimulation_h
+#define BrainSimulation_h
+
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+#include "NeuronKernels.h"
+#include "NoiseGenerator.h"
+#include "SynapticPlasticity.h"
+#include "BasalGanglia.h"
+#include "SpikeRecorder.h"
+
+class Barrier;
+class ThreadPool;
+
+/// Native port of the core loop of `update_brain.m`.
+/// Holds Izhikevich neurons and the connectome and advances one brain step (`ms_per_step` simulated ms) per call.
+/// All matrices going in and out are column-major, like in MATLAB.
+class BrainSimulation {
+
+private:
+
+    size_t numberOfNeurons = 0;
+
+    /// Neurons and weights, only arrays of selected precision are allocated
+    bool singlePrecision = false;
+    NeuronArrays<double> doubleNeurons;
+    NeuronArrays<float> singleNeurons;
+
+    /// Synapses in CSR form, row is presynaptic neuron, only nonzero weights are stored.
+    /// Synapses of presynaptic neuron `pre` are `rowPointers[pre]` ..< `rowPointers[pre + 1]`, ordered by postsynaptic neuron.
+    std::vector<uint32_t> rowPointers;
+    std::vector<uint32_t> postsynapticNeurons;
+
+    /// CSC index over the same synapses, column is postsynaptic neuron.
+    /// Synapses of postsynaptic neuron `post` are `columnPointers[post]` ..< `columnPointers[post + 1]`, ordered by presynaptic neuron,
+    /// `synapseIndices` points into `weights` of neuron arrays.
+    std::vector<uint32_t> columnPointers;
+    std::vector<uint32_t> presynapticNeurons;
+    std::vector<uint32_t> synapseIndices;
+
+    /// Neurons are split in contiguous partitions which are simulated on separate threads.
+    /// Partition `p` holds neurons `partitionBegin[p]` ..< `partitionBegin[p + 1]`.
+    unsigned int numberOfPartitions = 1;
+    std::vector<size_t> partitionBegin;
+
+    /// Threads of partitions 1..N-1, partition 0 runs on caller's thread. Owned by this brain only, because partitions
+    /// wait for each other every ms and would deadlock behind jobs of other brains or I/O on a shared pool.
+    std::unique_ptr<ThreadPool> partitionWorkers;
+
+    /// Start of synapses of every row which target partition, `rowSplit[pre * (numberOfPartitions + 1) + p]`.
+    /// Every partition walks only its part of the rows of fired neurons, so no two threads write the same input current.
+    std::vector<uint32_t> rowSplit;
+
+    /// Neurons fired in the current ms per partition, double buffered by ms parity,
+    /// so partitions can find spikes of the next ms while others still read the previous ones.
+    std::vector<std::vector<uint32_t>> firedNow[2];
+
+    /// Noise used when noise is not forwarded, counted in simulated ms since seed was set
+    NoiseGenerator noiseGenerator;
+    uint64_t simulatedMs = 0;
+
+    /// Learning of plastic synapses and index of every plastic synapse in `weights` of neuron arrays
+    SynapticPlasticity plasticity;
+    std::vector<uint32_t> plasticSynapseIndices;
+
+    /// Network selection which gates spikes of step output
+    BasalGanglia basalGanglia;
+
+    /// Compressed spikes of all steps, created by `setRecording()`
+    std::unique_ptr<SpikeRecorder> spikeRecorder;
+
+    /// Builds CSR from CSC which is already in `columnPointers` and `presynapticNeurons`, and fills `synapseIndices`.
+    /// @param columnWeights Weights in CSC order
+    void buildRowsFromColumns(const std::vector<double> &columnWeights);
+
+    /// Index of synapse in `weights` of neuron arrays, or -1 if synapse is not stored.
+    int64_t findSynapse(uint32_t presynapticNeuron, uint32_t postsynapticNeuron);
+
+    /// Weight of synapse in selected precision, as double.
+    double synapseWeight(uint32_t synapse);
+
+    /// Stores synapses with zero weight, so they can get weight later without rebuilding the connectome.
+    /// @param synapses Pairs of (postsynaptic, presynaptic) neurons, sorted, not stored yet
+    void addZeroSynapses(const std::vector<std::pair<uint32_t, uint32_t>> &synapses);
+
+    /// Finds plastic synapses in connectome and takes their weights, missing synapses are added with zero weight.
+    void indexPlasticSynapses();
+
+    /// Splits neurons into partitions and splits rows of connectome between them.
+    void buildPartitions();
+
+    /// Runs step on all partitions.
+    template <typename Real>
+    void runStep(NeuronArrays<Real> &neurons, unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, uint8_t *spikes, double *currents);
+
+    /// Runs whole step for one partition.
+    /// @param neurons Neurons of selected precision
+    /// @param partition Index of partition
+    /// @param barrier Barrier shared by all partitions, reached once per ms
+    template <typename Real>
+    void stepPartition(NeuronArrays<Real> &neurons, unsigned int partition, unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, uint8_t *spikes, double *currents, Barrier &barrier);
+
+public:
+
+    /// Amplitude of noise current, `I = 5 * randn(nneurons, 1)`.
+    static constexpr double noiseAmplitude = 5;
+
+    /// Membrane potential at which neuron spikes.
+    static constexpr double spikeThreshold = 30;
+
+    BrainSimulation();
+    ~BrainSimulation();
+
+    /// Set neurons, resizes the simulation if number of neurons changed.
+    /// @param numberOfNeurons Number of neurons
+    /// @param a Izhikevich parameter a
+    /// @param b Izhikevich parameter b
+    /// @param c Izhikevich parameter c
+    /// @param d Izhikevich parameter d
+    /// @param v Membrane potential
+    /// @param u Recovery variable
+    void setNeurons(size_t numberOfNeurons, const double *a, const double *b, const double *c, const double *d, const double *v, const double *u);
+
+    /// Read neuron state.
+    /// @param v Buffer for membrane potential, `numberOfNeurons` values
+    /// @param u Buffer for recovery variable, `numberOfNeurons` values
+    void getState(double *v, double *u);
+
+    /// Set synaptic weights from dense matrix, zero weights are not stored.
+    /// @param weights Column-major `numberOfNeurons` x `numberOfNeurons` matrix, `weights(pre, post)`
+    /// @param keepPlasticity Flag whether plastic synapses keep their learning state, their weights are then taken from `weights`
+    void setConnectome(const double *weights, bool keepPlasticity = false);
+
+    /// Set synaptic weights from MATLAB sparse matrix (CSC), zero weights are not stored.
+    /// @param columnPointers `numberOfNeurons + 1` column pointers (`mxGetJc`), column is postsynaptic neuron
+    /// @param rowIndices Row indices (`mxGetIr`), row is presynaptic neuron
+    /// @param values Weights (`mxGetPr`)
+    void setSparseConnectome(const size_t *columnPointers, const size_t *rowIndices, const double *values);
+
+    /// Read synaptic weights.
+    /// @param weights Buffer for column-major `numberOfNeurons` x `numberOfNeurons` matrix
+    void getConnectome(double *weights);
+
+    /// Number of stored synapses.
+    size_t numberOfSynapses();
+
+    /// Set plastic synapses, their learning state is taken from `da_connectome` and their weights from the connectome,
+    /// so connectome has to be set before. Setting connectome again removes plastic synapses, unless they are kept.
+    /// @param daConnectome Column-major `numberOfNeurons` x `numberOfNeurons` x 3 array, `da_connectome`
+    void setPlasticity(const double *daConnectome);
+
+    /// Set plastic synapses from sparse `da_connectome`, like `setPlasticity()`.
+    /// @param columnPointers CSC column pointers of `numberOfNeurons` x `numberOfNeurons * 3` matrix, `da_connectome(:, :)`
+    /// @param rowIndices Row indices, increasing in every column
+    /// @param values Nonzero values
+    void setSparsePlasticity(const size_t *columnPointers, const size_t *rowIndices, const double *values);
+
+    /// Plastic synapses, ordered by column-major index in `numberOfNeurons` x `numberOfNeurons` matrix.
+    SynapticPlasticity &getPlasticity();
+
+    /// Learning and forgetting of plastic synapses after a step, see `SynapticPlasticity::learn()`.
+    /// Learned weights are used by following steps.
+    void learn(const uint8_t *firing, const double *stepsSinceLastSpike, double reward, const SynapticPlasticity::Parameters &parameters, std::vector<SynapticPlasticity::Change> &changes);
+
+    /// Set networks of basal ganglia selection, after that every step output is gated by selected network.
+    /// @param networkIds `network_ids`, network of every neuron from 1
+    /// @param basalGangliaNeurons `bg_neurons`, nonzero for basal ganglia neurons
+    /// @param numberOfNetworks `nnetworks`
+    /// @param drive `network_drive`, column-major `numberOfNetworks` x 3
+    /// @param enabled `bg_brain`, without it only basal ganglia neurons are silenced
+    void setBasalGanglia(const double *networkIds, const double *basalGangliaNeurons, size_t numberOfNetworks, const double *drive, bool enabled);
+
+    /// Basal ganglia selection, state after last step.
+    BasalGanglia &getBasalGanglia();
+
+    /// Start or stop recording spikes of every step output, see `SpikeRecorder`.
+    /// Recorded spikes are removed when number of neurons changes.
+    /// @param recording True to record
+    void setRecording(bool recording);
+
+    /// Recorder of spikes, `NULL` when spikes are not recorded.
+    SpikeRecorder *getSpikeRecorder();
+
+    /// Seed noise generator used when noise is not forwarded to `step()` and restart its ms count.
+    /// Every brain gets a random seed when created, the same seed replays the same noise for any number of threads.
+    /// Random changes of basal ganglia drive are seeded too.
+    /// @param seed Seed
+    void setSeed(uint64_t seed);
+
+    /// Seed of noise generator.
+    uint64_t getSeed();
+
+    /// Set number of threads which simulate the brain, neurons are split evenly between them.
+    /// Results do not depend on number of threads.
+    /// @param numberOfThreads Number of threads, limited by number of CPUs
+    void setNumberOfThreads(unsigned int numberOfThreads);
+
+    /// Number of threads which simulate the brain.
+    unsigned int numberOfThreads();
+
+    /// Select float32 state and weights instead of float64. Halves memory traffic, results differ from MATLAB within rounding.
+    /// Current state and weights are converted.
+    /// @param singlePrecision True for float32
+    void setSinglePrecision(bool singlePrecision);
+
+    /// True if state and weights are float32.
+    bool isSinglePrecision();
+
+    /// Advance simulation for `msPerStep` ms.
+    /// @param msPerStep Number of simulated ms
+    /// @param sensoryCurrent Column-major `numberOfNeurons` x `numberOfSensoryInputs` matrix of input currents, columns are added in order
+    /// @param numberOfSensoryInputs Number of columns of `sensoryCurrent`
+    /// @param noise Column-major `numberOfNeurons` x `msPerStep` matrix of standard normal values, generated by `NoiseGenerator` if `NULL`
+    /// @param reward Reward of this step, used by basal ganglia selection
+    /// @param spikes Output, column-major `numberOfNeurons` x `msPerStep` matrix, 1 where neuron spiked, gated by basal ganglia selection if set
+    /// @param currents Output, column-major `numberOfNeurons` x `msPerStep` matrix of total input current
+    void step(unsigned int msPerStep, const double *sensoryCurrent, size_t numberOfSensoryInputs, const double *noise, double reward, uint8_t *spikes, double *currents);
+
+    /// Number of neurons.
+    size_t size();
+};
+
+#endif /* BrainSimulation_h */
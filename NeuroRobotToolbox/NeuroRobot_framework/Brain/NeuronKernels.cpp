@@ -0,0 +1,183 @@
+//
+//  NeuronKernels.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  SIMD kernels are compiled when the compiler targets AVX2 (`-mavx2`, `/arch:AVX2`), otherwise scalar loops are used.
+//  Kernels do exactly the same operations in the same order as the scalar loops, so results do not depend on the instruction set.
+//  FMA contraction must stay off (no `-mfma`, or `-ffp-contract=off`) to keep results equal to MATLAB.
+//
+
+#include "NeuronKernels.h"
+
+#include <cmath>
+
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
+
+/// Membrane potential at which neuron spikes.
+const static double spikeThreshold = 30;
+
+template <typename Real>
+static void resetFiredNeuronsScalar(NeuronArrays<Real> &neurons, size_t begin, size_t end, uint8_t *spikes, std::vector<uint32_t> &fired)
+{
+    Real *v = neurons.v.data();
+    Real *u = neurons.u.data();
+    const Real *c = neurons.c.data();
+    const Real *d = neurons.d.data();
+
+    for (size_t i = begin; i < end; i++) {
+        if (v[i] >= (Real)spikeThreshold) {
+            fired.push_back((uint32_t)i);
+            spikes[i] = 1;
+            v[i] = c[i];
+            u[i] = u[i] + d[i];
+        }
+    }
+}
+
+template <typename Real>
+static void updateNeuronsScalar(NeuronArrays<Real> &neurons, size_t begin, size_t end)
+{
+    Real *v = neurons.v.data();
+    Real *u = neurons.u.data();
+    const Real *a = neurons.a.data();
+    const Real *b = neurons.b.data();
+    const Real *c = neurons.c.data();
+    const Real *current = neurons.current.data();
+
+    for (size_t i = begin; i < end; i++) {
+        Real vi = v[i];
+        vi = vi + (Real)0.5 * ((Real)0.04 * (vi * vi) + (Real)5 * vi + (Real)140 - u[i] + current[i]);
+        vi = vi + (Real)0.5 * ((Real)0.04 * (vi * vi) + (Real)5 * vi + (Real)140 - u[i] + current[i]);
+        u[i] = u[i] + a[i] * (b[i] * vi - u[i]);
+
+        /// Avoid nans
+        v[i] = std::isnan(vi) ? c[i] : vi;
+    }
+}
+
+template <>
+void resetFiredNeurons<double>(NeuronArrays<double> &neurons, size_t begin, size_t end, uint8_t *spikes, std::vector<uint32_t> &fired)
+{
+    size_t i = begin;
+#ifdef __AVX2__
+    double *v = neurons.v.data();
+    const __m256d threshold = _mm256_set1_pd(spikeThreshold);
+    for (; i + 4 <= end; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(&v[i]), threshold, _CMP_GE_OQ));
+        if (mask) {
+            /// Spikes are rare, fired lanes are handled one by one
+            resetFiredNeuronsScalar(neurons, i, i + 4, spikes, fired);
+        }
+    }
+#endif
+    resetFiredNeuronsScalar(neurons, i, end, spikes, fired);
+}
+
+template <>
+void resetFiredNeurons<float>(NeuronArrays<float> &neurons, size_t begin, size_t end, uint8_t *spikes, std::vector<uint32_t> &fired)
+{
+    size_t i = begin;
+#ifdef __AVX2__
+    float *v = neurons.v.data();
+    const __m256 threshold = _mm256_set1_ps((float)spikeThreshold);
+    for (; i + 8 <= end; i += 8) {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(&v[i]), threshold, _CMP_GE_OQ));
+        if (mask) {
+            /// Spikes are rare, fired lanes are handled one by one
+            resetFiredNeuronsScalar(neurons, i, i + 8, spikes, fired);
+        }
+    }
+#endif
+    resetFiredNeuronsScalar(neurons, i, end, spikes, fired);
+}
+
+template <>
+void updateNeurons<double>(NeuronArrays<double> &neurons, size_t begin, size_t end)
+{
+    size_t i = begin;
+#ifdef __AVX2__
+    double *v = neurons.v.data();
+    double *u = neurons.u.data();
+    const double *a = neurons.a.data();
+    const double *b = neurons.b.data();
+    const double *c = neurons.c.data();
+    const double *current = neurons.current.data();
+
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d quadratic = _mm256_set1_pd(0.04);
+    const __m256d linear = _mm256_set1_pd(5);
+    const __m256d constant = _mm256_set1_pd(140);
+
+    for (; i + 4 <= end; i += 4) {
+        __m256d vi = _mm256_loadu_pd(&v[i]);
+        __m256d ui = _mm256_loadu_pd(&u[i]);
+        __m256d input = _mm256_loadu_pd(&current[i]);
+
+        for (int halfStep = 0; halfStep < 2; halfStep++) {
+            __m256d dv = _mm256_add_pd(_mm256_mul_pd(quadratic, _mm256_mul_pd(vi, vi)), _mm256_mul_pd(linear, vi));
+            dv = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(dv, constant), ui), input);
+            vi = _mm256_add_pd(vi, _mm256_mul_pd(half, dv));
+        }
+
+        ui = _mm256_add_pd(ui, _mm256_mul_pd(_mm256_loadu_pd(&a[i]), _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(&b[i]), vi), ui)));
+        _mm256_storeu_pd(&u[i], ui);
+
+        /// Avoid nans
+        __m256d isNan = _mm256_cmp_pd(vi, vi, _CMP_UNORD_Q);
+        _mm256_storeu_pd(&v[i], _mm256_blendv_pd(vi, _mm256_loadu_pd(&c[i]), isNan));
+    }
+#endif
+    updateNeuronsScalar(neurons, i, end);
+}
+
+template <>
+void updateNeurons<float>(NeuronArrays<float> &neurons, size_t begin, size_t end)
+{
+    size_t i = begin;
+#ifdef __AVX2__
+    float *v = neurons.v.data();
+    float *u = neurons.u.data();
+    const float *a = neurons.a.data();
+    const float *b = neurons.b.data();
+    const float *c = neurons.c.data();
+    const float *current = neurons.current.data();
+
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 quadratic = _mm256_set1_ps(0.04f);
+    const __m256 linear = _mm256_set1_ps(5.0f);
+    const __m256 constant = _mm256_set1_ps(140.0f);
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 vi = _mm256_loadu_ps(&v[i]);
+        __m256 ui = _mm256_loadu_ps(&u[i]);
+        __m256 input = _mm256_loadu_ps(&current[i]);
+
+        for (int halfStep = 0; halfStep < 2; halfStep++) {
+            __m256 dv = _mm256_add_ps(_mm256_mul_ps(quadratic, _mm256_mul_ps(vi, vi)), _mm256_mul_ps(linear, vi));
+            dv = _mm256_add_ps(_mm256_sub_ps(_mm256_add_ps(dv, constant), ui), input);
+            vi = _mm256_add_ps(vi, _mm256_mul_ps(half, dv));
+        }
+
+        ui = _mm256_add_ps(ui, _mm256_mul_ps(_mm256_loadu_ps(&a[i]), _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(&b[i]), vi), ui)));
+        _mm256_storeu_ps(&u[i], ui);
+
+        /// Avoid nans
+        __m256 isNan = _mm256_cmp_ps(vi, vi, _CMP_UNORD_Q);
+        _mm256_storeu_ps(&v[i], _mm256_blendv_ps(vi, _mm256_loadu_ps(&c[i]), isNan));
+    }
+#endif
+    updateNeuronsScalar(neurons, i, end);
+}
+
+const char *neuronKernelsInstructionSet()
+{
+#ifdef __AVX2__
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,131 @@
+//
+//  NeuronKernels.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef NeuronKernels_h
+#define NeuronKernels_h
+
+#include <vector>
+#include <new>
+#include <cstdlib>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+/// Alignment of neuron arrays in bytes, one cache line, enough for AVX-512 loads.
+const static size_t simdAlignment = 64;
+
+/// Number of neurons which fit in `simdAlignment` bytes of floats. Partitions start at multiples of it.
+const static size_t simdNeuronBlock = simdAlignment / sizeof(float);
+
+/// Allocator which aligns arrays to `simdAlignment`.
+template <typename T>
+struct AlignedAllocator {
+
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U> AlignedAllocator(const AlignedAllocator<U> &) {}
+
+    T *allocate(size_t numberOfElements)
+    {
+        void *memory = NULL;
+#ifdef _WIN32
+        memory = _aligned_malloc(numberOfElements * sizeof(T), simdAlignment);
+#else
+        if (posix_memalign(&memory, simdAlignment, numberOfElements * sizeof(T))) { memory = NULL; }
+#endif
+        if (!memory) { throw std::bad_alloc(); }
+        return (T *)memory;
+    }
+
+    void deallocate(T *memory, size_t)
+    {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U> &) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U> &) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/// Neuron state, parameters and synaptic weights in one precision, stored as structure of arrays.
+template <typename Real>
+struct NeuronArrays {
+
+    /// Izhikevich parameters
+    AlignedVector<Real> a;
+    AlignedVector<Real> b;
+    AlignedVector<Real> c;
+    AlignedVector<Real> d;
+
+    /// Membrane potential and recovery variable
+    AlignedVector<Real> v;
+    AlignedVector<Real> u;
+
+    /// Total and synaptic input current of the current ms
+    AlignedVector<Real> current;
+    AlignedVector<Real> synapticCurrent;
+
+    /// Synaptic weights in CSR order of `BrainSimulation`
+    AlignedVector<Real> weights;
+
+    /// Resizes neuron arrays, weights are left as they are.
+    void resize(size_t numberOfNeurons)
+    {
+        a.resize(numberOfNeurons);
+        b.resize(numberOfNeurons);
+        c.resize(numberOfNeurons);
+        d.resize(numberOfNeurons);
+        v.resize(numberOfNeurons);
+        u.resize(numberOfNeurons);
+        current.resize(numberOfNeurons);
+        synapticCurrent.resize(numberOfNeurons);
+    }
+
+    /// Frees all memory.
+    void clear()
+    {
+        AlignedVector<Real>().swap(a);
+        AlignedVector<Real>().swap(b);
+        AlignedVector<Real>().swap(c);
+        AlignedVector<Real>().swap(d);
+        AlignedVector<Real>().swap(v);
+        AlignedVector<Real>().swap(u);
+        AlignedVector<Real>().swap(current);
+        AlignedVector<Real>().swap(synapticCurrent);
+        AlignedVector<Real>().swap(weights);
+    }
+};
+
+/// Finds neurons with `v >= 30` in `begin` ..< `end`, resets their v to c and adjusts u by d.
+/// @param neurons Neurons
+/// @param begin First neuron
+/// @param end One past last neuron
+/// @param spikes Spikes of current ms, 1 is written for every fired neuron
+/// @param fired Indices of fired neurons are appended in ascending order
+template <typename Real>
+void resetFiredNeurons(NeuronArrays<Real> &neurons, size_t begin, size_t end, uint8_t *spikes, std::vector<uint32_t> &fired);
+
+/// Updates v in two half steps, then u, and resets nan v to c, for neurons `begin` ..< `end`.
+/// @param neurons Neurons, `current` has to hold total input current
+/// @param begin First neuron
+/// @param end One past last neuron
+template <typename Real>
+void updateNeurons(NeuronArrays<Real> &neurons, size_t begin, size_t end);
+
+/// Instruction set used by kernels, depends on compiler flags.
+const char *neuronKernelsInstructionSet();
+
+#endif /* NeuronKernels_h */
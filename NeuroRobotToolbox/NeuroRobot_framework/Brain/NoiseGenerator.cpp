@@ -0,0 +1,237 @@
+//
+//  NoiseGenerator.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "NoiseGenerator.h"
+
+#include <cmath>
+#include <algorithm>
+
+/// Philox4x32 multipliers and key increments (Salmon et al., Random123).
+const static uint32_t philoxMultiplier0 = 0xD2511F53;
+const static uint32_t philoxMultiplier1 = 0xCD9E8D57;
+const static uint32_t philoxWeyl0 = 0x9E3779B9;
+const static uint32_t philoxWeyl1 = 0xBB67AE85;
+const static int philoxRounds = 10;
+
+/// Number of normal values made from one Philox block.
+const static size_t valuesPerBlock = 4;
+
+/// Number of Philox blocks generated side by side, independent rounds of several blocks keep pipeline (or SIMD lanes) busy.
+const static size_t blocksPerBatch = 8;
+
+/// Marks counter of the stream used by rare slow path of Ziggurat, main stream never sets this bit.
+const static uint32_t slowStreamFlag = 0x80000000;
+
+/// 2^-32, maps 32 bit integer to [0, 1).
+const static double uniformScale = 1.0 / 4294967296.0;
+
+/// Tables of Ziggurat method for normal distribution with 128 layers (Marsaglia and Tsang, 2000).
+struct ZigguratTables {
+
+    uint32_t kn[128];
+    double wn[128];
+    double fn[128];
+
+    ZigguratTables()
+    {
+        const double m1 = 2147483648.0;
+        const double vn = 9.91256303526217e-3;
+        double dn = 3.442619855899;
+        double tn = dn;
+        double q = vn / std::exp(-0.5 * dn * dn);
+
+        kn[0] = (uint32_t)((dn / q) * m1);
+        kn[1] = 0;
+        wn[0] = q / m1;
+        wn[127] = dn / m1;
+        fn[0] = 1.0;
+        fn[127] = std::exp(-0.5 * dn * dn);
+
+        for (int i = 126; i >= 1; i--) {
+            dn = std::sqrt(-2.0 * std::log(vn / dn + std::exp(-0.5 * dn * dn)));
+            kn[i + 1] = (uint32_t)((dn / tn) * m1);
+            tn = dn;
+            fn[i] = std::exp(-0.5 * dn * dn);
+            wn[i] = dn / m1;
+        }
+    }
+};
+
+static const ZigguratTables &zigguratTables()
+{
+    static const ZigguratTables tables;
+    return tables;
+}
+
+/// Random numbers for slow path of one value, drawn from their own counter so the main stream stays aligned to neurons.
+class SlowStream {
+
+private:
+
+    uint32_t counter[4];
+    const uint32_t *key;
+    uint32_t words[4];
+    int used = 4;
+    uint32_t attempt = 0;
+
+public:
+
+    SlowStream(const uint32_t *key_, uint32_t block, uint32_t lane, uint64_t ms)
+    : key(key_)
+    {
+        counter[0] = block;
+        counter[1] = slowStreamFlag | (lane << 24);
+        counter[2] = (uint32_t)ms;
+        counter[3] = (uint32_t)(ms >> 32);
+    }
+
+    uint32_t next()
+    {
+        if (used == 4) {
+            std::copy(counter, counter + 4, words);
+            words[1] |= attempt++;
+            NoiseGenerator::philox(words, key);
+            used = 0;
+        }
+        return words[used++];
+    }
+
+    /// Uniform in (0, 1).
+    double uniform()
+    {
+        return ((double)next() + 0.5) * uniformScale;
+    }
+};
+
+/// Standard normal value from one 32 bit word, `RNOR` of Ziggurat method.
+static inline double zigguratNormal(const ZigguratTables &tables, uint32_t word, const uint32_t *key, uint32_t block, uint32_t lane, uint64_t ms)
+{
+    int32_t hz = (int32_t)word;
+    uint32_t iz = word & 127;
+    if ((uint32_t)(hz < 0 ? -(int64_t)hz : hz) < tables.kn[iz]) {
+        return hz * tables.wn[iz];
+    }
+
+    /// Slow path, about 1 % of values
+    const double r = 3.442620;
+    SlowStream stream(key, block, lane, ms);
+    for (;;) {
+        double x = hz * tables.wn[iz];
+        if (iz == 0) {
+            double y;
+            do {
+                x = -std::log(stream.uniform()) * 0.2904764;
+                y = -std::log(stream.uniform());
+            } while (y + y < x * x);
+            return hz > 0 ? r + x : -r - x;
+        }
+        if (tables.fn[iz] + stream.uniform() * (tables.fn[iz - 1] - tables.fn[iz]) < std::exp(-0.5 * x * x)) {
+            return x;
+        }
+
+        word = stream.next();
+        hz = (int32_t)word;
+        iz = word & 127;
+        if ((uint32_t)(hz < 0 ? -(int64_t)hz : hz) < tables.kn[iz]) {
+            return hz * tables.wn[iz];
+        }
+    }
+}
+
+NoiseGenerator::NoiseGenerator(uint64_t seed_)
+: seed(seed_)
+{
+}
+
+void NoiseGenerator::setSeed(uint64_t seed_)
+{
+    seed = seed_;
+}
+
+uint64_t NoiseGenerator::getSeed()
+{
+    return seed;
+}
+
+void NoiseGenerator::philox(uint32_t counter[4], const uint32_t key_[2])
+{
+    uint32_t key[2] = { key_[0], key_[1] };
+
+    for (int round = 0; round < philoxRounds; round++) {
+        uint64_t product0 = (uint64_t)philoxMultiplier0 * counter[0];
+        uint64_t product1 = (uint64_t)philoxMultiplier1 * counter[2];
+
+        uint32_t next0 = (uint32_t)(product1 >> 32) ^ counter[1] ^ key[0];
+        uint32_t next1 = (uint32_t)product1;
+        uint32_t next2 = (uint32_t)(product0 >> 32) ^ counter[3] ^ key[1];
+        uint32_t next3 = (uint32_t)product0;
+
+        counter[0] = next0;
+        counter[1] = next1;
+        counter[2] = next2;
+        counter[3] = next3;
+
+        key[0] += philoxWeyl0;
+        key[1] += philoxWeyl1;
+    }
+}
+
+/// Philox4x32-10 of `blocksPerBatch` counters which differ only in first word, `first + 0` ..< `first + blocksPerBatch`.
+/// @param words Output, word `w` of block `i` is `words[w][i]`
+static void philoxBatch(uint32_t words[4][blocksPerBatch], uint32_t first, uint64_t ms, const uint32_t key_[2])
+{
+    uint32_t key[2] = { key_[0], key_[1] };
+
+    for (size_t i = 0; i < blocksPerBatch; i++) {
+        words[0][i] = first + (uint32_t)i;
+        words[1][i] = 0;
+        words[2][i] = (uint32_t)ms;
+        words[3][i] = (uint32_t)(ms >> 32);
+    }
+
+    for (int round = 0; round < philoxRounds; round++) {
+        for (size_t i = 0; i < blocksPerBatch; i++) {
+            uint64_t product0 = (uint64_t)philoxMultiplier0 * words[0][i];
+            uint64_t product1 = (uint64_t)philoxMultiplier1 * words[2][i];
+
+            words[0][i] = (uint32_t)(product1 >> 32) ^ words[1][i] ^ key[0];
+            words[1][i] = (uint32_t)product1;
+            words[2][i] = (uint32_t)(product0 >> 32) ^ words[3][i] ^ key[1];
+            words[3][i] = (uint32_t)product0;
+        }
+        key[0] += philoxWeyl0;
+        key[1] += philoxWeyl1;
+    }
+}
+
+template <typename Real>
+void NoiseGenerator::fill(Real *values, size_t begin, size_t end, uint64_t ms, Real amplitude)
+{
+    const uint32_t key[2] = { (uint32_t)seed, (uint32_t)(seed >> 32) };
+
+    const ZigguratTables &tables = zigguratTables();
+
+    /// Counter is (block of 4 neurons, ms), one block gives values of 4 neurons
+    uint32_t words[4][blocksPerBatch];
+    for (size_t batch = begin / valuesPerBlock / blocksPerBatch; batch * blocksPerBatch * valuesPerBlock < end; batch++) {
+        uint32_t firstBlock = (uint32_t)(batch * blocksPerBatch);
+        philoxBatch(words, firstBlock, ms, key);
+
+        for (uint32_t i = 0; i < blocksPerBatch; i++) {
+            size_t first = (size_t)(firstBlock + i) * valuesPerBlock;
+            for (uint32_t lane = 0; lane < valuesPerBlock; lane++) {
+                size_t neuron = first + lane;
+                if (neuron >= begin && neuron < end) {
+                    values[neuron] = amplitude * (Real)zigguratNormal(tables, words[lane][i], key, firstBlock + i, lane, ms);
+                }
+            }
+        }
+    }
+}
+
+template void NoiseGenerator::fill<double>(double *values, size_t begin, size_t end, uint64_t ms, double amplitude);
+template void NoiseGenerator::fill<float>(float *values, size_t begin, size_t end, uint64_t ms, float amplitude);
@@ -0,0 +1,51 @@
+//
+//  NoiseGenerator.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef NoiseGenerator_h
+#define NoiseGenerator_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Counter-based generator of normal noise current (Philox4x32-10 with Ziggurat).
+/// Value for neuron `i` at simulated ms `t` depends only on seed, `i` and `t`, so it does not depend on
+/// the order of generation or number of threads, and a run can be replayed from its seed.
+class NoiseGenerator {
+
+private:
+
+    uint64_t seed;
+
+public:
+
+    /// @param seed Seed, key of Philox
+    NoiseGenerator(uint64_t seed = 0);
+
+    /// Set seed.
+    /// @param seed Seed, key of Philox
+    void setSeed(uint64_t seed);
+
+    /// Seed, needed to replay a run.
+    uint64_t getSeed();
+
+    /// Fill `amplitude * randn` for neurons `begin` ..< `end` at simulated ms `ms`.
+    /// Supports up to 2^34 neurons.
+    /// @param values Output indexed by neuron, only `begin` ..< `end` are written
+    /// @param begin First neuron
+    /// @param end One past last neuron
+    /// @param ms Simulated ms since seed was set
+    /// @param amplitude Amplitude of noise
+    template <typename Real>
+    void fill(Real *values, size_t begin, size_t end, uint64_t ms, Real amplitude);
+
+    /// One Philox4x32-10 block.
+    /// @param counter Counter, replaced with random output
+    /// @param key Key
+    static void philox(uint32_t counter[4], const uint32_t key[2]);
+};
+
+#endif /* NoiseGenerator_h */
@@ -0,0 +1,310 @@
+//
+//  SpikeRecorder.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "SpikeRecorder.h"
+
+#include <cstring>
+
+const static char magic[8] = { 'N', 'R', 'S', 'P', 'I', 'K', 'E', '1' };
+
+/// Size of chunk header in file, begin ms | end ms | events | bytes
+const static size_t chunkHeaderSize = 24;
+
+static void writeVarint(std::vector<uint8_t> &bytes, uint64_t value)
+{
+    while (value >= 0x80) {
+        bytes.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back((uint8_t)value);
+}
+
+static bool readVarint(const uint8_t *&byte, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+    for (unsigned int shift = 0; byte < end && shift < 64; shift += 7) {
+        uint8_t current = *byte++;
+        value |= (uint64_t)(current & 0x7F) << shift;
+        if (!(current & 0x80)) { return true; }
+    }
+    return false;
+}
+
+/// Decodes events of chunk which are in window.
+static bool decodeChunk(uint64_t beginMs, const uint8_t *bytes, size_t numberOfBytes, uint32_t numberOfEvents, uint64_t fromMs, uint64_t toMs, std::vector<uint32_t> &neurons, std::vector<uint64_t> &times)
+{
+    const uint8_t *byte = bytes;
+    const uint8_t *end = bytes + numberOfBytes;
+    uint64_t ms = beginMs;
+    uint64_t neuron = 0;
+    for (uint32_t i = 0; i < numberOfEvents; i++) {
+        uint64_t msDelta, neuronDelta;
+        if (!readVarint(byte, end, msDelta) || !readVarint(byte, end, neuronDelta)) { return false; }
+        ms += msDelta;
+        neuron = msDelta ? neuronDelta : neuron + neuronDelta;
+        if (ms >= toMs) { break; }
+        if (ms >= fromMs) {
+            neurons.push_back((uint32_t)neuron);
+            times.push_back(ms);
+        }
+    }
+    return true;
+}
+
+SpikeRecorder::SpikeRecorder(uint64_t retentionMs_, size_t maxBytes_)
+: retentionMs(retentionMs_)
+, maxBytes(maxBytes_)
+{
+    encoder = std::thread(&SpikeRecorder::encoderLoop, this);
+}
+
+SpikeRecorder::~SpikeRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexPending);
+        stopping = true;
+    }
+    pendingCondition.notify_one();
+    encoder.join();
+
+    std::string error;
+    setFile("", error);
+}
+
+void SpikeRecorder::encoderLoop()
+{
+    std::unique_lock<std::mutex> lock(mutexPending);
+    while (true) {
+        pendingCondition.wait(lock, [this] { return stopping || !pendingSteps.empty(); });
+        /// Pending steps are encoded before stopping
+        if (pendingSteps.empty()) { return; }
+
+        PendingStep step = std::move(pendingSteps.front());
+        pendingSteps.pop_front();
+        encoding = true;
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> chunksLock(mutexChunks);
+            encode(step);
+        }
+
+        lock.lock();
+        freeSteps.push_back(std::move(step));
+        encoding = false;
+        if (pendingSteps.empty()) {
+            encodedCondition.notify_all();
+        }
+    }
+}
+
+void SpikeRecorder::encode(const PendingStep &step)
+{
+    const size_t msPerStep = step.msBegins.size() - 1;
+    for (size_t ms = 0; ms < msPerStep; ms++) {
+        const uint64_t time = step.beginMs + ms;
+        if (chunks.empty() || time >= chunks.back().endMs) {
+            if (!chunks.empty()) {
+                finishChunk();
+            }
+            Chunk chunk;
+            chunk.beginMs = time / chunkMs * chunkMs;
+            chunk.endMs = chunk.beginMs + chunkMs;
+            chunk.lastMs = chunk.beginMs;
+            chunks.push_back(std::move(chunk));
+        }
+
+        Chunk &chunk = chunks.back();
+        const size_t sizeBefore = chunk.bytes.size();
+        for (uint32_t i = step.msBegins[ms]; i < step.msBegins[ms + 1]; i++) {
+            const uint32_t neuron = step.neurons[i];
+            const uint64_t msDelta = time - chunk.lastMs;
+            writeVarint(chunk.bytes, msDelta);
+            writeVarint(chunk.bytes, msDelta ? neuron : neuron - chunk.lastNeuron);
+            chunk.lastMs = time;
+            chunk.lastNeuron = neuron;
+        }
+        chunk.numberOfEvents += step.msBegins[ms + 1] - step.msBegins[ms];
+        encodedBytes += chunk.bytes.size() - sizeBefore;
+    }
+}
+
+void SpikeRecorder::finishChunk()
+{
+    const Chunk &chunk = chunks.back();
+    if (file.is_open() && chunk.beginMs >= fileFromMs) {
+        writeChunk(chunk);
+    }
+
+    /// Chunk being finished is always kept
+    while (chunks.size() > 1 && (chunks.front().endMs + retentionMs <= chunk.endMs || encodedBytes > maxBytes)) {
+        encodedBytes -= chunks.front().bytes.size();
+        chunks.pop_front();
+    }
+}
+
+void SpikeRecorder::writeChunk(const Chunk &chunk)
+{
+    uint32_t numberOfBytes = (uint32_t)chunk.bytes.size();
+    file.write((const char *)&chunk.beginMs, sizeof(uint64_t));
+    file.write((const char *)&chunk.endMs, sizeof(uint64_t));
+    file.write((const char *)&chunk.numberOfEvents, sizeof(uint32_t));
+    file.write((const char *)&numberOfBytes, sizeof(uint32_t));
+    file.write((const char *)chunk.bytes.data(), chunk.bytes.size());
+}
+
+void SpikeRecorder::flush()
+{
+    std::unique_lock<std::mutex> lock(mutexPending);
+    encodedCondition.wait(lock, [this] { return pendingSteps.empty() && !encoding; });
+}
+
+void SpikeRecorder::setRetention(uint64_t retentionMs_, size_t maxBytes_)
+{
+    std::lock_guard<std::mutex> lock(mutexChunks);
+    retentionMs = retentionMs_;
+    maxBytes = maxBytes_;
+}
+
+bool SpikeRecorder::setFile(const std::string &path, std::string &error)
+{
+    flush();
+    std::lock_guard<std::mutex> lock(mutexChunks);
+
+    /// Old file gets chunk recorded so far, new file starts with next chunk
+    if (file.is_open()) {
+        if (!chunks.empty() && chunks.back().beginMs >= fileFromMs) {
+            writeChunk(chunks.back());
+        }
+        file.close();
+    }
+    fileFromMs = chunks.empty() ? 0 : chunks.back().endMs;
+    if (path.empty()) { return true; }
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot create " + path;
+        return false;
+    }
+    file.write(magic, sizeof(magic));
+    return true;
+}
+
+void SpikeRecorder::record(const uint8_t *spikes, size_t numberOfNeurons, unsigned int msPerStep)
+{
+    PendingStep step;
+    {
+        std::lock_guard<std::mutex> lock(mutexPending);
+        if (!freeSteps.empty()) {
+            step = std::move(freeSteps.back());
+            freeSteps.pop_back();
+        }
+        step.beginMs = recordedMs;
+        recordedMs += msPerStep;
+    }
+
+    /// Spikes are rare, 8 neurons are checked at once
+    step.msBegins.clear();
+    step.neurons.clear();
+    for (unsigned int ms = 0; ms < msPerStep; ms++) {
+        step.msBegins.push_back((uint32_t)step.neurons.size());
+        const uint8_t *spikesNow = spikes + ms * numberOfNeurons;
+        size_t i = 0;
+        for (; i + 8 <= numberOfNeurons; i += 8) {
+            uint64_t block;
+            memcpy(&block, spikesNow + i, sizeof(uint64_t));
+            if (!block) { continue; }
+            for (size_t j = i; j < i + 8; j++) {
+                if (spikesNow[j]) { step.neurons.push_back((uint32_t)j); }
+            }
+        }
+        for (; i < numberOfNeurons; i++) {
+            if (spikesNow[i]) { step.neurons.push_back((uint32_t)i); }
+        }
+    }
+    step.msBegins.push_back((uint32_t)step.neurons.size());
+
+    {
+        std::lock_guard<std::mutex> lock(mutexPending);
+        pendingSteps.push_back(std::move(step));
+    }
+    pendingCondition.notify_one();
+}
+
+void SpikeRecorder::window(uint64_t fromMs, uint64_t toMs, std::vector<uint32_t> &neurons, std::vector<uint64_t> &times)
+{
+    neurons.clear();
+    times.clear();
+    flush();
+
+    std::lock_guard<std::mutex> lock(mutexChunks);
+    for (const Chunk &chunk : chunks) {
+        if (chunk.endMs <= fromMs || chunk.beginMs >= toMs) { continue; }
+        decodeChunk(chunk.beginMs, chunk.bytes.data(), chunk.bytes.size(), chunk.numberOfEvents, fromMs, toMs, neurons, times);
+    }
+}
+
+uint64_t SpikeRecorder::now()
+{
+    std::lock_guard<std::mutex> lock(mutexPending);
+    return recordedMs;
+}
+
+size_t SpikeRecorder::memoryUsage()
+{
+    flush();
+    std::lock_guard<std::mutex> lock(mutexChunks);
+    return encodedBytes;
+}
+
+void SpikeRecorder::clear()
+{
+    flush();
+    std::lock_guard<std::mutex> lock(mutexChunks);
+
+    /// File keeps spikes recorded so far, later spikes go to new chunks with later ms
+    if (file.is_open() && !chunks.empty() && chunks.back().beginMs >= fileFromMs) {
+        writeChunk(chunks.back());
+    }
+    chunks.clear();
+    encodedBytes = 0;
+}
+
+bool SpikeRecorder::readFile(const std::string &path, uint64_t fromMs, uint64_t toMs, std::vector<uint32_t> &neurons, std::vector<uint64_t> &times, std::string &error)
+{
+    neurons.clear();
+    times.clear();
+
+    std::ifstream input(path, std::ios::binary);
+    char header[sizeof(magic)];
+    if (!input.read(header, sizeof(header)) || memcmp(header, magic, sizeof(magic))) {
+        error = "Cannot read spikes from " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunkHeader[chunkHeaderSize];
+    while (input.read((char *)chunkHeader, chunkHeaderSize)) {
+        uint64_t beginMs, endMs;
+        uint32_t numberOfEvents, numberOfBytes;
+        memcpy(&beginMs, chunkHeader, sizeof(uint64_t));
+        memcpy(&endMs, chunkHeader + 8, sizeof(uint64_t));
+        memcpy(&numberOfEvents, chunkHeader + 16, sizeof(uint32_t));
+        memcpy(&numberOfBytes, chunkHeader + 20, sizeof(uint32_t));
+
+        if (endMs <= fromMs || beginMs >= toMs) {
+            input.seekg(numberOfBytes, std::ios::cur);
+            continue;
+        }
+        bytes.resize(numberOfBytes);
+        if (!input.read((char *)bytes.data(), numberOfBytes) || !decodeChunk(beginMs, bytes.data(), bytes.size(), numberOfEvents, fromMs, toMs, neurons, times)) {
+            error = "Spikes in " + path + " are damaged.";
+            return false;
+        }
+    }
+    return true;
+}
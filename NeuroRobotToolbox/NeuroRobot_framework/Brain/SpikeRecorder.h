@@ -0,0 +1,143 @@
+//
+//  SpikeRecorder.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SpikeRecorder_h
+#define SpikeRecorder_h
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Records spikes of brain steps as compressed events (neuron, ms), instead of keeping `spikes_loop` of every step.
+///
+/// Steps are handed over as lists of spiking neurons and encoded on background thread into chunks of `chunkMs` ms.
+/// Every event is two varints: ms since previous event, and neuron, as difference to previous neuron of the same ms.
+/// Chunks older than retention time are dropped from memory, so memory does not grow with run time.
+/// Finished chunks can also be appended to file, which keeps whole run (`SpikeRecorder::readFile()`).
+///
+/// File layout, little-endian: "NRSPIKE1" | chunks, chunk: uint64 begin ms | uint64 end ms | uint32 events | uint32 bytes | events
+class SpikeRecorder {
+
+public:
+
+    /// Milliseconds covered by one chunk.
+    const static uint64_t chunkMs = 1000;
+
+private:
+
+    struct Chunk {
+        uint64_t beginMs;
+        uint64_t endMs;
+        uint32_t numberOfEvents = 0;
+        /// Last event, start of next delta
+        uint64_t lastMs;
+        uint32_t lastNeuron = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    /// Spiking neurons of one step, waiting for encoding
+    struct PendingStep {
+        uint64_t beginMs;
+        /// Index of first neuron of every ms in `neurons`, `msPerStep + 1` values
+        std::vector<uint32_t> msBegins;
+        std::vector<uint32_t> neurons;
+    };
+
+    /// Encoded chunks, last one is being filled
+    std::deque<Chunk> chunks;
+    size_t encodedBytes = 0;
+
+    std::deque<PendingStep> pendingSteps;
+    /// Steps of which vectors are reused
+    std::vector<PendingStep> freeSteps;
+
+    /// Ms of next step
+    uint64_t recordedMs = 0;
+    uint64_t retentionMs;
+    size_t maxBytes;
+
+    std::ofstream file;
+    /// Chunks which begin earlier were written to previous file
+    uint64_t fileFromMs = 0;
+
+    /// Sync mechanism, `mutexPending` guards pending and free steps, `mutexChunks` guards chunks and file
+    std::mutex mutexPending;
+    std::mutex mutexChunks;
+    std::condition_variable pendingCondition;
+    std::condition_variable encodedCondition;
+    bool encoding = false;
+    bool stopping = false;
+
+    std::thread encoder;
+
+    /// Encoder thread method. Encodes pending steps until recorder is destroyed.
+    void encoderLoop();
+
+    /// Appends events of step to chunks.
+    void encode(const PendingStep &step);
+
+    /// Writes chunk to file and drops chunks which are out of retention.
+    void finishChunk();
+
+    /// Appends chunk to file.
+    void writeChunk(const Chunk &chunk);
+
+    /// Waits until all recorded steps are encoded.
+    void flush();
+
+public:
+
+    /// @param retentionMs Ms of spikes kept in memory
+    /// @param maxBytes Upper bound of encoded spikes in memory, older chunks are dropped first
+    SpikeRecorder(uint64_t retentionMs = 600000, size_t maxBytes = 64 << 20);
+    ~SpikeRecorder();
+    SpikeRecorder(const SpikeRecorder &) = delete;
+    SpikeRecorder &operator=(const SpikeRecorder &) = delete;
+
+    /// Sets how long spikes are kept in memory.
+    void setRetention(uint64_t retentionMs, size_t maxBytes);
+
+    /// Starts appending finished chunks to file, empty path stops it.
+    /// @param path Path of log file, replaced if it exists
+    /// @param error Reason when file cannot be created
+    /// @return True on success
+    bool setFile(const std::string &path, std::string &error);
+
+    /// Hands over spikes of step, returns without waiting for encoding.
+    /// @param spikes Column-major `numberOfNeurons` x `msPerStep` array, nonzero for spike
+    /// @param numberOfNeurons Number of neurons
+    /// @param msPerStep Ms of step
+    void record(const uint8_t *spikes, size_t numberOfNeurons, unsigned int msPerStep);
+
+    /// Spikes of ms from `fromMs` to `toMs` (not included), ordered by time and neuron.
+    /// @param fromMs First ms, ms are counted from first recorded step
+    /// @param toMs Ms after last one
+    /// @param neurons Neuron of every spike, from 0
+    /// @param times Ms of every spike
+    void window(uint64_t fromMs, uint64_t toMs, std::vector<uint32_t> &neurons, std::vector<uint64_t> &times);
+
+    /// Number of recorded ms, ms of next step.
+    uint64_t now();
+
+    /// Bytes of encoded spikes in memory.
+    size_t memoryUsage();
+
+    /// Removes spikes from memory, e.g. when neurons change. Ms keep counting and file keeps recorded chunks.
+    void clear();
+
+    /// Reads spikes of ms from `fromMs` to `toMs` (not included) from log file.
+    /// @return True on success
+    static bool readFile(const std::string &path, uint64_t fromMs, uint64_t toMs, std::vector<uint32_t> &neurons, std::vector<uint64_t> &times, std::string &error);
+};
+
+#endif /* SpikeRecorder_h */
@@ -0,0 +1,158 @@
+//
+//  SynapticPlasticity.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Expressions keep the operation order of `update_brain.m`, so weights stay equal to MATLAB.
+//
+
+#include "SynapticPlasticity.h"
+
+#include <cmath>
+#include <algorithm>
+
+/// `sigmoid(x, 100, 0.02)` of `sigmoid.m`.
+static inline double learningSigmoid(double x)
+{
+    return 1.0 / (1.0 + std::exp(-0.02 * (x - 100)));
+}
+
+void SynapticPlasticity::set(size_t numberOfNeurons, const double *daConnectome)
+{
+    const size_t n = numberOfNeurons;
+    const size_t pageSize = n * n;
+
+    clear();
+
+    for (size_t post = 0; post < n; post++) {
+        for (size_t pre = 0; pre < n; pre++) {
+            size_t index = post * n + pre;
+            if (daConnectome[index] == 0) { continue; }
+
+            presynapticNeurons.push_back((uint32_t)pre);
+            postsynapticNeurons.push_back((uint32_t)post);
+            plasticity.push_back(daConnectome[index]);
+            originalWeights.push_back(daConnectome[pageSize + index]);
+            intensities.push_back(daConnectome[2 * pageSize + index]);
+            weights.push_back(0);
+        }
+    }
+}
+
+void SynapticPlasticity::setSparse(size_t numberOfNeurons, const size_t *columnPointers, const size_t *rowIndices, const double *values)
+{
+    const size_t n = numberOfNeurons;
+
+    clear();
+
+    /// Value of page 2 or 3 at row `pre`, rows of column increase so search continues where previous one stopped
+    auto pageValue = [&](size_t &i, size_t end, size_t pre) {
+        while (i < end && rowIndices[i] < pre) { i++; }
+        return i < end && rowIndices[i] == pre ? values[i] : 0;
+    };
+
+    for (size_t post = 0; post < n; post++) {
+        size_t originalWeight = columnPointers[n + post];
+        size_t intensity = columnPointers[2 * n + post];
+        for (size_t i = columnPointers[post]; i < columnPointers[post + 1]; i++) {
+            if (values[i] == 0) { continue; }
+
+            const size_t pre = rowIndices[i];
+            presynapticNeurons.push_back((uint32_t)pre);
+            postsynapticNeurons.push_back((uint32_t)post);
+            plasticity.push_back(values[i]);
+            originalWeights.push_back(pageValue(originalWeight, columnPointers[n + post + 1], pre));
+            intensities.push_back(pageValue(intensity, columnPointers[2 * n + post + 1], pre));
+            weights.push_back(0);
+        }
+    }
+}
+
+void SynapticPlasticity::clear()
+{
+    presynapticNeurons.clear();
+    postsynapticNeurons.clear();
+    plasticity.clear();
+    originalWeights.clear();
+    intensities.clear();
+    weights.clear();
+}
+
+size_t SynapticPlasticity::size()
+{
+    return weights.size();
+}
+
+uint32_t SynapticPlasticity::presynapticNeuron(size_t synapse)
+{
+    return presynapticNeurons[synapse];
+}
+
+uint32_t SynapticPlasticity::postsynapticNeuron(size_t synapse)
+{
+    return postsynapticNeurons[synapse];
+}
+
+void SynapticPlasticity::setWeight(size_t synapse, double weight)
+{
+    weights[synapse] = weight;
+}
+
+const std::vector<double> &SynapticPlasticity::getWeights()
+{
+    return weights;
+}
+
+const std::vector<double> &SynapticPlasticity::getIntensities()
+{
+    return intensities;
+}
+
+void SynapticPlasticity::learn(const uint8_t *firing, const double *stepsSinceLastSpike, double reward, const Parameters &parameters, std::vector<Change> &changes)
+{
+    const double pulsePeriod = parameters.pulsePeriod;
+
+    /// Every plastic synapse depends only on its own state and its two neurons, so learning and forgetting are done in one pass
+    for (size_t i = 0; i < weights.size(); i++) {
+        const uint32_t pre = presynapticNeurons[i];
+        const uint32_t post = postsynapticNeurons[i];
+        const double previousWeight = weights[i];
+        double weight = previousWeight;
+        ChangeCause cause = ChangeCauseReinforcement;
+        bool changed = false;
+
+        /// Learning, synapses from recently active neurons to firing neuron, `nan` steps mean neuron never spiked
+        bool plastic = reward ? plasticity[i] > 0 : plasticity[i] == 1;
+        if (firing[post] && weight > 0 && stepsSinceLastSpike[pre] < parameters.ltpRecencyThreshold && plastic) {
+            intensities[i] = intensities[i] + 1;
+            double reinforcement = pulsePeriod * learningSigmoid(intensities[i]) * 5 + (reward * 2 * pulsePeriod);
+            weight = weight + std::round(reinforcement * 100) / 100;
+            changed = true;
+        }
+
+        weight = std::min(weight, parameters.maxWeight);
+        intensities[i] = std::max(intensities[i] - 0.5, 0.0);
+
+        /// Forgetting
+        double reinforcement = weight - originalWeights[i];
+        if (reinforcement) {
+            double lossDelay = stepsSinceLastSpike[pre] - parameters.ltpRecencyThreshold;
+            if (lossDelay < 0) { lossDelay = 0; }
+
+            /// `fmin` ignores nan like MATLAB `min`
+            double loss = std::floor(parameters.permanentMemoryThreshold / reinforcement) * pulsePeriod * 0.1 * std::fmin(lossDelay / ((1 / pulsePeriod) * 10), 1);
+            loss = std::min(loss, reinforcement);
+            weight = weight - loss;
+            if (loss) {
+                cause = ChangeCauseForgetting;
+                changed = true;
+            }
+        }
+
+        weights[i] = weight;
+        if (changed && std::round(weight) != std::round(previousWeight)) {
+            changes.push_back({ pre, post, weight, cause });
+        }
+    }
+}
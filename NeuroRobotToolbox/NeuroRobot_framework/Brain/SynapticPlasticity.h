@@ -0,0 +1,108 @@
+//
+//  SynapticPlasticity.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef SynapticPlasticity_h
+#define SynapticPlasticity_h
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Native port of learning (reward-modulated STDP) and forgetting of `update_brain.m`.
+/// Only plastic synapses, nonzero `da_connectome(:, :, 1)`, are stored and updated.
+/// Plastic synapses are ordered by column-major index in `nneurons` x `nneurons` matrix.
+class SynapticPlasticity {
+
+public:
+
+    /// Constants of learning, taken from `neurorobot.m`.
+    struct Parameters {
+        /// `pulse_period`, seconds per brain step
+        double pulsePeriod;
+        /// `ltp_recency_th_in_steps`, presynaptic neuron must have spiked fewer steps ago to be reinforced
+        double ltpRecencyThreshold;
+        /// `permanent_memory_th`, reinforcement above which synapse forgets slower
+        double permanentMemoryThreshold;
+        /// `max_w`, maximal weight
+        double maxWeight;
+    };
+
+    /// What changed weight of synapse last.
+    typedef enum {
+        ChangeCauseReinforcement = 1,
+        ChangeCauseForgetting = 2
+    } ChangeCause;
+
+    /// Synapse which rounded weight changed.
+    struct Change {
+        uint32_t presynapticNeuron;
+        uint32_t postsynapticNeuron;
+        double weight;
+        ChangeCause cause;
+    };
+
+private:
+
+    /// Plastic synapses as structure of arrays
+    std::vector<uint32_t> presynapticNeurons;
+    std::vector<uint32_t> postsynapticNeurons;
+    /// `da_connectome(:, :, 1)`, 1 learns always, other values only with reward
+    std::vector<double> plasticity;
+    /// `da_connectome(:, :, 2)`, weight to which synapse returns when forgetting
+    std::vector<double> originalWeights;
+    /// `da_connectome(:, :, 3)`, learning intensity
+    std::vector<double> intensities;
+    /// Current weights, `connectome` values
+    std::vector<double> weights;
+
+public:
+
+    /// Set plastic synapses from dense `da_connectome`, weights are zero until set with `setWeight()`.
+    /// @param numberOfNeurons Number of neurons
+    /// @param daConnectome Column-major `numberOfNeurons` x `numberOfNeurons` x 3 array, `da_connectome`
+    void set(size_t numberOfNeurons, const double *daConnectome);
+
+    /// Set plastic synapses from sparse `da_connectome`, weights are zero until set with `setWeight()`.
+    /// @param numberOfNeurons Number of neurons
+    /// @param columnPointers CSC column pointers of `numberOfNeurons` x `numberOfNeurons * 3` matrix, pages one after another
+    /// @param rowIndices Row indices, increasing in every column
+    /// @param values Nonzero values
+    void setSparse(size_t numberOfNeurons, const size_t *columnPointers, const size_t *rowIndices, const double *values);
+
+    /// Remove all plastic synapses.
+    void clear();
+
+    /// Number of plastic synapses.
+    size_t size();
+
+    /// Presynaptic neuron of plastic synapse.
+    uint32_t presynapticNeuron(size_t synapse);
+
+    /// Postsynaptic neuron of plastic synapse.
+    uint32_t postsynapticNeuron(size_t synapse);
+
+    /// Set weight of plastic synapse.
+    void setWeight(size_t synapse, double weight);
+
+    /// Weights of plastic synapses.
+    const std::vector<double> &getWeights();
+
+    /// Learning intensities of plastic synapses, `da_connectome(:, :, 3)`.
+    const std::vector<double> &getIntensities();
+
+    /// One brain step of learning and forgetting, same as `update_brain.m` for plastic synapses:
+    /// reinforce synapses from recently active to firing neurons, clamp to max weight, decay intensity,
+    /// then move reinforced weights back towards original weights.
+    /// @param firing Per neuron, nonzero if neuron fired in this step
+    /// @param stepsSinceLastSpike Per neuron, `steps_since_last_spike` after update for this step, may be nan
+    /// @param reward Reward of this step
+    /// @param parameters Constants of learning
+    /// @param changes Synapses which rounded weight changed are appended
+    void learn(const uint8_t *firing, const double *stepsSinceLastSpike, double reward, const Parameters &parameters, std::vector<Change> &changes);
+};
+
+#endif /* SynapticPlasticity_h */
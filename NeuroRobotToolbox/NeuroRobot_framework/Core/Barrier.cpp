@@ -0,0 +1,39 @@
+//
+//  Barrier.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "Barrier.h"
+
+/// Number of checks before waiting thread blocks.
+const static unsigned int spinIterations = 20000;
+
+Barrier::Barrier(unsigned int numberOfThreads_)
+: numberOfThreads(numberOfThreads_)
+, generation(0)
+{
+}
+
+void Barrier::wait()
+{
+    std::unique_lock<std::mutex> lock(mutexBarrier);
+    unsigned int arrivedGeneration = generation;
+    
+    if (++numberOfWaiting == numberOfThreads) {
+        numberOfWaiting = 0;
+        generation++;
+        lock.unlock();
+        barrierCondition.notify_all();
+        return;
+    }
+    lock.unlock();
+    
+    for (unsigned int i = 0; i < spinIterations; i++) {
+        if (generation != arrivedGeneration) { return; }
+    }
+    
+    lock.lock();
+    barrierCondition.wait(lock, [this, arrivedGeneration] { return generation != arrivedGeneration; });
+}
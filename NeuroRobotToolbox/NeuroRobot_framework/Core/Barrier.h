@@ -0,0 +1,40 @@
+//
+//  Barrier.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef Barrier_h
+#define Barrier_h
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// Reusable barrier for a fixed number of threads.
+/// Waiting threads spin for a short time before they block, because phases of the brain simulation are only a few microseconds long.
+class Barrier {
+    
+private:
+    
+    const unsigned int numberOfThreads;
+    unsigned int numberOfWaiting = 0;
+    
+    /// Incremented every time all threads arrive
+    std::atomic<unsigned int> generation;
+    
+    /// Sync mechanism
+    std::mutex mutexBarrier;
+    std::condition_variable barrierCondition;
+    
+public:
+    
+    /// @param numberOfThreads Number of threads which have to call `wait()` before any of them continues
+    Barrier(unsigned int numberOfThreads);
+    
+    /// Block current thread until all threads call `wait()`.
+    void wait();
+};
+
+#endif /* Barrier_h */
@@ -0,0 +1,130 @@
+//
+//  LatencyHistogram.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+/// Index of the highest set bit, `value` is not 0.
+static unsigned int highestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (unsigned int)index;
+#else
+    return 63 - (unsigned int)__builtin_clzll(value);
+#endif
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t us)
+{
+    if (us < linearBuckets) { return (size_t)us; }
+
+    /// Top `subBucketBits + 1` bits select bucket, the highest one is always set
+    const unsigned int bit = highestBit(us);
+    if (bit >= maxBits) { return numberOfBuckets - 1; }
+    const unsigned int shift = bit - subBucketBits;
+    return linearBuckets + (size_t)(bit - subBucketBits - 1) * subBuckets + (size_t)((us >> shift) & (subBuckets - 1));
+}
+
+uint64_t LatencyHistogram::highestValueOf(size_t bucket)
+{
+    if (bucket < linearBuckets) { return bucket; }
+    if (bucket == numberOfBuckets - 1) { return UINT64_MAX; }
+
+    const size_t group = (bucket - linearBuckets) / subBuckets;
+    const uint64_t subBucket = (bucket - linearBuckets) % subBuckets;
+    const unsigned int shift = (unsigned int)group + 1;
+    return ((subBuckets + subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us)
+{
+    buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    sumUs.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t max = maxUs.load(std::memory_order_relaxed);
+    while (us > max && !maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::recordSince(std::chrono::steady_clock::time_point begin)
+{
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    record(us > 0 ? (uint64_t)us : 0);
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint64_t> &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sumUs.store(0, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::copyCounts(uint64_t counts[numberOfBuckets]) const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < numberOfBuckets; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const
+{
+    uint64_t counts[numberOfBuckets];
+    const uint64_t total = copyCounts(counts);
+    const uint64_t max = maxUs.load(std::memory_order_relaxed);
+
+    const double target = std::min(std::max(percentile, 0.0), 100.0) / 100 * total;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < numberOfBuckets; i++) {
+        cumulative += counts[i];
+        if (counts[i] && cumulative >= target) {
+            return std::min(highestValueOf(i), max);
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    /// Counts are copied once, so all percentiles come from the same moment
+    Summary summary;
+    uint64_t counts[numberOfBuckets];
+    const uint64_t total = copyCounts(counts);
+    summary.count = total;
+    summary.maxUs = maxUs.load(std::memory_order_relaxed);
+    summary.meanUs = total ? (double)sumUs.load(std::memory_order_relaxed) / total : 0;
+
+    const double percentiles[4] = { 50, 90, 99, 99.9 };
+    uint64_t *results[4] = { &summary.p50Us, &summary.p90Us, &summary.p99Us, &summary.p999Us };
+    size_t next = 0;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < numberOfBuckets && next < 4; i++) {
+        cumulative += counts[i];
+        while (next < 4 && counts[i] && cumulative >= percentiles[next] / 100 * total) {
+            *results[next++] = std::min(highestValueOf(i), summary.maxUs);
+        }
+    }
+    while (next < 4) {
+        *results[next++] = summary.maxUs;
+    }
+    return summary;
+}
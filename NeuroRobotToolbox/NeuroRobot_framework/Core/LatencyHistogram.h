@@ -0,0 +1,87 @@
+//
+//  LatencyHistogram.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef LatencyHistogram_h
+#define LatencyHistogram_h
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Histogram of durations in us with fixed relative precision, like HdrHistogram.
+///
+/// Durations below `linearBuckets` us have own bucket, every following power of two is split into `subBuckets` buckets,
+/// so percentiles are within 1 / `subBuckets` (~3 %) of the real value, from 1 us to days. Memory is fixed.
+/// Recording is lock free (relaxed atomic increments), so workers record every event while other threads read.
+class LatencyHistogram {
+
+public:
+
+    /// Buckets of every power of two
+    const static unsigned int subBucketBits = 5;
+    const static unsigned int subBuckets = 1 << subBucketBits;
+
+    /// Durations below this have bucket per us
+    const static unsigned int linearBuckets = 2 * subBuckets;
+
+    /// Durations from 2^`maxBits` us (~12 days) share the last bucket
+    const static unsigned int maxBits = 40;
+
+    const static size_t numberOfBuckets = linearBuckets + (maxBits - subBucketBits - 1) * subBuckets + 1;
+
+    struct Summary {
+        uint64_t count;
+        double meanUs;
+        uint64_t maxUs;
+        uint64_t p50Us;
+        uint64_t p90Us;
+        uint64_t p99Us;
+        uint64_t p999Us;
+    };
+
+private:
+
+    std::atomic<uint64_t> buckets[numberOfBuckets];
+    std::atomic<uint64_t> sumUs;
+    std::atomic<uint64_t> maxUs;
+
+    static size_t bucketOf(uint64_t us);
+
+    /// Copies counts of all buckets and returns their sum.
+    uint64_t copyCounts(uint64_t counts[numberOfBuckets]) const;
+
+    /// Largest duration which falls into bucket.
+    static uint64_t highestValueOf(size_t bucket);
+
+public:
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    /// Add one duration.
+    /// @param us Duration in us
+    void record(uint64_t us);
+
+    /// Add time elapsed since `begin`.
+    void recordSince(std::chrono::steady_clock::time_point begin);
+
+    /// Remove all durations.
+    void reset();
+
+    /// Count, mean, max and percentiles of recorded durations.
+    /// Percentiles are the largest value of their bucket, never above max.
+    Summary summary() const;
+
+    /// Duration below which `percentile` % of recorded durations are.
+    /// @param percentile Percentile from 0 to 100
+    uint64_t percentile(double percentile) const;
+};
+
+#endif /* LatencyHistogram_h */
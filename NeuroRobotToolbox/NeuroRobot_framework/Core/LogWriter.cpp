@@ -0,0 +1,404 @@
+//
+//  LogWriter.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "LogWriter.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+    #include <io.h>
+    #define openFileDescriptor ::_open
+    #define writeFileDescriptor ::_write
+    #define closeFileDescriptor ::_close
+#else
+    #include <unistd.h>
+    #define openFileDescriptor ::open
+    #define writeFileDescriptor ::write
+    #define closeFileDescriptor ::close
+#endif
+
+/// Definitions of constants which are passed by reference, e.g. to `std::min()`
+const size_t LogEntry::textCapacity;
+const size_t LogRing::capacity;
+
+/// Time between writes of pending entries in ms.
+static const unsigned int writeIntervalMs = 50;
+
+/// Instance used by crash handler.
+static std::atomic<LogWriter *> crashInstance(NULL);
+
+/// Crash file, written only from crash handler, so it is kept as plain buffer.
+static char crashDumpPath[512] = "";
+
+#ifdef _WIN32
+    /// Hardware faults do not reliably reach signal handlers on Windows, so only abort is caught by signal
+    static void (*previousAbortHandler)(int) = SIG_DFL;
+    static PVOID crashExceptionHandle = NULL;
+#else
+    static const int crashSignals[] = { SIGSEGV, SIGBUS, SIGABRT, SIGFPE, SIGILL };
+    static const size_t numberOfCrashSignals = sizeof(crashSignals) / sizeof(crashSignals[0]);
+
+    /// Whole previous actions, so flags, mask and `sa_sigaction` of e.g. MATLAB are restored as they were
+    static struct sigaction previousActions[numberOfCrashSignals];
+#endif
+
+/// Marks ring of exiting thread as abandoned.
+struct RingOwner {
+    LogRing *ring = NULL;
+    ~RingOwner()
+    {
+        if (ring) {
+            ring->abandoned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local RingOwner ringOwner;
+
+static int64_t steadyNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//MARK:- LogRing
+LogRing::LogRing()
+: head(0)
+, tail(0)
+, dropped(0)
+, abandoned(false)
+{
+}
+
+bool LogRing::push(int64_t timeNs, uint64_t fileId, LogEntry::Kind kind, const std::string &text)
+{
+    const uint64_t position = head.load(std::memory_order_relaxed);
+    if (position - tail.load(std::memory_order_acquire) >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    LogEntry &entry = entries[position & (capacity - 1)];
+    entry.timeNs = timeNs;
+    entry.fileId = fileId;
+    entry.kind = kind;
+    entry.length = (uint32_t)std::min(text.size(), LogEntry::textCapacity);
+    std::memcpy(entry.text, text.data(), entry.length);
+
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void LogRing::popAll(std::vector<LogEntry> &batch)
+{
+    const uint64_t first = tail.load(std::memory_order_relaxed);
+    const uint64_t last = head.load(std::memory_order_acquire);
+    for (uint64_t position = first; position < last; position++) {
+        batch.push_back(entries[position & (capacity - 1)]);
+    }
+    tail.store(last, std::memory_order_release);
+}
+
+//MARK:- LogWriter
+LogWriter::LogWriter()
+: droppedWithoutRing(0)
+, steadyStart(std::chrono::steady_clock::now())
+, systemStart(std::chrono::system_clock::now())
+{
+    for (std::atomic<LogRing *> &ring : rings) {
+        ring.store(NULL, std::memory_order_relaxed);
+    }
+    batch.reserve(LogRing::capacity);
+
+    crashInstance = this;
+#ifdef _WIN32
+    previousAbortHandler = std::signal(SIGABRT, &LogWriter::crashHandler);
+    crashExceptionHandle = AddVectoredExceptionHandler(1, &LogWriter::crashExceptionHandler);
+#else
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &LogWriter::crashHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < numberOfCrashSignals; i++) {
+        sigaction(crashSignals[i], &action, &previousActions[i]);
+    }
+#endif
+
+    thread = std::thread(&LogWriter::run, this);
+}
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexWriting);
+        stopped = true;
+    }
+    stopCondition.notify_one();
+    thread.join();
+
+#ifdef _WIN32
+    RemoveVectoredExceptionHandler(crashExceptionHandle);
+    std::signal(SIGABRT, previousAbortHandler == SIG_ERR ? SIG_DFL : previousAbortHandler);
+#else
+    for (size_t i = 0; i < numberOfCrashSignals; i++) {
+        sigaction(crashSignals[i], &previousActions[i], NULL);
+    }
+#endif
+    crashInstance = NULL;
+
+    for (auto &file : files) {
+        delete file.second;
+    }
+    for (std::atomic<LogRing *> &ring : rings) {
+        delete ring.load();
+    }
+}
+
+LogWriter *LogWriter::getInstance()
+{
+    static LogWriter instance;
+    return &instance;
+}
+
+LogRing *LogWriter::ringOfThread()
+{
+    if (ringOwner.ring) { return ringOwner.ring; }
+
+    /// Take over ring of a thread which exited, its entries stay in order before new ones
+    for (std::atomic<LogRing *> &slot : rings) {
+        LogRing *ring = slot.load(std::memory_order_acquire);
+        bool abandoned = true;
+        if (ring && ring->abandoned.compare_exchange_strong(abandoned, false, std::memory_order_acq_rel)) {
+            ringOwner.ring = ring;
+            return ring;
+        }
+    }
+
+    LogRing *ring = new LogRing();
+    for (std::atomic<LogRing *> &slot : rings) {
+        LogRing *empty = NULL;
+        if (slot.compare_exchange_strong(empty, ring, std::memory_order_acq_rel)) {
+            ringOwner.ring = ring;
+            return ring;
+        }
+    }
+    delete ring;
+    return NULL;
+}
+
+uint64_t LogWriter::openFile(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    uint64_t fileId = nextFileId++;
+    files[fileId] = new std::ofstream(path);
+    return fileId;
+}
+
+void LogWriter::closeFile(uint64_t fileId)
+{
+    LogRing *ring = ringOfThread();
+    if (ring && ring->push(steadyNanoseconds(), fileId, LogEntry::KindClose, "")) { return; }
+
+    /// Without ring file is closed after all entries written so far
+    flush();
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    auto file = files.find(fileId);
+    if (file != files.end()) {
+        delete file->second;
+        files.erase(file);
+    }
+}
+
+void LogWriter::write(uint64_t fileId, const std::string &message)
+{
+    LogRing *ring = ringOfThread();
+    if (!ring) {
+        droppedWithoutRing.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring->push(steadyNanoseconds(), fileId, LogEntry::KindMessage, message);
+}
+
+void LogWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutexWriting);
+    writePending();
+}
+
+void LogWriter::setCrashDumpPath(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    strncpy(crashDumpPath, path.c_str(), sizeof(crashDumpPath) - 1);
+}
+
+void LogWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutexWriting);
+    while (!stopped) {
+        writePending();
+        stopCondition.wait_for(lock, std::chrono::milliseconds(writeIntervalMs));
+    }
+    writePending();
+}
+
+void LogWriter::writePending()
+{
+    batch.clear();
+    uint64_t dropped = droppedWithoutRing.exchange(0, std::memory_order_relaxed);
+    for (std::atomic<LogRing *> &slot : rings) {
+        LogRing *ring = slot.load(std::memory_order_acquire);
+        if (!ring) { continue; }
+        ring->popAll(batch);
+        dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+    if (dropped) {
+        std::cout << "LogWriter >>> dropped messages: " << dropped << std::endl;
+    }
+    if (batch.empty()) { return; }
+
+    /// Entries of every thread are in order, threads are merged by time
+    std::stable_sort(batch.begin(), batch.end(), [](const LogEntry &a, const LogEntry &b) { return a.timeNs < b.timeNs; });
+
+    std::lock_guard<std::mutex> lock(mutexFiles);
+    for (const LogEntry &entry : batch) {
+        auto file = files.find(entry.fileId);
+        if (file == files.end()) { continue; }
+
+        if (entry.kind == LogEntry::KindClose) {
+            delete file->second;
+            files.erase(file);
+            continue;
+        }
+
+        std::chrono::system_clock::time_point time = systemStart + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(entry.timeNs) - steadyStart.time_since_epoch());
+        std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+        long microseconds = (long)(std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count() % 1000000);
+        std::tm local;
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char timeString[64];
+        size_t length = strftime(timeString, sizeof(timeString), "%a %b %d %H:%M:%S", &local);
+        length += snprintf(timeString + length, sizeof(timeString) - length, ".%06ld", microseconds);
+        strftime(timeString + length, sizeof(timeString) - length, " %Y", &local);
+
+        *file->second << timeString << " : ";
+        file->second->write(entry.text, entry.length);
+        *file->second << '\n';
+        std::cout.write(entry.text, entry.length);
+        std::cout << '\n';
+    }
+
+    for (auto &file : files) {
+        file.second->flush();
+    }
+    std::cout.flush();
+}
+
+void LogWriter::dumpPending(const char *cause)
+{
+    LogWriter *writer = crashInstance.load();
+    int file = writer && crashDumpPath[0] ? openFileDescriptor(crashDumpPath, O_WRONLY | O_CREAT | O_APPEND, 0644) : -1;
+    if (file >= 0) {
+        char line[LogEntry::textCapacity + 96];
+        int length = snprintf(line, sizeof(line), "%s, log entries which were not written (steady clock ns, file id, message):\n", cause);
+        writeFileDescriptor(file, line, std::min(length, (int)sizeof(line) - 1));
+
+        for (std::atomic<LogRing *> &slot : writer->rings) {
+            LogRing *ring = slot.load();
+            if (!ring) { continue; }
+            const uint64_t last = ring->head.load();
+            uint64_t first = ring->tail.load();
+            first = last - first > LogRing::capacity ? last - LogRing::capacity : first;
+            for (uint64_t position = first; position < last; position++) {
+                const LogEntry &entry = ring->entries[position & (LogRing::capacity - 1)];
+                length = snprintf(line, sizeof(line), "%lld %llu : %.*s\n", (long long)entry.timeNs, (unsigned long long)entry.fileId, (int)entry.length, entry.text);
+                writeFileDescriptor(file, line, std::min(length, (int)sizeof(line) - 1));
+            }
+        }
+        closeFileDescriptor(file);
+    }
+}
+
+#ifdef _WIN32
+
+long __stdcall LogWriter::crashExceptionHandler(struct _EXCEPTION_POINTERS *exception)
+{
+    DWORD code = exception->ExceptionRecord->ExceptionCode;
+    switch (code) {
+        case EXCEPTION_ACCESS_VIOLATION:
+        case EXCEPTION_ARRAY_BOUNDS_EXCEEDED:
+        case EXCEPTION_DATATYPE_MISALIGNMENT:
+        case EXCEPTION_FLT_DIVIDE_BY_ZERO:
+        case EXCEPTION_ILLEGAL_INSTRUCTION:
+        case EXCEPTION_IN_PAGE_ERROR:
+        case EXCEPTION_INT_DIVIDE_BY_ZERO:
+        case EXCEPTION_PRIV_INSTRUCTION:
+        case EXCEPTION_STACK_OVERFLOW: {
+            char cause[32];
+            snprintf(cause, sizeof(cause), "exception 0x%08lx", (unsigned long)code);
+            dumpPending(cause);
+            break;
+        }
+        default:
+            break;
+    }
+    /// Previous handlers, e.g. of MATLAB, handle the crash
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+void LogWriter::crashHandler(int signal)
+{
+    char cause[32];
+    snprintf(cause, sizeof(cause), "signal %d", signal);
+    dumpPending(cause);
+
+    /// Previous handler, e.g. of MATLAB, handles the crash
+    std::signal(signal, previousAbortHandler == SIG_ERR ? SIG_DFL : previousAbortHandler);
+    std::raise(signal);
+}
+
+#else
+
+void LogWriter::crashHandler(int signal, siginfo_t *info, void *context)
+{
+    char cause[32];
+    snprintf(cause, sizeof(cause), "signal %d", signal);
+    dumpPending(cause);
+
+    /// Previous action, e.g. of MATLAB, handles the crash. It is restored first, so a fault which repeats after return goes
+    /// straight to it.
+    for (size_t i = 0; i < numberOfCrashSignals; i++) {
+        if (crashSignals[i] != signal) { continue; }
+
+        const struct sigaction &previous = previousActions[i];
+        sigaction(signal, &previous, NULL);
+        if (previous.sa_flags & SA_SIGINFO) {
+            if (previous.sa_sigaction) {
+                previous.sa_sigaction(signal, info, context);
+            }
+        } else if (previous.sa_handler == SIG_DFL) {
+            /// Signal is blocked during handler, default action happens when handler returns
+            raise(signal);
+        } else if (previous.sa_handler != SIG_IGN) {
+            previous.sa_handler(signal);
+        }
+        return;
+    }
+}
+
+#endif
@@ -0,0 +1,169 @@
+//
+//  LogWriter.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef LogWriter_h
+#define LogWriter_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    struct _EXCEPTION_POINTERS;
+#else
+    #include <signal.h>
+#endif
+
+/// One log event, fixed size so it is copied into ring without allocation.
+struct LogEntry {
+
+    /// Longer messages are truncated
+    static const size_t textCapacity = 232;
+
+    typedef enum {
+        KindMessage = 0,
+        /// Last entry of a file, file is closed after it is written
+        KindClose
+    } Kind;
+
+    /// Time of `std::chrono::steady_clock` in ns
+    int64_t timeNs;
+    uint64_t fileId;
+    uint32_t kind;
+    uint32_t length;
+    char text[textCapacity];
+};
+
+/// Ring of log entries of one thread. The thread pushes, writer thread pops, neither of them waits.
+/// Entries are dropped when ring is full, so logging never blocks the logging thread.
+class LogRing {
+
+public:
+
+    /// Number of entries, power of two
+    static const size_t capacity = 1024;
+
+    /// Entries pushed and popped since creation, entry `i` is at `i % capacity`
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> tail;
+
+    /// Entries which did not fit
+    std::atomic<uint64_t> dropped;
+
+    /// Set when the owning thread exits, ring is then taken over by the next thread which logs
+    std::atomic<bool> abandoned;
+
+    LogEntry entries[capacity];
+
+    LogRing();
+
+    /// Copy entry to ring, called only by owning thread.
+    /// @return False if ring is full and entry is dropped
+    bool push(int64_t timeNs, uint64_t fileId, LogEntry::Kind kind, const std::string &text);
+
+    /// Move all entries to `batch`, called only by writer thread.
+    void popAll(std::vector<LogEntry> &batch);
+};
+
+/// Background writer of log files, used by `Log` when `DEBUG` is defined.
+/// Logging thread only copies time, file and message into its own `LogRing`. Writer thread formats time, writes entries
+/// of all threads in time order to their files and echoes them to console, so file I/O, flushing and locks stay
+/// out of the decode and socket threads.
+/// Entries which are not written yet are dumped to a crash file on SIGSEGV, SIGBUS, SIGABRT, SIGFPE and SIGILL.
+/// On Windows hardware faults are caught by a vectored exception handler, which runs before any `__try` of the process,
+/// so an exception which the process (e.g. JVM of MATLAB) handles itself also writes a dump. Abort is caught by SIGABRT.
+class LogWriter {
+
+private:
+
+    /// Rings of all threads which logged, slots are claimed without lock, so crash handler can read them
+    static const size_t maxRings = 64;
+    std::atomic<LogRing *> rings[maxRings];
+
+    /// Open files, identified by id returned from `openFile()`
+    std::mutex mutexFiles;
+    std::map<uint64_t, std::ofstream *> files;
+    uint64_t nextFileId = 1;
+
+    /// Entries of logging threads without ring slot
+    std::atomic<uint64_t> droppedWithoutRing;
+
+    /// Reference between steady clock of entries and wall clock of files
+    std::chrono::steady_clock::time_point steadyStart;
+    std::chrono::system_clock::time_point systemStart;
+
+    std::thread thread;
+    std::mutex mutexWriting;
+    std::condition_variable stopCondition;
+    bool stopped = false;
+
+    /// Batch of entries, reused between writes
+    std::vector<LogEntry> batch;
+
+    LogWriter();
+
+    /// Ring of calling thread, created on first use.
+    LogRing *ringOfThread();
+
+    /// Writes all pending entries until stopped.
+    void run();
+
+    /// Write entries of all rings to files.
+    /// @warning `mutexWriting` has to be locked by caller.
+    void writePending();
+
+    /// Dump entries which are not written yet to crash file, uses only calls which are safe in a signal handler.
+    /// @param cause Description of crash, first line of dump
+    static void dumpPending(const char *cause);
+
+#ifdef _WIN32
+    /// Dump entries on fatal exception, exception is passed on to other handlers.
+    static long __stdcall crashExceptionHandler(struct _EXCEPTION_POINTERS *exception);
+
+    /// Dump entries on abort and forward signal to previous handler.
+    static void crashHandler(int signal);
+#else
+    /// Dump entries and forward signal to previous action, with its `siginfo_t` and context.
+    static void crashHandler(int signal, siginfo_t *info, void *context);
+#endif
+
+public:
+
+    ~LogWriter();
+
+    /// Static instance, created on demand.
+    static LogWriter *getInstance();
+
+    /// Open log file, messages can be written to it immediately.
+    /// @param path Path of file
+    /// @return Id of file
+    uint64_t openFile(const std::string &path);
+
+    /// Close log file after all messages written to it so far.
+    void closeFile(uint64_t fileId);
+
+    /// Queue message for writing, never blocks.
+    /// @param fileId Id returned by `openFile()`
+    /// @param message Message, truncated to `LogEntry::textCapacity` bytes
+    void write(uint64_t fileId, const std::string &message);
+
+    /// Write all queued messages and flush files before return.
+    void flush();
+
+    /// File to which entries which are not written are dumped on crash.
+    /// @param path Path of crash file, dump is skipped if empty
+    void setCrashDumpPath(const std::string &path);
+};
+
+#endif /* LogWriter_h */
@@ -0,0 +1,109 @@
+//
+//  RobotStatistics.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "RobotStatistics.h"
+
+static const char *stageNames[RobotStatistics::NumberOfStages] = {
+    "packetRead",
+    "videoDecode",
+    "audioDecode",
+    "convert",
+    "colorBlobs",
+    "publish",
+    "serialReceive",
+    "serialSend",
+    "audioSend",
+    "wakeUp",
+    "streamOpen",
+    "firstFrame",
+    "serialConnect",
+    "startup",
+    "bridgeCall"
+};
+
+static const char *counterNames[RobotStatistics::NumberOfCounters] = {
+    "videoPackets",
+    "audioPackets",
+    "decodeErrors",
+    "streamReconnects",
+    "serialLines",
+    "serialSends",
+    "coalescedSerialSends",
+    "audioChunks",
+    "sendErrors",
+    "serialReconnects",
+    "fastStarts",
+    "fastStartFallbacks"
+};
+
+//MARK:- StageTimer
+RobotStatistics::StageTimer::StageTimer(RobotStatistics *statistics_, Stage stage_)
+: statistics(statistics_)
+, stage(stage_)
+, begin(std::chrono::steady_clock::now())
+{
+}
+
+RobotStatistics::StageTimer::~StageTimer()
+{
+    if (statistics) {
+        statistics->record(stage, begin);
+    }
+}
+
+void RobotStatistics::StageTimer::cancel()
+{
+    statistics = NULL;
+}
+
+//MARK:- RobotStatistics
+RobotStatistics::RobotStatistics()
+{
+    for (std::atomic<uint64_t> &counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RobotStatistics::record(Stage stage, std::chrono::steady_clock::time_point begin)
+{
+    stages[stage].recordSince(begin);
+}
+
+void RobotStatistics::count(Counter counter, uint64_t value)
+{
+    counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary RobotStatistics::stageSummary(Stage stage) const
+{
+    return stages[stage].summary();
+}
+
+uint64_t RobotStatistics::counterValue(Counter counter) const
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+void RobotStatistics::reset()
+{
+    for (LatencyHistogram &stage : stages) {
+        stage.reset();
+    }
+    for (std::atomic<uint64_t> &counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+const char *RobotStatistics::stageName(Stage stage)
+{
+    return stage < NumberOfStages ? stageNames[stage] : "";
+}
+
+const char *RobotStatistics::counterName(Counter counter)
+{
+    return counter < NumberOfCounters ? counterNames[counter] : "";
+}
@@ -0,0 +1,124 @@
+//
+//  RobotStatistics.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef RobotStatistics_h
+#define RobotStatistics_h
+
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <chrono>
+
+/// Latency histograms of every stage of robot communication and counters of events.
+/// Always on, workers record every packet, line and send without locks, readers take summaries at any time.
+class RobotStatistics {
+
+public:
+
+    typedef enum {
+        /// `av_read_frame`, waiting for the next packet included
+        StagePacketRead = 0,
+        /// Video and audio decoding
+        StageVideoDecode,
+        StageAudioDecode,
+        /// Conversion of decoded frame to RGB
+        StageConvert,
+        /// Colour preferences of frame, if they are computed
+        StageColorBlobs,
+        /// Writing of frame or audio to shared memory
+        StagePublish,
+        /// Parsing of received serial data
+        StageSerialReceive,
+        /// Writing of serial command and audio chunk to robot
+        StageSerialSend,
+        StageAudioSend,
+        /// Lateness of timed wake-ups of workers, e.g. pacing of replayed video
+        StageWakeUp,
+        /// Opening of stream with probing of its parameters
+        StageStreamOpen,
+        /// Opening of stream and reading until the first published frame, once per connection
+        StageFirstFrame,
+        /// Connecting of serial socket, reconnections included
+        StageSerialConnect,
+        /// Construction of `NeuroRobotManager`, stream opening and serial connecting run in parallel within it
+        StageStartup,
+        /// One call of MATLAB bridge, from entry to return
+        StageBridgeCall,
+        NumberOfStages
+    } Stage;
+
+    typedef enum {
+        CounterVideoPackets = 0,
+        CounterAudioPackets,
+        CounterDecodeErrors,
+        CounterStreamReconnects,
+        CounterSerialLines,
+        CounterSerialSends,
+        /// Serial commands which were joined with the next one because previous send was in progress
+        CounterCoalescedSerialSends,
+        CounterAudioChunks,
+        CounterSendErrors,
+        CounterSerialReconnects,
+        /// Connections opened with cached stream parameters, and those which fell back to full probing
+        CounterFastStarts,
+        CounterFastStartFallbacks,
+        NumberOfCounters
+    } Counter;
+
+    /// Records duration of a stage from construction to destruction.
+    class StageTimer {
+        RobotStatistics *statistics;
+        Stage stage;
+        std::chrono::steady_clock::time_point begin;
+
+    public:
+        /// @param statistics Statistics to record into, nothing is recorded if `NULL`
+        StageTimer(RobotStatistics *statistics, Stage stage);
+        ~StageTimer();
+
+        StageTimer(const StageTimer &) = delete;
+        StageTimer &operator=(const StageTimer &) = delete;
+
+        /// Do not record anything, e.g. when statistics are deleted before the end of stage.
+        void cancel();
+    };
+
+private:
+
+    LatencyHistogram stages[NumberOfStages];
+    std::atomic<uint64_t> counters[NumberOfCounters];
+
+public:
+
+    RobotStatistics();
+
+    RobotStatistics(const RobotStatistics &) = delete;
+    RobotStatistics &operator=(const RobotStatistics &) = delete;
+
+    /// Add duration of a stage which began at `begin` and ends now.
+    void record(Stage stage, std::chrono::steady_clock::time_point begin);
+
+    /// Increase counter by `value`.
+    void count(Counter counter, uint64_t value = 1);
+
+    /// Summary of recorded durations of a stage.
+    LatencyHistogram::Summary stageSummary(Stage stage) const;
+
+    /// Value of counter.
+    uint64_t counterValue(Counter counter) const;
+
+    /// Remove all durations and zero all counters.
+    void reset();
+
+    /// Name of stage, e.g. `packetRead`.
+    static const char *stageName(Stage stage);
+
+    /// Name of counter, e.g. `videoPackets`.
+    static const char *counterName(Counter counter);
+};
+
+#endif /* RobotStatistics_h */
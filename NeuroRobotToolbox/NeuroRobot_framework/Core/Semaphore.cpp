@@ -8,6 +8,16 @@
 
 #include "Semaphore.h"
 
+#include <algorithm>
+#include <limits.h>
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
 #ifdef __APPLE__
 
     Semaphore::Semaphore() {
@@ -22,14 +32,20 @@
         dispatch_semaphore_wait(semaphoreMutex, DISPATCH_TIME_FOREVER);
     }
 
+    bool Semaphore::waitUntil(std::chrono::steady_clock::time_point deadline) {
+        int64_t remainingNs = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+        dispatch_time_t timeout = remainingNs > 0 ? dispatch_time(DISPATCH_TIME_NOW, remainingNs) : DISPATCH_TIME_NOW;
+        return dispatch_semaphore_wait(semaphoreMutex, timeout) == 0;
+    }
+
     void Semaphore::signal() {
         dispatch_semaphore_signal(semaphoreMutex);
     }
 
-#else
+#elif defined(_WIN32)
 
     Semaphore::Semaphore() {
-        semaphoreMutex = CreateSemaphore(NULL, 0, 1, NULL);
+        semaphoreMutex = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
     }
 
     Semaphore::~Semaphore() {
@@ -40,8 +56,82 @@
         WaitForSingleObject(semaphoreMutex, INFINITE);
     }
 
+    bool Semaphore::waitUntil(std::chrono::steady_clock::time_point deadline) {
+        /// Rounded up, so wait never ends before deadline
+        int64_t remainingUs = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count();
+        DWORD timeoutMs = remainingUs > 0 ? (DWORD)std::min<int64_t>((remainingUs + 999) / 1000, INFINITE - 1) : 0;
+        return WaitForSingleObject(semaphoreMutex, timeoutMs) == WAIT_OBJECT_0;
+    }
+
     void Semaphore::signal() {
         ReleaseSemaphore(semaphoreMutex, 1, NULL);
     }
 
+#else
+
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex word has to be plain int");
+
+    /// Block while `*word` is `expected`, until woken or `timeout` (relative) elapses.
+    static void futexWait(std::atomic<int> *word, int expected, const struct timespec *timeout)
+    {
+        syscall(SYS_futex, reinterpret_cast<int *>(word), FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+    }
+
+    static void futexWake(std::atomic<int> *word, int numberOfThreads)
+    {
+        syscall(SYS_futex, reinterpret_cast<int *>(word), FUTEX_WAKE_PRIVATE, numberOfThreads, NULL, NULL, 0);
+    }
+
+    /// Consume one signal without blocking.
+    static bool tryDecrement(std::atomic<int> &count)
+    {
+        int value = count.load(std::memory_order_relaxed);
+        while (value > 0) {
+            if (count.compare_exchange_weak(value, value - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Semaphore::Semaphore()
+    : count(0)
+    , waiters(0)
+    {
+    }
+
+    Semaphore::~Semaphore() {
+    }
+
+    void Semaphore::wait() {
+        while (!tryDecrement(count)) {
+            /// Kernel checks that count is still 0 before sleeping, so signal between check and sleep is not lost
+            waiters.fetch_add(1);
+            futexWait(&count, 0, NULL);
+            waiters.fetch_sub(1);
+        }
+    }
+
+    bool Semaphore::waitUntil(std::chrono::steady_clock::time_point deadline) {
+        while (!tryDecrement(count)) {
+            int64_t remainingNs = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remainingNs <= 0) { return false; }
+
+            struct timespec timeout;
+            timeout.tv_sec = (time_t)(remainingNs / 1000000000);
+            timeout.tv_nsec = (long)(remainingNs % 1000000000);
+            waiters.fetch_add(1);
+            futexWait(&count, 0, &timeout);
+            waiters.fetch_sub(1);
+        }
+        return true;
+    }
+
+    void Semaphore::signal() {
+        count.fetch_add(1);
+        if (waiters.load() > 0) {
+            futexWake(&count, 1);
+        }
+    }
+
 #endif
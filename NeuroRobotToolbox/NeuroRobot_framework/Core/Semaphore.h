@@ -9,36 +9,65 @@
 #ifndef Semaphore_hpp
 #define Semaphore_hpp
 
-#include <iostream>
+#include <atomic>
+#include <chrono>
 
 #ifdef __APPLE__
     #include <dispatch/dispatch.h>
-#else
+#elif defined(_WIN32)
     #define WIN32_LEAN_AND_MEAN
     #include <Windows.h>
 #endif
 
+/// Counting semaphore.
+/// Backed by `dispatch_semaphore` on macOS, Win32 semaphore on Windows and futex on Linux.
 class Semaphore {
-    
+
 private:
-    
+
     #ifdef __APPLE__
         dispatch_semaphore_t semaphoreMutex;
-    #else
+    #elif defined(_WIN32)
         HANDLE semaphoreMutex;
+    #else
+        /// Number of signals not consumed by `wait()`, futex word
+        std::atomic<int> count;
+        /// Threads blocked in futex, `signal()` skips the wake syscall when there are none
+        std::atomic<int> waiters;
     #endif
-    
+
 public:
-    
+
     Semaphore();
     ~Semaphore();
-    
+
+    Semaphore(const Semaphore &) = delete;
+    Semaphore &operator=(const Semaphore &) = delete;
+
     /// Block current thread until signal is called.
     void wait();
-    
+
+    /// Block current thread until signal is called or until `deadline`.
+    /// @return True if signal is consumed, false on timeout
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+
+    /// Block current thread until signal is called or until `timeout` elapses.
+    /// @return True if signal is consumed, false on timeout
+    bool waitFor(std::chrono::steady_clock::duration timeout)
+    {
+        return waitUntil(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /// Consume signal if there is one, never blocks.
+    /// @return True if signal is consumed
+    bool tryWait()
+    {
+        return waitUntil(std::chrono::steady_clock::time_point());
+    }
+
     /// Inform that signal happened.
     void signal();
-    
+
 };
 
 #endif /* Semaphore_hpp */
@@ -0,0 +1,119 @@
+//
+//  ThreadPool.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "ThreadPool.h"
+
+/// Bounds for number of workers of shared instance. Its jobs do not block, so workers are not added per robot.
+const static unsigned int minWorkers = 2;
+const static unsigned int maxWorkers = 8;
+
+/// Null, because instance will be initialized on demand.
+ThreadPool* ThreadPool::instance = 0;
+ThreadPool* ThreadPool::getInstance()
+{
+    static std::mutex mutexInstance;
+    std::lock_guard<std::mutex> lock(mutexInstance);
+    
+    if (instance == 0) {
+        unsigned int numberOfWorkers = std::thread::hardware_concurrency();
+        if (numberOfWorkers < minWorkers) numberOfWorkers = minWorkers;
+        if (numberOfWorkers > maxWorkers) numberOfWorkers = maxWorkers;
+        instance = new ThreadPool(numberOfWorkers);
+    }
+    return instance;
+}
+
+ThreadPool::ThreadPool(unsigned int numberOfWorkers)
+{
+    for (unsigned int i = 0; i < numberOfWorkers; i++) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    join();
+}
+
+void ThreadPool::join()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexTasks);
+        stopping = true;
+    }
+    tasksCondition.notify_all();
+    
+    for (std::thread &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutexTasks);
+            tasksCondition.wait(lock, [this] { return !tasks.empty() || stopping; });
+            if (tasks.empty()) { return; }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexTasks);
+        tasks.push_back(std::move(task));
+    }
+    tasksCondition.notify_one();
+}
+
+size_t ThreadPool::numberOfWorkers()
+{
+    return workers.size();
+}
+
+//MARK:- ThreadPoolGroup
+ThreadPoolGroup::ThreadPoolGroup(ThreadPool *pool_)
+: pool(pool_)
+{
+}
+
+ThreadPoolGroup::~ThreadPoolGroup()
+{
+    join();
+}
+
+void ThreadPoolGroup::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexPending);
+        if (joined) { return; }
+        numberOfPending++;
+    }
+    pool->enqueue([this, task] {
+        task();
+        
+        /// Notified under lock, so group is not destroyed by `join()` before notify returns
+        std::lock_guard<std::mutex> lock(mutexPending);
+        numberOfPending--;
+        pendingCondition.notify_all();
+    });
+}
+
+void ThreadPoolGroup::join()
+{
+    std::unique_lock<std::mutex> lock(mutexPending);
+    pendingCondition.wait(lock, [this] { return numberOfPending == 0; });
+    joined = true;
+}
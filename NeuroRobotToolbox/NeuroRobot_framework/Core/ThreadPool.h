@@ -0,0 +1,107 @@
+//
+//  ThreadPool.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/// Pool of worker threads which execute queued jobs in order.
+/// The shared instance is bounded and takes short jobs of all robots in the process (serial sends), its users track
+/// their jobs with `ThreadPoolGroup`. Jobs which block for long or wait for each other (audio playback, partitions of
+/// `BrainSimulation`) run on pools owned by their user, so they never hold workers of the shared instance.
+/// Long-running loops (`BackgroundThread::run()`) keep their own threads.
+class ThreadPool {
+    
+private:
+    
+    /// Instance used for `singleton` mechanism
+    static ThreadPool* instance;
+    
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    
+    /// Set by `join()`, workers exit once queue is empty
+    bool stopping = false;
+    
+    /// Sync mechanism
+    std::mutex mutexTasks;
+    std::condition_variable tasksCondition;
+    
+    /// Worker thread method. Executes queued tasks until pool is joined.
+    void workerLoop();
+    
+public:
+    
+    /// @param numberOfWorkers Number of worker threads
+    ThreadPool(unsigned int numberOfWorkers);
+    
+    /// Joins pool, queued tasks are executed first.
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    
+    /// Shared instance, created on demand and never joined.
+    static ThreadPool* getInstance();
+    
+    /// Queue task for execution on one of the workers.
+    /// @param task Task to execute
+    void enqueue(std::function<void()> task);
+    
+    /// Number of worker threads.
+    size_t numberOfWorkers();
+    
+    /// Execute all queued tasks, also those queued by them, and wait until workers exit.
+    /// @warning Must not be called from a task of this pool
+    void join();
+};
+
+/// Jobs of one owner on a pool which it does not own, e.g. the shared instance.
+/// Owner joins the group before its members are destroyed, so no job of it outlives it.
+class ThreadPoolGroup {
+    
+private:
+    
+    ThreadPool *pool;
+    
+    /// Jobs queued and not finished yet
+    size_t numberOfPending = 0;
+    
+    /// Set by `join()`, further jobs are dropped
+    bool joined = false;
+    
+    /// Sync mechanism
+    std::mutex mutexPending;
+    std::condition_variable pendingCondition;
+    
+public:
+    
+    /// @param pool Pool which executes jobs, has to outlive the group
+    ThreadPoolGroup(ThreadPool *pool);
+    
+    /// Joins group.
+    ~ThreadPoolGroup();
+    
+    ThreadPoolGroup(const ThreadPoolGroup &) = delete;
+    ThreadPoolGroup &operator=(const ThreadPoolGroup &) = delete;
+    
+    /// Queue task on the pool, task is dropped if group is joined.
+    /// @param task Task to execute
+    void enqueue(std::function<void()> task);
+    
+    /// Wait until all queued tasks, also those queued by them, are executed. Tasks queued after that are dropped.
+    /// @warning Must not be called from a task of this group
+    void join();
+};
+
+#endif /* ThreadPool_h */
@@ -0,0 +1,85 @@
+//
+//  ThreadSettings.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "ThreadSettings.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #ifdef __linux__
+        #include <sys/resource.h>
+        #include <sys/syscall.h>
+        #include <unistd.h>
+    #endif
+#endif
+
+/// Append reason to errors separated with "; ".
+static void addError(std::string &error, const std::string &reason)
+{
+    error += (error.empty() ? "" : "; ") + reason;
+}
+
+bool applyThreadSettings(const ThreadSettings &settings, std::string &error)
+{
+    error.clear();
+
+    if (settings.cpu >= 0) {
+#if defined(_WIN32)
+        if (settings.cpu >= (int)(sizeof(DWORD_PTR) * 8) || !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << settings.cpu)) {
+            addError(error, "Cannot pin thread to CPU " + std::to_string(settings.cpu));
+        }
+#elif defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(settings.cpu, &cpus);
+        int result = settings.cpu < CPU_SETSIZE ? pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) : EINVAL;
+        if (result != 0) {
+            addError(error, "Cannot pin thread to CPU " + std::to_string(settings.cpu) + ": " + strerror(result));
+        }
+#else
+        addError(error, "Pinning thread to CPU is not supported");
+#endif
+    }
+
+    if (settings.priority > 0) {
+#ifdef _WIN32
+        if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+            addError(error, "Cannot set time critical thread priority");
+        }
+#else
+        sched_param parameters;
+        parameters.sched_priority = std::min(std::max(settings.priority, sched_get_priority_min(SCHED_FIFO)), sched_get_priority_max(SCHED_FIFO));
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+        if (result != 0) {
+            addError(error, "Cannot set SCHED_FIFO priority " + std::to_string(parameters.sched_priority) + ": " + strerror(result));
+        }
+#endif
+    } else if (settings.nice != 0) {
+#if defined(_WIN32)
+        int priority = settings.nice <= -10 ? THREAD_PRIORITY_HIGHEST : settings.nice < 0 ? THREAD_PRIORITY_ABOVE_NORMAL : settings.nice < 10 ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_LOWEST;
+        if (!SetThreadPriority(GetCurrentThread(), priority)) {
+            addError(error, "Cannot set thread priority");
+        }
+#elif defined(__linux__)
+        /// Nice of thread id changes only the calling thread
+        if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), settings.nice) != 0) {
+            addError(error, "Cannot set nice " + std::to_string(settings.nice) + ": " + strerror(errno));
+        }
+#else
+        addError(error, "Nice of single thread is not supported");
+#endif
+    }
+
+    return error.empty();
+}
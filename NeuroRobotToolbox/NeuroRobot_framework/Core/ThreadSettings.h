@@ -0,0 +1,41 @@
+//
+//  ThreadSettings.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ThreadSettings_h
+#define ThreadSettings_h
+
+#include <string>
+
+/// Scheduling of one worker thread, so it is not preempted by MATLAB and other busy processes.
+/// Default values keep scheduling of the operating system.
+struct ThreadSettings {
+
+    /// CPU which the thread is pinned to, -1 for any CPU
+    int cpu = -1;
+
+    /// Real-time priority, `SCHED_FIFO` from 1 to 99 (time critical thread priority on Windows), 0 for normal scheduling.
+    /// Usually needs rights, e.g. `CAP_SYS_NICE` or `rtprio` limit on Linux.
+    int priority = 0;
+
+    /// Nice value of normal scheduling from -20 to 19, used if `priority` is 0.
+    /// Per thread on Linux, mapped to thread priority on Windows.
+    int nice = 0;
+
+    /// @return Whether all values are default
+    bool isDefault() const
+    {
+        return cpu < 0 && priority == 0 && nice == 0;
+    }
+};
+
+/// Apply scheduling settings to the calling thread.
+/// @param settings Settings to apply
+/// @param error Reason of every setting which could not be applied
+/// @return True if all settings are applied
+bool applyThreadSettings(const ThreadSettings &settings, std::string &error);
+
+#endif /* ThreadSettings_h */
@@ -17,30 +17,74 @@
 #endif
 
 #include <iostream>
+#include <map>
+#include <set>
 
 #ifdef DEBUG
-    #include <ctime>
-    #include <chrono>
+    #include "Core/LogWriter.h"
     #include <typeinfo>
     #include <string>
     #include <boost/filesystem.hpp>
     #include <future>
+    #include <cstring>
 #endif
 
 static std::string path;
 
+/// Levels set by `Log::setLevel`, default level of all classes and levels of single classes.
+static int defaultLevel = LOG_LEVEL;
+static std::map<std::string, int> classLevels;
+
+/// Live objects, so new level is applied also to them
+static std::set<Log *> objects;
+static std::mutex levelsMutex;
+
+#ifdef DEBUG
+/// Number of opened log files per class name, used to separate logs of several robots in one process.
+static std::map<std::string, int> instanceCounters;
+static std::mutex instanceCountersMutex;
+#endif
+
 const static std::string codeVersion = "v1.0.5";
 const static std::string codeDate = "25/Apr/2020";
 
 Log::Log(std::string className)
 {
     this->className = className;
+    
+    levelsMutex.lock();
+    auto classLevel = classLevels.find(className);
+    level = classLevel == classLevels.end() ? defaultLevel : classLevel->second;
+    objects.insert(this);
+    levelsMutex.unlock();
+    
     openLogFile();
 }
 
 Log::~Log()
 {
     closeLogFile();
+    
+    levelsMutex.lock();
+    objects.erase(this);
+    levelsMutex.unlock();
+}
+
+void Log::setLevel(LogLevel level, const std::string &className)
+{
+    std::lock_guard<std::mutex> lock(levelsMutex);
+    if (className.empty()) {
+        defaultLevel = level;
+        classLevels.clear();
+    } else {
+        classLevels[className] = level;
+    }
+    
+    for (Log *object : objects) {
+        if (className.empty() || object->className == className) {
+            object->level = level;
+        }
+    }
 }
 
 void Log::openLogFile()
@@ -52,34 +96,37 @@ void Log::openLogFile()
     strcpy(logFileName, path.c_str());
     strcat(logFileName, "/NeuroRobot_logFile_");
     strcat(logFileName, className.c_str());
+    
+    instanceCountersMutex.lock();
+    int instanceCounter = ++instanceCounters[className];
+    instanceCountersMutex.unlock();
+    if (instanceCounter > 1) {
+        strcat(logFileName, ("_" + std::to_string(instanceCounter)).c_str());
+    }
     strcat(logFileName, ".txt");
     
-    logFile.open(logFileName);
+    logFileId = LogWriter::getInstance()->openFile(logFileName);
+    LogWriter::getInstance()->setCrashDumpPath(path + "/NeuroRobot_crash.txt");
     
-    logMessage("openLogFile >> path: >> " + std::string(logFileName) + " >>> opened");
-    logMessage("code version: " + codeVersion);
-    logMessage("code date: " + codeDate);
+    LOG_INFO("openLogFile >> path: >> " + std::string(logFileName) + " >>> opened");
+    LOG_INFO("code version: " + codeVersion);
+    LOG_INFO("code date: " + codeDate);
 #endif
 }
 
 void Log::closeLogFile()
 {
 #ifdef DEBUG
-    logMessage("closeLogFile >> " + className + " >>> closed");
-    if (logFile.is_open()) {
-        logFile.close();
-    }
+    LOG_INFO("closeLogFile >> " + className + " >>> closed");
+    LogWriter::getInstance()->closeFile(logFileId);
 #endif
 }
 
-void Log::logMessage(std::string message) {
+void Log::logMessage(const std::string &message) {
 #ifdef DEBUG
-    loggingMutex.lock();
-    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::string t(std::ctime(&now));
-    logFile << t.substr( 0, t.length() -1) << " : " << message << std::endl;
-    std::cout << message << std::endl;
-    loggingMutex.unlock();
+    LogWriter::getInstance()->write(logFileId, message);
+#else
+    (void)message;
 #endif
 }
 
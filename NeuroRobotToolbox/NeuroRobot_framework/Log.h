@@ -10,12 +10,32 @@
 #define Log_h
 
 #include "Macros.h"
+#include <atomic>
 #include <string>
 #include <mutex>
+#include <stdint.h>
 
-#ifdef DEBUG
-    #include <fstream>
-#endif
+/// Level of log message, every level includes all levels before it.
+typedef enum {
+    LogLevelOff = 0,
+    LogLevelError,
+    LogLevelWarning,
+    /// Start, stop and state changes
+    LogLevelInfo,
+    /// Steps of setup
+    LogLevelDebug,
+    /// Every packet, serial line and send
+    LogLevelTrace
+} LogLevel;
+
+/// Log message of `level` from a class derived from `Log`.
+/// `message` is evaluated only if `level` is compiled in, see `LOG_LEVEL` in Macros.h, and enabled for the class, see `Log::setLevel`.
+#define LOG_AT(level, message) do { if (LOG_LEVEL >= (level) && isLogEnabled(level)) { logMessage(message); } } while (0)
+#define LOG_ERROR(message) LOG_AT(LogLevelError, message)
+#define LOG_WARNING(message) LOG_AT(LogLevelWarning, message)
+#define LOG_INFO(message) LOG_AT(LogLevelInfo, message)
+#define LOG_DEBUG(message) LOG_AT(LogLevelDebug, message)
+#define LOG_TRACE(message) LOG_AT(LogLevelTrace, message)
 
 /// Derived class for logging system
 class Log
@@ -23,15 +43,14 @@ class Log
     
 private:
     
-#ifdef DEBUG
-    std::ofstream logFile;
-#endif
+    /// Log file in `LogWriter`
+    uint64_t logFileId = 0;
     
     /// Class name relevant for log file name
     std::string className = "No_name";
     
-    /// Data for sync mechanism
-    std::mutex loggingMutex;
+    /// Most detailed enabled level of this object
+    std::atomic<int> level;
     
     /// Open log file.
     /// Be sure that `className` is defined like you want. Use provided constructor.
@@ -48,10 +67,24 @@ protected:
     Log(std::string className);
     ~Log();
     
-    /// Write forwarded message to log file.
+    /// Queue forwarded message for writing to log file by background thread of `LogWriter`.
+    /// Prefer `LOG_INFO` and other macros, which build message only when it is logged.
     /// @param message Message to log
     /// @warning Working only if the macro #DEBUG is defined in Macros.h.
-    void logMessage(std::string message);
+    void logMessage(const std::string &message);
+    
+    /// Whether messages of `level` are enabled for this object.
+    bool isLogEnabled(LogLevel level_) const
+    {
+        return level.load(std::memory_order_relaxed) >= level_;
+    }
+    
+public:
+    
+    /// Set the most detailed level which is logged, at run time. Levels above `LOG_LEVEL` stay removed.
+    /// @param level Level of all classes, or of `className` class
+    /// @param className Class name given to `Log`, e.g. "Socket", all classes if empty
+    static void setLevel(LogLevel level, const std::string &className = "");
 };
 
 #endif /* Log_h */
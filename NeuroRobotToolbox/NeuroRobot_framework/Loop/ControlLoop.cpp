@@ -0,0 +1,338 @@
+//
+//  ControlLoop.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "ControlLoop.h"
+#include "NeuroRobotManager.h"
+#include "Batch/SensoryInput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+/// Runtime constants of `neurorobot.m`.
+const static double permanentMemoryThreshold = 24;
+const static double maxWeight = 100;
+
+/// Distance when robot does not report it, `rak_get_serial.m`.
+const static double maxDistance = 4000;
+
+typedef std::chrono::steady_clock Clock;
+
+static double millisecondsBetween(Clock::time_point begin, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+ControlLoop::ControlLoop(NeuroRobotManager *robot_)
+: Log("ControlLoop")
+, robot(robot_)
+, running(false)
+{
+    memset(&statistics, 0, sizeof(Statistics));
+}
+
+ControlLoop::~ControlLoop()
+{
+    stop();
+}
+
+bool ControlLoop::start(const std::string &brainPath, const Settings &settings_, std::string &error)
+{
+    stop();
+
+    if (settings_.periodMs <= 0 || settings_.msPerStep == 0) {
+        error = "Period and ms per step must be positive.";
+        return false;
+    }
+    BrainDescription loadedBrain;
+    if (!loadBrain(brainPath, loadedBrain, error)) { return false; }
+
+    brain = loadedBrain;
+    settings = settings_;
+
+    /// `update_brain.m` clamps whole connectome, learning clamps only plastic synapses, other weights do not change
+    for (double &weight : brain.weights) {
+        weight = std::min(weight, maxWeight);
+    }
+    const size_t n = brain.numberOfNeurons;
+    uint64_t seed = settings.seed ? settings.seed : std::random_device()();
+
+    /// Initial state of `load_or_initialize_brain.m`
+    std::mt19937_64 generator(seed);
+    std::normal_distribution<double> normal;
+    std::vector<double> v(n), u(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = brain.c[i] + 5 * normal(generator);
+        u[i] = brain.b[i] * v[i];
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(brainMutex);
+        simulation.setNumberOfThreads(settings.numberOfThreads);
+        simulation.setSeed(seed);
+        simulation.setNeurons(n, brain.a.data(), brain.b.data(), brain.c.data(), brain.d.data(), v.data(), u.data());
+        simulation.setSparseConnectome(brain.columnPointers.data(), brain.rowIndices.data(), brain.weights.data());
+        if (settings.learning) {
+            simulation.setSparsePlasticity(brain.daColumnPointers.data(), brain.daRowIndices.data(), brain.daValues.data());
+        }
+        simulation.setBasalGanglia(brain.networkIds.data(), brain.basalGangliaNeurons.data(), brain.numberOfNetworks, brain.networkDrive.data(), settings.basalGanglia);
+        reward = 0;
+    }
+
+    spikes.assign(n * settings.msPerStep, 0);
+    currents.assign(n * settings.msPerStep, 0);
+    firing.assign(n, 0);
+    stepsSinceLastSpike.assign(n, NAN);
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        memset(&statistics, 0, sizeof(Statistics));
+        state.step = 0;
+        state.firing.assign(n, 0);
+        state.motorCommand = MotorCommand();
+        memset(state.visualPreferences, 0, sizeof(state.visualPreferences));
+        state.hasVisualPreferences = false;
+        state.frameSequence = 0;
+        state.distance = maxDistance;
+        state.selectedNetwork = 0;
+    }
+
+    LOG_INFO("start >>> " + brain.name + ", " + std::to_string(n) + " neurons, period " + std::to_string(settings.periodMs) + " ms");
+    running = true;
+    std::promise<std::string> settingsApplied;
+    thread = std::thread(&ControlLoop::run, this, &settingsApplied);
+    threadSettingsError = settingsApplied.get_future().get();
+    if (!threadSettingsError.empty()) {
+        LOG_WARNING("start >>> " + threadSettingsError);
+    }
+    return true;
+}
+
+void ControlLoop::stop()
+{
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+        LOG_INFO("stop >>> " + std::to_string(statistics.steps) + " steps");
+    }
+}
+
+bool ControlLoop::isRunning()
+{
+    return running;
+}
+
+const std::string &ControlLoop::readThreadSettingsError()
+{
+    return threadSettingsError;
+}
+
+void ControlLoop::run(std::promise<std::string> *settingsApplied)
+{
+    std::string error;
+    if (!settings.thread.isDefault()) {
+        applyThreadSettings(settings.thread, error);
+    }
+    settingsApplied->set_value(error);
+
+    const Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(settings.periodMs));
+    Clock::time_point due = Clock::now();
+
+    while (running) {
+        std::this_thread::sleep_until(due);
+        const Clock::time_point begin = Clock::now();
+        const double jitterMs = millisecondsBetween(due, begin);
+
+        double stageMs[NumberOfStages];
+        runStep(stageMs);
+        const Clock::time_point end = Clock::now();
+
+        /// Step which started more than a period late skips due times it missed, like a timer dropping events
+        due += period;
+        uint64_t skippedSteps = 0;
+        const bool periodOverrun = end > due;
+        while (due + period <= end) {
+            due += period;
+            skippedSteps++;
+        }
+
+        addStatistics(jitterMs, millisecondsBetween(begin, end), stageMs, periodOverrun, skippedSteps);
+    }
+}
+
+void ControlLoop::runStep(double stageMs[NumberOfStages])
+{
+    const size_t n = brain.numberOfNeurons;
+    Clock::time_point stageBegin = Clock::now();
+    auto endStage = [&](Stage stage) {
+        Clock::time_point now = Clock::now();
+        stageMs[stage] = millisecondsBetween(stageBegin, now);
+        stageBegin = now;
+    };
+
+    /// Sense, frame and audio are not copied
+    robot->readSnapshot(NULL, 0, NULL, 0, &snapshot);
+    const double distance = distanceFromSerial(snapshot.serialData);
+    if (!snapshot.hasVisualPreferences) {
+        memset(snapshot.visualPreferences, 0, sizeof(snapshot.visualPreferences));
+    }
+    endStage(StageSense);
+
+    /// Features
+    SensoryInput::sensorCurrents(brain, snapshot.visualPreferences, ColorBlobs::numberOfValues, distance, sensoryCurrent);
+    endStage(StageFeatures);
+
+    /// Brain
+    double selectedNetwork = 0;
+    {
+        std::lock_guard<std::mutex> lock(brainMutex);
+        /// Reward is used once, by selection and by learning of this step
+        const double stepReward = reward;
+        reward = 0;
+        simulation.step(settings.msPerStep, sensoryCurrent.data(), 2, NULL, stepReward, spikes.data(), currents.data());
+
+        std::fill(firing.begin(), firing.end(), 0);
+        for (size_t t = 0; t < settings.msPerStep; t++) {
+            const uint8_t *spikesNow = &spikes[t * n];
+            for (size_t i = 0; i < n; i++) {
+                firing[i] |= spikesNow[i];
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (firing[i]) { stepsSinceLastSpike[i] = 0; }
+            stepsSinceLastSpike[i] = stepsSinceLastSpike[i] + 1;
+        }
+
+        if (settings.learning) {
+            /// `ltp_recency_th_in_steps` of `neurorobot.m`
+            double ltpRecencyThresholdInSteps = std::round(settings.ltpRecencyThresholdInSec / settings.msPerStep);
+            SynapticPlasticity::Parameters parameters = { settings.periodMs / 1000, ltpRecencyThresholdInSteps, permanentMemoryThreshold, maxWeight };
+            changes.clear();
+            simulation.learn(firing.data(), stepsSinceLastSpike.data(), stepReward, parameters, changes);
+        }
+        if (simulation.getBasalGanglia().isSet()) {
+            selectedNetwork = simulation.getBasalGanglia().getSelectedNetwork();
+        }
+    }
+    endStage(StageBrain);
+
+    /// Motor
+    MotorCommand command = motorCommand(brain, firing.data());
+    robot->writeSerial(serialCommand(command));
+    endStage(StageMotor);
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    state.step++;
+    std::copy(firing.begin(), firing.end(), state.firing.begin());
+    state.motorCommand = command;
+    memcpy(state.visualPreferences, snapshot.visualPreferences, sizeof(state.visualPreferences));
+    state.hasVisualPreferences = snapshot.hasVisualPreferences;
+    state.frameSequence = snapshot.frameSequence;
+    state.distance = distance;
+    state.selectedNetwork = selectedNetwork;
+}
+
+void ControlLoop::addStatistics(double jitterMs, double stepMs, const double stageMs[NumberOfStages], bool periodOverrun, uint64_t skippedSteps)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    statistics.steps++;
+    const double steps = (double)statistics.steps;
+
+    statistics.periodOverruns += periodOverrun;
+    statistics.skippedSteps += skippedSteps;
+
+    statistics.lastJitterMs = jitterMs;
+    statistics.meanJitterMs += (jitterMs - statistics.meanJitterMs) / steps;
+    statistics.maxJitterMs = std::max(statistics.maxJitterMs, jitterMs);
+
+    statistics.lastStepMs = stepMs;
+    statistics.meanStepMs += (stepMs - statistics.meanStepMs) / steps;
+    statistics.maxStepMs = std::max(statistics.maxStepMs, stepMs);
+
+    for (unsigned int stage = 0; stage < NumberOfStages; stage++) {
+        StageStatistics &stageStatistics = statistics.stages[stage];
+        stageStatistics.overruns += stageMs[stage] > settings.deadlinesMs[stage];
+        stageStatistics.lastMs = stageMs[stage];
+        stageStatistics.meanMs += (stageMs[stage] - stageStatistics.meanMs) / steps;
+        stageStatistics.maxMs = std::max(stageStatistics.maxMs, stageMs[stage]);
+    }
+}
+
+double ControlLoop::distanceFromSerial(const std::string &serialData)
+{
+    /// Distance is the third comma separated value, 0 means nothing is in range
+    size_t begin = serialData.find(',');
+    begin = begin == std::string::npos ? begin : serialData.find(',', begin + 1);
+    if (begin == std::string::npos) { return maxDistance; }
+
+    const char *field = serialData.c_str() + begin + 1;
+    char *fieldEnd = NULL;
+    double distance = strtod(field, &fieldEnd);
+    if (fieldEnd == field || distance == 0) { return maxDistance; }
+    return distance;
+}
+
+std::string ControlLoop::serialCommand(const MotorCommand &command)
+{
+    /// Direction 2 is backward, sent as negative torque
+    const double left = command.leftDirection == 2 ? -command.leftTorque : command.leftTorque;
+    const double right = command.rightDirection == 2 ? -command.rightTorque : command.rightTorque;
+
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "l:%g;r:%g;s:0;", left, right);
+    return buffer;
+}
+
+void ControlLoop::readStatistics(Statistics &statistics_)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    statistics_ = statistics;
+}
+
+void ControlLoop::readState(State &state_)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    state_ = state;
+}
+
+void ControlLoop::readNeurons(double *v, double *u)
+{
+    std::lock_guard<std::mutex> lock(brainMutex);
+    simulation.getState(v, u);
+}
+
+void ControlLoop::readConnectome(double *weights)
+{
+    std::lock_guard<std::mutex> lock(brainMutex);
+    simulation.getConnectome(weights);
+}
+
+void ControlLoop::setConnectome(const double *weights)
+{
+    const size_t numberOfWeights = brain.numberOfNeurons * brain.numberOfNeurons;
+    std::vector<double> clampedWeights(weights, weights + numberOfWeights);
+    for (double &weight : clampedWeights) {
+        weight = std::min(weight, maxWeight);
+    }
+
+    std::lock_guard<std::mutex> lock(brainMutex);
+    simulation.setConnectome(clampedWeights.data(), settings.learning);
+}
+
+void ControlLoop::setReward(double reward_)
+{
+    std::lock_guard<std::mutex> lock(brainMutex);
+    reward = reward_;
+}
+
+size_t ControlLoop::numberOfNeurons()
+{
+    return brain.numberOfNeurons;
+}
@@ -0,0 +1,220 @@
+//
+//  ControlLoop.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ControlLoop_h
+#define ControlLoop_h
+
+#include "Log.h"
+#include "SharedMemory.h"
+#include "Batch/BrainFile.h"
+#include "Brain/BrainSimulation.h"
+#include "Core/ThreadSettings.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class NeuroRobotManager;
+
+/// Native closed loop of one robot and one brain, what `runtime_pulse` timer runs in MATLAB with `runtime_pulse_code.m`.
+/// Every step runs four stages on own thread:
+///     sense       serial data and colour preferences of the last frame (`ColorBlobs` has to be set)
+///     features    sensory currents `[vis_I dist_I]`
+///     brain       simulation of `msPerStep` ms, basal ganglia selection and learning
+///     motor       motor command from fired neurons, written to serial like `update_motors.m`
+///
+/// Step `k` is due at `start + k * period`. Step which starts more than a whole period late skips due times it missed
+/// instead of running them back to back. Every stage has its own deadline, overruns and jitter of step start are counted,
+/// so it is visible which stage does not fit into the period.
+/// While the loop runs MATLAB only observes the brain and edits it, other threads never wait for a whole step.
+class ControlLoop : public Log {
+
+public:
+
+    typedef enum {
+        StageSense = 0,
+        StageFeatures,
+        StageBrain,
+        StageMotor,
+        NumberOfStages
+    } Stage;
+
+    struct Settings {
+        /// Time between step starts in ms, `pulse_period`
+        double periodMs = 100;
+
+        /// Simulated ms per step, `ms_per_step`
+        unsigned int msPerStep = 100;
+
+        /// `ltp_recency_th_in_sec`, learning threshold in steps is `round(ltp_recency_th_in_sec / ms_per_step)` like in `neurorobot.m`
+        double ltpRecencyThresholdInSec = 2000;
+
+        /// Longest allowed duration of every stage in ms
+        double deadlinesMs[NumberOfStages] = { 5, 5, 70, 5 };
+
+        /// Learning of plastic synapses and basal ganglia selection, `bg_brain`
+        bool learning = true;
+        bool basalGanglia = true;
+
+        /// Threads of brain simulation
+        unsigned int numberOfThreads = 1;
+
+        /// Seed of noise and initial state, new seed if 0
+        uint64_t seed = 0;
+        
+        /// Scheduling of loop thread
+        ThreadSettings thread;
+    };
+
+    /// Durations of one stage in ms.
+    struct StageStatistics {
+        uint64_t overruns;
+        double lastMs;
+        double meanMs;
+        double maxMs;
+    };
+
+    struct Statistics {
+        uint64_t steps;
+
+        /// Steps which ended after due time of the next step
+        uint64_t periodOverruns;
+
+        /// Due times which were skipped because step started more than a period late
+        uint64_t skippedSteps;
+
+        /// Delay of step start after its due time, in ms
+        double lastJitterMs;
+        double meanJitterMs;
+        double maxJitterMs;
+
+        /// Duration of whole step, in ms
+        double lastStepMs;
+        double meanStepMs;
+        double maxStepMs;
+
+        StageStatistics stages[NumberOfStages];
+    };
+
+    /// Outputs of the last step.
+    struct State {
+        uint64_t step;
+
+        /// Nonzero for neurons which fired in the step, `firing`
+        std::vector<uint8_t> firing;
+
+        MotorCommand motorCommand;
+
+        /// Sensor values used by the step, `vis_pref_vals` and `this_distance`
+        double visualPreferences[ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes];
+        bool hasVisualPreferences;
+        uint64_t frameSequence;
+        double distance;
+
+        /// Selected network of basal ganglia, 0 if there is no selection
+        double selectedNetwork;
+    };
+
+private:
+
+    NeuroRobotManager *robot;
+
+    BrainDescription brain;
+    Settings settings;
+
+    /// Guards `simulation` and `reward`, brain stage holds it for the whole simulation
+    std::mutex brainMutex;
+    BrainSimulation simulation;
+    double reward = 0;
+
+    /// Guards `state` and `statistics`, held only for copying
+    std::mutex stateMutex;
+    State state;
+    Statistics statistics;
+
+    std::thread thread;
+    std::atomic<bool> running;
+    std::string threadSettingsError;
+
+    /// Buffers of one step, kept between steps
+    SharedMemorySnapshot snapshot;
+    std::vector<double> sensoryCurrent;
+    std::vector<uint8_t> spikes;
+    std::vector<double> currents;
+    std::vector<uint8_t> firing;
+    std::vector<double> stepsSinceLastSpike;
+    std::vector<SynapticPlasticity::Change> changes;
+
+    /// Applies scheduling, reports result and runs steps until stopped.
+    void run(std::promise<std::string> *settingsApplied);
+
+    /// Runs all stages of one step and returns duration of every stage.
+    void runStep(double stageMs[NumberOfStages]);
+
+    /// Adds timing of finished step to statistics.
+    void addStatistics(double jitterMs, double stepMs, const double stageMs[NumberOfStages], bool periodOverrun, uint64_t skippedSteps);
+
+    /// `this_distance` from serial data of robot, `rak_get_serial.m`.
+    static double distanceFromSerial(const std::string &serialData);
+
+    /// Serial command of motors, `update_motors.m`.
+    static std::string serialCommand(const MotorCommand &command);
+
+public:
+
+    /// @param robot Robot which is sensed and driven, has to outlive the loop
+    ControlLoop(NeuroRobotManager *robot);
+
+    ~ControlLoop();
+
+    /// Loads brain and starts steps on own thread. Running loop is stopped first.
+    /// @param brainPath Brain image (.nrb) or .mat brain, e.g. saved by `save_brain.m`
+    /// @param settings Period, deadlines and simulation settings
+    /// @param error Reason when loop cannot start
+    /// @return True on success
+    bool start(const std::string &brainPath, const Settings &settings, std::string &error);
+
+    /// Stops steps, returns after the current step is finished.
+    void stop();
+
+    /// @return Whether steps are running
+    bool isRunning();
+    
+    /// Reason why scheduling of the loop thread could not be applied, empty on success.
+    const std::string &readThreadSettingsError();
+
+    /// Timing of all steps since start.
+    void readStatistics(Statistics &statistics);
+
+    /// Outputs of the last step.
+    void readState(State &state);
+
+    /// Read neuron state, between steps.
+    /// @param v Buffer for membrane potential, `numberOfNeurons()` values
+    /// @param u Buffer for recovery variable, `numberOfNeurons()` values
+    void readNeurons(double *v, double *u);
+
+    /// Read synaptic weights, between steps.
+    /// @param weights Buffer for column-major `numberOfNeurons()` x `numberOfNeurons()` matrix
+    void readConnectome(double *weights);
+
+    /// Replace synaptic weights before the next step, clamped to `max_w`. Plastic synapses keep what they learned, their weights are taken from `weights`.
+    /// @param weights Column-major `numberOfNeurons()` x `numberOfNeurons()` matrix, `weights(pre, post)`
+    void setConnectome(const double *weights);
+
+    /// Reward of the next step, used by basal ganglia selection and by learning, like `enter_reward.m`.
+    void setReward(double reward);
+
+    /// Number of neurons of the loaded brain.
+    size_t numberOfNeurons();
+};
+
+#endif /* ControlLoop_h */
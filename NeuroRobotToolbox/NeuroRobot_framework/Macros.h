@@ -16,4 +16,14 @@
     #define MATLAB
 #endif
 
+/// Most detailed level of log messages which is compiled in, see `LogLevel` in Log.h.
+/// Messages above it are removed with their arguments, 0 removes all messages.
+#ifndef LOG_LEVEL
+    #ifdef DEBUG
+        #define LOG_LEVEL 5
+    #else
+        #define LOG_LEVEL 0
+    #endif
+#endif
+
 #endif // ! _Macros_h
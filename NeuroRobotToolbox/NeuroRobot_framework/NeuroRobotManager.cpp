@@ -9,29 +9,87 @@
 #include "NeuroRobotManager.h"
 
 #include <iostream>
+#include <future>
 #include <boost/thread/thread.hpp>
 
-NeuroRobotManager::NeuroRobotManager(std::string ipAddress, std::string port, StreamErrorOccurredCallback streamCallback, SocketErrorOccurredCallback socketCallback)
+NeuroRobotManager::NeuroRobotManager(std::string ipAddress, std::string port, StreamErrorOccurredCallback streamCallback, SocketErrorOccurredCallback socketCallback, std::string videoUrl, bool fastStart)
 : Log("NeuroRobotManager")
 {
+    sharedMemoryObject = new SharedMemory();
+    RobotStatistics::StageTimer startupTimer(&sharedMemoryObject->statistics, RobotStatistics::StageStartup);
+    
+    /// Serial socket connects on its own thread while stream is opened, so startup takes the longer of them, not their sum
+    std::future<Socket *> socketConnected;
+    if (!socketBlocked && !socketObject) {
+        socketConnected = std::async(std::launch::async, [=] {
+            return new Socket(ipAddress, port, sharedMemoryObject, socketCallback);
+        });
+    }
+    
     if (!videoAndAudioObtainerObject) {
-        videoAndAudioObtainerObject = new VideoAndAudioObtainer(ipAddress, streamCallback, audioBlocked);
+        videoAndAudioObtainerObject = new VideoAndAudioObtainer(ipAddress, sharedMemoryObject, streamCallback, audioBlocked, videoUrl, fastStart);
     }
     
-    if (videoAndAudioObtainerObject->stateType == StreamStateNotStarted && !socketBlocked && !socketObject) {
-        socketObject = new Socket(ipAddress, port, socketCallback);
+    if (socketConnected.valid()) {
+        socketObject = socketConnected.get();
+        
+        /// Robot without stream is not used, its serial connection is closed
+        if (videoAndAudioObtainerObject->stateType != StreamStateNotStarted) {
+            delete socketObject;
+            socketObject = NULL;
+        }
     }
+    
+    RobotStatistics &statistics = sharedMemoryObject->statistics;
+    LOG_INFO("init >>> stream open [ms]: " + std::to_string(statistics.stageSummary(RobotStatistics::StageStreamOpen).maxUs / 1000.0)
+        + " >>> serial connect [ms]: " + std::to_string(statistics.stageSummary(RobotStatistics::StageSerialConnect).maxUs / 1000.0));
+}
+
+NeuroRobotManager::~NeuroRobotManager()
+{
+    delete socketObject;
+    delete videoAndAudioObtainerObject;
+    delete sharedMemoryObject;
 }
 
 void NeuroRobotManager::start()
 {
+    if (!videoAndAudioObtainerObject) { return; }
+    
     videoAndAudioObtainerObject->startThreaded();
     if (socketObject && !socketBlocked) {
         socketObject->startThreaded();
     }
+    
+    std::string error = readThreadSettingsError();
+    if (!error.empty()) {
+        LOG_WARNING("start >>> " + error);
+    }
 //    boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
 }
 
+void NeuroRobotManager::setThreadSettings(const ThreadSettings &decodeSettings, const ThreadSettings &socketSettings)
+{
+    if (!videoAndAudioObtainerObject) { return; }
+    
+    videoAndAudioObtainerObject->setThreadSettings(decodeSettings);
+    if (socketObject) {
+        socketObject->setThreadSettings(socketSettings);
+    }
+}
+
+std::string NeuroRobotManager::readThreadSettingsError()
+{
+    std::string error;
+    if (videoAndAudioObtainerObject && !videoAndAudioObtainerObject->readThreadSettingsError().empty()) {
+        error = "decode worker: " + videoAndAudioObtainerObject->readThreadSettingsError();
+    }
+    if (socketObject && !socketObject->readThreadSettingsError().empty()) {
+        error += (error.empty() ? "" : ", ") + std::string("socket worker: ") + socketObject->readThreadSettingsError();
+    }
+    return error;
+}
+
 void *NeuroRobotManager::readAudio(size_t *totalBytes, unsigned short *bytesPerSample)
 {
     *totalBytes = 0;
@@ -39,13 +97,76 @@ void *NeuroRobotManager::readAudio(size_t *totalBytes, unsigned short *bytesPerS
     
     if (audioBlocked) { return nullptr; }
     
-    void *reply = SharedMemory::getInstance()->readAudio(totalBytes, bytesPerSample);
+    void *reply = sharedMemoryObject->readAudio(totalBytes, bytesPerSample);
     return reply;
 }
 
+void NeuroRobotManager::readAudio(void *destination, size_t capacity, size_t *totalBytes, unsigned short *bytesPerSample)
+{
+    *totalBytes = 0;
+    *bytesPerSample = 0;
+    
+    if (audioBlocked) { return; }
+    
+    sharedMemoryObject->readAudio((uint8_t *)destination, capacity, totalBytes, bytesPerSample);
+}
+
 uint8_t *NeuroRobotManager::readVideoFrame()
 {
-    return SharedMemory::getInstance()->readVideoFrame();
+    return sharedMemoryObject->readVideoFrame();
+}
+
+size_t NeuroRobotManager::readVideoFrame(uint8_t *destination, size_t capacity)
+{
+    return sharedMemoryObject->readVideoFrame(destination, capacity);
+}
+
+void NeuroRobotManager::readSnapshot(uint8_t *frameDestination, size_t frameCapacity, void *audioDestination, size_t audioCapacity, SharedMemorySnapshot *snapshot)
+{
+    if (audioBlocked) { audioDestination = NULL; }
+    
+    sharedMemoryObject->readSnapshot(frameDestination, frameCapacity, (uint8_t *)audioDestination, audioCapacity, snapshot);
+    
+    if (socketBlocked) { snapshot->serialData.clear(); }
+}
+
+size_t NeuroRobotManager::audioCapacityBytes()
+{
+    return sharedMemoryObject->audioCapacityBytes();
+}
+
+uint64_t NeuroRobotManager::waitForFrame(uint64_t lastSequence, unsigned int timeoutMs)
+{
+    return sharedMemoryObject->waitForFrame(lastSequence, timeoutMs);
+}
+
+uint64_t NeuroRobotManager::videoFrameCounter(std::chrono::steady_clock::time_point *packetTime)
+{
+    return sharedMemoryObject->readFrameCounter(packetTime);
+}
+
+RobotStatistics &NeuroRobotManager::readStats()
+{
+    return sharedMemoryObject->statistics;
+}
+
+bool NeuroRobotManager::setColorBlobs(const ColorBlobs::Cut cuts[ColorBlobs::numberOfEyes], unsigned int height, unsigned int width, std::string &error)
+{
+    if (!videoAndAudioObtainerObject) { error = "Robot is stopped."; return false; }
+    
+    return videoAndAudioObtainerObject->colorBlobs.configure(cuts, height, width, error);
+}
+
+void NeuroRobotManager::disableColorBlobs()
+{
+    if (!videoAndAudioObtainerObject) { return; }
+    
+    videoAndAudioObtainerObject->colorBlobs.disable();
+}
+
+bool NeuroRobotManager::readVisualPreferences(double *values, uint64_t *frameSequence)
+{
+    return sharedMemoryObject->readVisualPreferences(values, frameSequence);
 }
 
 void NeuroRobotManager::stop()
@@ -60,32 +181,36 @@ void NeuroRobotManager::stop()
     
     delete socketObject;
     delete videoAndAudioObtainerObject;
+    socketObject = NULL;
+    videoAndAudioObtainerObject = NULL;
 }
 
 bool NeuroRobotManager::isRunning()
 {
+    if (!videoAndAudioObtainerObject) { return false; }
+    
     bool videoAndAudioStreamerLegalState = videoAndAudioObtainerObject->isRunning() && !(videoAndAudioObtainerObject->stateType >= 100);
     
     if (!socketBlocked) {
         
         if (!socketObject) {
-            logMessage("isRunning >> socketObject doesn't exist");
+            LOG_WARNING("isRunning >> socketObject doesn't exist");
             return false;
         }
         
         bool socketLegalState = socketObject->isRunning() && !(socketObject->stateType >= 100 && socketObject->stateType < 200);
         
         if (!videoAndAudioObtainerObject->isRunning()) {
-            logMessage("issue with videoAndAudioObtainerObject->isRunning()");
+            LOG_WARNING("issue with videoAndAudioObtainerObject->isRunning()");
         }
         if (videoAndAudioObtainerObject->stateType != StreamStateRunning) {
-            logMessage("issue with videoAndAudioObtainerObject->stateType: " + std::string(getStreamStateMessage(videoAndAudioObtainerObject->stateType)));
+            LOG_WARNING("issue with videoAndAudioObtainerObject->stateType: " + std::string(getStreamStateMessage(videoAndAudioObtainerObject->stateType)));
         }
         if (!socketObject->isRunning()) {
-            logMessage("issue with socketObject->isRunning()");
+            LOG_WARNING("issue with socketObject->isRunning()");
         }
         if (socketObject->stateType != SocketStateConnected) {
-            logMessage("issue with socketObject->stateType: " + std::string(getSocketStateMessage(socketObject->stateType)));
+            LOG_WARNING("issue with socketObject->stateType: " + std::string(getSocketStateMessage(socketObject->stateType)));
         }
         return videoAndAudioStreamerLegalState && socketLegalState;
     } else {
@@ -95,7 +220,7 @@ bool NeuroRobotManager::isRunning()
 
 void NeuroRobotManager::writeSerial(std::string data)
 {
-    if (socketBlocked) { return; }
+    if (socketBlocked || !socketObject) { return; }
     
     socketObject->send(data);
 }
@@ -112,49 +237,58 @@ char *NeuroRobotManager::readSerial(size_t *totalBytes)
     *totalBytes = 0;
     if (socketBlocked) { return nullptr; }
     
-    return SharedMemory::getInstance()->getSerialData(totalBytes);
+    return sharedMemoryObject->getSerialData(totalBytes);
+}
+
+size_t NeuroRobotManager::readSerial(char *destination, size_t capacity)
+{
+    if (socketBlocked) { return 0; }
+    
+    return sharedMemoryObject->getSerialData(destination, capacity);
 }
 
 void NeuroRobotManager::sendAudio(int16_t *data, size_t totalBytes)
 {
-    if (socketBlocked) { return; }
+    if (socketBlocked || !socketObject) { return; }
     
     socketObject->sendAudio(data, totalBytes);
 }
 
 StreamStateType NeuroRobotManager::readStreamState()
 {
+    if (!videoAndAudioObtainerObject) { return StreamStateStopped; }
+    
     return videoAndAudioObtainerObject->stateType;
 }
 
 SocketStateType NeuroRobotManager::readSocketState()
 {
-    if (socketBlocked) { return SocketStateNotInitialized; }
+    if (socketBlocked || !socketObject) { return SocketStateNotInitialized; }
     
     return socketObject->stateType;
 }
 
 size_t NeuroRobotManager::videoFrameBytes()
 {
-    return SharedMemory::getInstance()->frameTotalBytes;
+    return sharedMemoryObject->frameTotalBytes;
 }
 
 size_t NeuroRobotManager::audioBytes()
 {
-    return SharedMemory::getInstance()->audioTotalBytes;
+    return sharedMemoryObject->audioTotalBytes;
 }
 
 unsigned int NeuroRobotManager::audioSampleRate()
 {
-    return SharedMemory::getInstance()->audioSampleRate;
+    return sharedMemoryObject->audioSampleRate;
 }
 
 unsigned int NeuroRobotManager::videoWidth()
 {
-    return SharedMemory::getInstance()->videoWidth;
+    return sharedMemoryObject->videoWidth;
 }
 
 unsigned int NeuroRobotManager::videoHeight()
 {
-    return SharedMemory::getInstance()->videoHeight;
+    return sharedMemoryObject->videoHeight;
 }
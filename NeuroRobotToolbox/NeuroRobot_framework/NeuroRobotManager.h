@@ -21,12 +21,16 @@
 #endif
 
 /// Base `Neuro Robot` API class.
-/// It is intended to have only one statically allocated object of this class and whole communication with robot will be executed through that object.
+/// One object of this class drives one robot and whole communication with that robot will be executed through that object.
+/// Several objects can live in the same process, each one owns its own shared memory and workers.
 class NeuroRobotManager: public Log
 {
     
 private:
     
+    /// Storage for data obtained by workers.
+    SharedMemory *sharedMemoryObject = NULL;
+    
     /// Video/Audio worker.
     VideoAndAudioObtainer *videoAndAudioObtainerObject = NULL;
     
@@ -44,26 +48,100 @@ private:
 public:
 
     /// Init workers to communicate with robot.
+    /// Stream is opened and serial socket connected in parallel, returns when both are connected or failed.
+    /// Durations are in `streamOpen`, `serialConnect` and `startup` stages of `readStats()`.
+    /// @warning Socket callback can be called from another thread during init
     /// @param ipAddress IP address of robot
     /// @param port Port used for serial communication
     /// @param streamCallback Stream callback for notifying about errors while obtaining video and audio data
     /// @param socketCallback Socket callback for notifying about errors while communicating through socket
-    NeuroRobotManager(std::string ipAddress, std::string port, StreamErrorOccurredCallback streamCallback, SocketErrorOccurredCallback socketCallback);
+    /// @param videoUrl URL or file path of the video stream. If empty, robot's RTSP stream on `ipAddress` is used
+    /// @param fastStart Flag whether to open the stream with minimal probing, using parameters of the last connection to the same robot, kept on disk between sessions
+    NeuroRobotManager(std::string ipAddress, std::string port, StreamErrorOccurredCallback streamCallback, SocketErrorOccurredCallback socketCallback, std::string videoUrl = "", bool fastStart = false);
+    
+    ~NeuroRobotManager();
     
     /// Start the video, audio and serial data workers.
     void start();
     
+    /// Scheduling of workers, applied by the next `start()`.
+    /// @param decodeSettings Video/audio worker, which reads and decodes the stream
+    /// @param socketSettings Socket worker, which receives serial data
+    void setThreadSettings(const ThreadSettings &decodeSettings, const ThreadSettings &socketSettings);
+    
+    /// Reasons why scheduling of started workers could not be applied.
+    /// @return Empty string if all settings are applied
+    std::string readThreadSettingsError();
+    
     /// Read audio from shared memory object.
     /// @param totalBytes Total number of bytes forwarded parallel
     /// @param bytesPerSample Number of bytes per one sample
     /// @return Pointer to audio data
     void *readAudio(size_t *totalBytes, unsigned short *bytesPerSample);
     
+    /// Read audio from shared memory object directly to forwarded buffer.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes
+    /// @param totalBytes Total number of copied bytes
+    /// @param bytesPerSample Number of bytes per one sample
+    void readAudio(void *destination, size_t capacity, size_t *totalBytes, unsigned short *bytesPerSample);
+    
     /// Read video frame from shared memory object.
     /// @return Pointer to frame data
     uint8_t *readVideoFrame();
     
-    /// Stop video, audio and serial data workers.
+    /// Copy video frame from shared memory object to forwarded buffer.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes
+    /// @return Number of copied bytes, 0 if there is no frame or the buffer is too small
+    size_t readVideoFrame(uint8_t *destination, size_t capacity);
+    
+    /// Read video, audio and serial data from shared memory object under one acquisition.
+    /// @param frameDestination Buffer for frame, frame is skipped if `NULL` or too small
+    /// @param frameCapacity Size of frame buffer in bytes
+    /// @param audioDestination Buffer for audio, audio is skipped if `NULL`
+    /// @param audioCapacity Size of audio buffer in bytes
+    /// @param snapshot Sizes, sequence numbers and serial data of the copied data
+    void readSnapshot(uint8_t *frameDestination, size_t frameCapacity, void *audioDestination, size_t audioCapacity, SharedMemorySnapshot *snapshot);
+    
+    /// Size of the biggest audio chunk which can be read at once.
+    /// @return Size in bytes
+    size_t audioCapacityBytes();
+    
+    /// Block current thread until frame newer than `lastSequence` is obtained or timeout expires.
+    /// @param lastSequence Sequence number of the last frame caller has seen, 0 at the beginning
+    /// @param timeoutMs Maximum waiting time in ms
+    /// @return Sequence number of the newest frame, equal to `lastSequence` on timeout
+    uint64_t waitForFrame(uint64_t lastSequence, unsigned int timeoutMs);
+    
+    /// Compute colour preferences of both eyes from every obtained frame, see `ColorBlobs`.
+    /// @param cuts Part of frame of left and right eye, `left_cut` and `right_cut`
+    /// @param height Height of resized eye
+    /// @param width Width of resized eye
+    /// @param error Reason when settings are invalid
+    /// @return True on success
+    bool setColorBlobs(const ColorBlobs::Cut cuts[ColorBlobs::numberOfEyes], unsigned int height, unsigned int width, std::string &error);
+    
+    /// Stop computing colour preferences.
+    void disableColorBlobs();
+    
+    /// Read colour preferences of the last frame.
+    /// @param values Buffer for `ColorBlobs::numberOfValues` x `ColorBlobs::numberOfEyes` values
+    /// @param frameSequence Sequence number of the frame, if not `NULL`
+    /// @return False if preferences were not computed for the last frame
+    bool readVisualPreferences(double *values, uint64_t *frameSequence = NULL);
+    
+    /// Read number of frames obtained from robot.
+    /// @param packetTime Time when the packet of the last frame was read from the stream, if not `NULL`
+    /// @return Number of frames obtained since init
+    uint64_t videoFrameCounter(std::chrono::steady_clock::time_point *packetTime = NULL);
+    
+    /// Latencies of every stage and counters of events since init or the last reset.
+    /// Workers record all the time, summaries can be read and reset from any thread.
+    /// @return Statistics of robot, valid until the object is deleted
+    RobotStatistics &readStats();
+    
+    /// Stop video, audio and serial data workers. Workers are deleted, so only reading of shared memory and states works afterwards.
     void stop();
     
     /// Queries whether the video and audio obtainer is working.
@@ -84,6 +162,12 @@ public:
     /// @return Pointer to serial data
     char *readSerial(size_t *totalBytes);
     
+    /// Read serial data from stock directly to forwarded buffer.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes, longer data is truncated
+    /// @return Number of copied bytes
+    size_t readSerial(char *destination, size_t capacity);
+    
     /// Read state of video/audio worker.
     /// @return State of video/audio worker.
     /// @see `StreamStateType` enum for possible states
@@ -0,0 +1,492 @@
+//
+//  NeuroRobot_BrainBridge.cpp
+//  Neurorobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "Brain/BrainSimulation.h"
+#include "Brain/BrainImage.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <mex.h>
+
+#include "matrix.h"
+
+/**
+ Brain API class. It is intended to have only one statically allocated object of this class and all mex calls will be executed through that object.
+ Every brain is identified by the handle returned from `init`, which has to be the second input of all other commands.
+ */
+class NeuroRobot_Brain
+{
+private:
+
+    /// Brains created with `init`, identified by handle.
+    std::map<uint64_t, BrainSimulation *> brainObjects;
+
+    /// Handle which will be assigned to the next brain. Handles are never reused.
+    uint64_t nextHandle = 1;
+
+    /**
+     Finds the brain which handle is forwarded as second input
+     */
+    BrainSimulation *brainForHandle( int nrhs, const mxArray *prhs[], uint64_t *handle )
+    {
+        if (nrhs < 2 || !mxIsNumeric(prhs[1]) || mxGetNumberOfElements(prhs[1]) != 1) { mexErrMsgTxt("Second input should be a brain handle returned by init."); return NULL; }
+
+        *handle = (uint64_t)mxGetScalar(prhs[1]);
+        auto brain = brainObjects.find(*handle);
+        if (brain == brainObjects.end()) { mexErrMsgTxt("Invalid brain handle."); return NULL; }
+
+        return brain->second;
+    }
+
+    /**
+     Checks that input is a real double array with expected number of elements
+     */
+    const double *doubleInput( const mxArray *input, size_t numberOfElements, const char *errorMessage )
+    {
+        if (!mxIsDouble(input) || mxIsComplex(input) || mxGetNumberOfElements(input) != numberOfElements) { mexErrMsgTxt(errorMessage); return NULL; }
+        return mxGetPr(input);
+    }
+
+    /**
+     Reads brain image into `brain` struct, sparse sections become full arrays like in .mat brains
+     */
+    mxArray *loadImage( const char *path )
+    {
+        BrainImage image;
+        std::string error;
+        if (!image.open(path, error)) { mexErrMsgTxt(error.c_str()); return NULL; }
+
+        const std::vector<BrainImage::Section> &sections = image.getSections();
+        std::vector<const char *> names;
+        for (const BrainImage::Section &section : sections) {
+            names.push_back(section.name.c_str());
+        }
+        mxArray *brain = mxCreateStructMatrix(1, 1, (int)names.size(), names.data());
+
+        for (const BrainImage::Section &section : sections) {
+            mwSize dimensions[3] = { section.dimensions[0], section.dimensions[1], section.dimensions[2] };
+            mxClassID classId = section.type == BrainImage::SectionTypeLogical ? mxLOGICAL_CLASS : mxDOUBLE_CLASS;
+            mxArray *field = mxCreateNumericArray(section.numberOfDimensions, dimensions, classId, mxREAL);
+
+            if (section.sparse) {
+                double *values = mxGetPr(field);
+                const size_t rows = section.dimensions[0];
+                const size_t columns = section.dimensions[1] * section.dimensions[2];
+                for (size_t column = 0; column < columns; column++) {
+                    for (size_t i = section.columnPointers[column]; i < section.columnPointers[column + 1]; i++) {
+                        values[column * rows + section.rowIndices[i]] = section.values[i];
+                    }
+                }
+            } else if (section.numberOfElements()) {
+                size_t elementSize = section.type == BrainImage::SectionTypeLogical ? 1 : sizeof(double);
+                std::memcpy(mxGetData(field), section.data, section.numberOfElements() * elementSize);
+            }
+            mxSetField(brain, 0, section.name.c_str(), field);
+        }
+        return brain;
+    }
+
+    /**
+     Writes double and logical fields of `brain` struct as brain image, other fields (e.g. `network`) are not saved
+     */
+    void saveImage( const char *path, const mxArray *brain )
+    {
+        if (!mxIsStruct(brain)) { mexErrMsgTxt("Brain must be a struct."); return; }
+
+        BrainImageWriter writer;
+        for (int i = 0; i < mxGetNumberOfFields(brain); i++) {
+            const mxArray *field = mxGetFieldByNumber(brain, 0, i);
+            if (!field || !(mxIsDouble(field) || mxIsLogical(field)) || mxIsComplex(field) || mxGetNumberOfDimensions(field) > 3) { continue; }
+
+            const mwSize *fieldDimensions = mxGetDimensions(field);
+            size_t dimensions[3] = { fieldDimensions[0], fieldDimensions[1], mxGetNumberOfDimensions(field) > 2 ? fieldDimensions[2] : 1 };
+            const char *name = mxGetFieldNameByNumber(brain, i);
+            if (mxIsSparse(field)) {
+                if (!mxIsDouble(field)) { continue; }
+                writer.addSparseDoubles(name, dimensions, mxGetJc(field), mxGetIr(field), mxGetPr(field));
+            } else if (mxIsDouble(field)) {
+                writer.addDoubles(name, dimensions, mxGetPr(field));
+            } else {
+                writer.addLogicals(name, dimensions, (const uint8_t *)mxGetLogicals(field));
+            }
+        }
+
+        std::string error;
+        if (!writer.write(path, error)) { mexErrMsgTxt(error.c_str()); }
+    }
+
+    /**
+     Spikes as MATLAB columns of neurons and ms, both from 1
+     */
+    void spikesOutput( int nlhs, mxArray *plhs[], const std::vector<uint32_t> &neurons, const std::vector<uint64_t> &times )
+    {
+        plhs[0] = mxCreateDoubleMatrix(neurons.size(), 1, mxREAL);
+        double *neuronOutput = mxGetPr(plhs[0]);
+        for (size_t i = 0; i < neurons.size(); i++) {
+            neuronOutput[i] = neurons[i] + 1;
+        }
+        if (nlhs > 1) {
+            plhs[1] = mxCreateDoubleMatrix(times.size(), 1, mxREAL);
+            double *timeOutput = mxGetPr(plhs[1]);
+            for (size_t i = 0; i < times.size(); i++) {
+                timeOutput[i] = (double)times[i] + 1;
+            }
+        }
+    }
+
+    /**
+     Ms window from 1-based inclusive MATLAB inputs `from_ms` and `to_ms`, whole recording without them
+     */
+    void windowInput( int nrhs, const mxArray *prhs[], int firstInput, uint64_t *fromMs, uint64_t *toMs )
+    {
+        *fromMs = 0;
+        *toMs = UINT64_MAX;
+        if (nrhs > firstInput) {
+            double from = mxGetScalar(prhs[firstInput]);
+            *fromMs = from > 1 ? (uint64_t)from - 1 : 0;
+        }
+        if (nrhs > firstInput + 1) {
+            double to = mxGetScalar(prhs[firstInput + 1]);
+            *toMs = to >= (double)UINT64_MAX ? UINT64_MAX : (to > 0 ? (uint64_t)to : 0);
+        }
+    }
+
+public:
+
+    /**
+     Executing mex comamnd from MATLAB
+     */
+    void processMexCall( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+    {
+        char cmd[64];
+
+        // Gets the command string
+        if (nrhs < 1 || mxGetString(prhs[0], cmd, sizeof(cmd))) { mexErrMsgTxt("First input should be a command string less than 64 characters long."); return; }
+
+        if ( !strcmp("init", cmd) ) {
+
+            uint64_t handle = nextHandle++;
+            brainObjects[handle] = new BrainSimulation();
+
+            plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+            uint64_t *yp;
+            yp  = (uint64_t*) mxGetData(plhs[0]);
+            std::memcpy(yp, &handle, sizeof(uint64_t));
+            return;
+        }
+
+        if ( !strcmp("readSpikeFile", cmd) ) {
+            if (nrhs < 2 || !mxIsChar(prhs[1])) { mexErrMsgTxt("Second input should be a path of spike file."); return; }
+
+            char *path = mxArrayToString(prhs[1]);
+            uint64_t fromMs, toMs;
+            windowInput(nrhs, prhs, 2, &fromMs, &toMs);
+            std::vector<uint32_t> neurons;
+            std::vector<uint64_t> times;
+            std::string error;
+            bool loaded = SpikeRecorder::readFile(path, fromMs, toMs, neurons, times, error);
+            mxFree(path);
+            if (!loaded) { mexErrMsgTxt(error.c_str()); return; }
+
+            spikesOutput(nlhs, plhs, neurons, times);
+            return;
+        }
+
+        if ( !strcmp("loadImage", cmd) || !strcmp("saveImage", cmd) ) {
+            if (nrhs < 2 || !mxIsChar(prhs[1])) { mexErrMsgTxt("Second input should be a path of brain image."); return; }
+
+            char *path = mxArrayToString(prhs[1]);
+            if (!strcmp("loadImage", cmd)) {
+                plhs[0] = loadImage(path);
+            } else if (nrhs < 3) {
+                mexErrMsgTxt("Missing brain input.");
+            } else {
+                saveImage(path, prhs[2]);
+            }
+            mxFree(path);
+            return;
+        }
+
+        uint64_t handle = 0;
+        BrainSimulation *brainObject = brainForHandle(nrhs, prhs, &handle);
+
+        if ( !strcmp("setNeurons", cmd) ) {
+            if (nrhs < 8) { mexErrMsgTxt("Missing a, b, c, d, v and u inputs."); return; }
+
+            size_t numberOfNeurons = mxGetNumberOfElements(prhs[2]);
+            const double *a = doubleInput(prhs[2], numberOfNeurons, "a must be a double vector.");
+            const double *b = doubleInput(prhs[3], numberOfNeurons, "b must be a double vector of the same length as a.");
+            const double *c = doubleInput(prhs[4], numberOfNeurons, "c must be a double vector of the same length as a.");
+            const double *d = doubleInput(prhs[5], numberOfNeurons, "d must be a double vector of the same length as a.");
+            const double *v = doubleInput(prhs[6], numberOfNeurons, "v must be a double vector of the same length as a.");
+            const double *u = doubleInput(prhs[7], numberOfNeurons, "u must be a double vector of the same length as a.");
+
+            brainObject->setNeurons(numberOfNeurons, a, b, c, d, v, u);
+            return;
+        } else if ( !strcmp("getState", cmd) ) {
+
+            size_t numberOfNeurons = brainObject->size();
+            plhs[0] = mxCreateDoubleMatrix(numberOfNeurons, 1, mxREAL);
+            mxArray *u = mxCreateDoubleMatrix(numberOfNeurons, 1, mxREAL);
+            brainObject->getState(mxGetPr(plhs[0]), mxGetPr(u));
+
+            if (nlhs > 1) {
+                plhs[1] = u;
+            } else {
+                mxDestroyArray(u);
+            }
+            return;
+        } else if ( !strcmp("setConnectome", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing connectome input."); return; }
+
+            size_t numberOfNeurons = brainObject->size();
+            if (mxIsSparse(prhs[2])) {
+                /// Sparse connectome is taken without expanding it to dense
+                if (!mxIsDouble(prhs[2]) || mxGetM(prhs[2]) != numberOfNeurons || mxGetN(prhs[2]) != numberOfNeurons) { mexErrMsgTxt("Connectome must be a double nneurons x nneurons matrix."); return; }
+                brainObject->setSparseConnectome(mxGetJc(prhs[2]), mxGetIr(prhs[2]), mxGetPr(prhs[2]));
+                return;
+            }
+
+            const double *weights = doubleInput(prhs[2], numberOfNeurons * numberOfNeurons, "Connectome must be a double nneurons x nneurons matrix.");
+
+            brainObject->setConnectome(weights);
+            return;
+        } else if ( !strcmp("getConnectome", cmd) ) {
+
+            size_t numberOfNeurons = brainObject->size();
+            plhs[0] = mxCreateDoubleMatrix(numberOfNeurons, numberOfNeurons, mxREAL);
+            brainObject->getConnectome(mxGetPr(plhs[0]));
+            return;
+        } else if ( !strcmp("setPlasticity", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing da_connectome input."); return; }
+
+            size_t numberOfNeurons = brainObject->size();
+            const mwSize *dimensions = mxGetDimensions(prhs[2]);
+            if (mxGetNumberOfDimensions(prhs[2]) != 3 || dimensions[0] != numberOfNeurons || dimensions[1] != numberOfNeurons || dimensions[2] != 3) { mexErrMsgTxt("da_connectome must be a double nneurons x nneurons x 3 array."); return; }
+            const double *daConnectome = doubleInput(prhs[2], numberOfNeurons * numberOfNeurons * 3, "da_connectome must be a double nneurons x nneurons x 3 array.");
+
+            brainObject->setPlasticity(daConnectome);
+
+            /// Linear indices of plastic synapses, order of weights returned by `learn`
+            if (nlhs > 0) {
+                SynapticPlasticity &plasticity = brainObject->getPlasticity();
+                plhs[0] = mxCreateDoubleMatrix(plasticity.size(), 1, mxREAL);
+                double *indices = mxGetPr(plhs[0]);
+                for (size_t i = 0; i < plasticity.size(); i++) {
+                    indices[i] = (double)plasticity.postsynapticNeuron(i) * numberOfNeurons + plasticity.presynapticNeuron(i) + 1;
+                }
+            }
+            return;
+        } else if ( !strcmp("learn", cmd) ) {
+            if (nrhs < 9) { mexErrMsgTxt("Missing firing, steps_since_last_spike, reward, pulse_period, ltp_recency_th_in_steps, permanent_memory_th and max_w inputs."); return; }
+
+            size_t numberOfNeurons = brainObject->size();
+            if (mxGetNumberOfElements(prhs[2]) != numberOfNeurons || !(mxIsLogical(prhs[2]) || mxIsDouble(prhs[2]))) { mexErrMsgTxt("Firing must be a logical or double vector with nneurons elements."); return; }
+            std::vector<uint8_t> firing(numberOfNeurons);
+            for (size_t i = 0; i < numberOfNeurons; i++) {
+                firing[i] = mxIsLogical(prhs[2]) ? mxGetLogicals(prhs[2])[i] : mxGetPr(prhs[2])[i] != 0;
+            }
+            const double *stepsSinceLastSpike = doubleInput(prhs[3], numberOfNeurons, "steps_since_last_spike must be a double vector with nneurons elements.");
+
+            SynapticPlasticity::Parameters parameters;
+            double reward = mxGetScalar(prhs[4]);
+            parameters.pulsePeriod = mxGetScalar(prhs[5]);
+            parameters.ltpRecencyThreshold = mxGetScalar(prhs[6]);
+            parameters.permanentMemoryThreshold = mxGetScalar(prhs[7]);
+            parameters.maxWeight = mxGetScalar(prhs[8]);
+
+            std::vector<SynapticPlasticity::Change> changes;
+            brainObject->learn(firing.data(), stepsSinceLastSpike, reward, parameters, changes);
+
+            /// Synapses which rounded weight changed, [presynaptic postsynaptic weight cause] rows, neurons are 1-based
+            plhs[0] = mxCreateDoubleMatrix(changes.size(), 4, mxREAL);
+            double *changed = mxGetPr(plhs[0]);
+            for (size_t i = 0; i < changes.size(); i++) {
+                changed[i] = changes[i].presynapticNeuron + 1;
+                changed[changes.size() + i] = changes[i].postsynapticNeuron + 1;
+                changed[2 * changes.size() + i] = changes[i].weight;
+                changed[3 * changes.size() + i] = changes[i].cause;
+            }
+
+            /// All plastic weights and intensities, to keep MATLAB connectome and da_connectome in sync
+            SynapticPlasticity &plasticity = brainObject->getPlasticity();
+            if (nlhs > 1) {
+                plhs[1] = mxCreateDoubleMatrix(plasticity.size(), 1, mxREAL);
+                std::copy(plasticity.getWeights().begin(), plasticity.getWeights().end(), mxGetPr(plhs[1]));
+            }
+            if (nlhs > 2) {
+                plhs[2] = mxCreateDoubleMatrix(plasticity.size(), 1, mxREAL);
+                std::copy(plasticity.getIntensities().begin(), plasticity.getIntensities().end(), mxGetPr(plhs[2]));
+            }
+            return;
+        } else if ( !strcmp("setBasalGanglia", cmd) ) {
+            if (nrhs < 6) { mexErrMsgTxt("Missing network_ids, bg_neurons, network_drive and bg_brain inputs."); return; }
+
+            size_t numberOfNeurons = brainObject->size();
+            const double *networkIds = doubleInput(prhs[2], numberOfNeurons, "network_ids must be a double vector with nneurons elements.");
+            if (mxGetNumberOfElements(prhs[3]) != numberOfNeurons || !(mxIsLogical(prhs[3]) || mxIsDouble(prhs[3]))) { mexErrMsgTxt("bg_neurons must be a logical or double vector with nneurons elements."); return; }
+            std::vector<double> basalGangliaNeurons(numberOfNeurons);
+            for (size_t i = 0; i < numberOfNeurons; i++) {
+                basalGangliaNeurons[i] = mxIsLogical(prhs[3]) ? mxGetLogicals(prhs[3])[i] : mxGetPr(prhs[3])[i];
+            }
+            if (!mxIsDouble(prhs[4]) || mxGetN(prhs[4]) != 3) { mexErrMsgTxt("network_drive must be a double nnetworks x 3 matrix."); return; }
+
+            brainObject->setBasalGanglia(networkIds, basalGangliaNeurons.data(), mxGetM(prhs[4]), mxGetPr(prhs[4]), mxGetScalar(prhs[5]) != 0);
+            return;
+        } else if ( !strcmp("getSelection", cmd) ) {
+
+            BasalGanglia &basalGanglia = brainObject->getBasalGanglia();
+            size_t numberOfNetworks = basalGanglia.size();
+            plhs[0] = mxCreateDoubleScalar(basalGanglia.getSelectedNetwork());
+
+            if (nlhs > 1) {
+                plhs[1] = mxCreateDoubleMatrix(numberOfNetworks, 3, mxREAL);
+                std::copy(basalGanglia.getDrive().begin(), basalGanglia.getDrive().end(), mxGetPr(plhs[1]));
+            }
+            if (nlhs > 2) {
+                plhs[2] = mxCreateDoubleMatrix(numberOfNetworks, 1, mxREAL);
+                std::copy(basalGanglia.getActivityChanges().begin(), basalGanglia.getActivityChanges().end(), mxGetPr(plhs[2]));
+            }
+            if (nlhs > 3) {
+                size_t numberOfNeurons = brainObject->size();
+                plhs[3] = mxCreateLogicalMatrix(numberOfNeurons, 1);
+                mxLogical *down = mxGetLogicals(plhs[3]);
+                for (size_t i = 0; i < numberOfNeurons; i++) {
+                    down[i] = basalGanglia.isSet() && basalGanglia.isDown((uint32_t)i);
+                }
+            }
+            return;
+        } else if ( !strcmp("setRecording", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing recording input."); return; }
+
+            brainObject->setRecording(mxGetScalar(prhs[2]) != 0);
+            SpikeRecorder *recorder = brainObject->getSpikeRecorder();
+            if (!recorder) { return; }
+
+            if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+                recorder->setRetention((uint64_t)mxGetScalar(prhs[3]), 64 << 20);
+            }
+            if (nrhs > 4) {
+                if (!mxIsChar(prhs[4])) { mexErrMsgTxt("File must be a path."); return; }
+                char *path = mxArrayToString(prhs[4]);
+                std::string error;
+                bool opened = recorder->setFile(path, error);
+                mxFree(path);
+                if (!opened) { mexErrMsgTxt(error.c_str()); return; }
+            }
+            return;
+        } else if ( !strcmp("getSpikes", cmd) ) {
+
+            SpikeRecorder *recorder = brainObject->getSpikeRecorder();
+            uint64_t fromMs, toMs;
+            windowInput(nrhs, prhs, 2, &fromMs, &toMs);
+            std::vector<uint32_t> neurons;
+            std::vector<uint64_t> times;
+            if (recorder) {
+                recorder->window(fromMs, toMs, neurons, times);
+            }
+
+            spikesOutput(nlhs, plhs, neurons, times);
+            if (nlhs > 2) {
+                plhs[2] = mxCreateDoubleScalar(recorder ? (double)recorder->now() : 0);
+            }
+            return;
+        } else if ( !strcmp("getRecordedMs", cmd) ) {
+
+            SpikeRecorder *recorder = brainObject->getSpikeRecorder();
+            plhs[0] = mxCreateDoubleScalar(recorder ? (double)recorder->now() : 0);
+            if (nlhs > 1) {
+                plhs[1] = mxCreateDoubleScalar(recorder ? (double)recorder->memoryUsage() : 0);
+            }
+            return;
+        } else if ( !strcmp("setSeed", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing seed input."); return; }
+
+            /// uint64 seeds are taken whole, doubles are exact up to 2^53
+            uint64_t seed = 0;
+            if (mxIsUint64(prhs[2]) && !mxIsEmpty(prhs[2])) {
+                std::memcpy(&seed, mxGetData(prhs[2]), sizeof(uint64_t));
+            } else {
+                seed = (uint64_t)mxGetScalar(prhs[2]);
+            }
+            brainObject->setSeed(seed);
+            return;
+        } else if ( !strcmp("getSeed", cmd) ) {
+
+            uint64_t seed = brainObject->getSeed();
+            plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+            std::memcpy(mxGetData(plhs[0]), &seed, sizeof(uint64_t));
+            return;
+        } else if ( !strcmp("setNumberOfThreads", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing number of threads input."); return; }
+
+            brainObject->setNumberOfThreads((unsigned int)mxGetScalar(prhs[2]));
+            if (nlhs > 0) {
+                plhs[0] = mxCreateDoubleScalar(brainObject->numberOfThreads());
+            }
+            return;
+        } else if ( !strcmp("setSinglePrecision", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing single precision input."); return; }
+
+            brainObject->setSinglePrecision(mxGetScalar(prhs[2]) != 0);
+            return;
+        } else if ( !strcmp("step", cmd) ) {
+            if (nrhs < 4) { mexErrMsgTxt("Missing ms per step and sensory current inputs."); return; }
+
+            size_t numberOfNeurons = brainObject->size();
+            unsigned int msPerStep = (unsigned int)mxGetScalar(prhs[2]);
+
+            /// Sensory currents are columns which are added in order, e.g. `[vis_I dist_I audio_I]`
+            size_t numberOfSensoryInputs = 0;
+            const double *sensoryCurrent = NULL;
+            if (!mxIsEmpty(prhs[3])) {
+                if (!mxIsDouble(prhs[3]) || mxIsComplex(prhs[3]) || mxGetM(prhs[3]) != numberOfNeurons) { mexErrMsgTxt("Sensory current must be a double matrix with nneurons rows."); return; }
+                numberOfSensoryInputs = mxGetN(prhs[3]);
+                sensoryCurrent = mxGetPr(prhs[3]);
+            }
+
+            /// Optional standard normal noise, `randn(nneurons, ms_per_step)`, gives the same results as MATLAB loop
+            const double *noise = NULL;
+            if (nrhs >= 5 && !mxIsEmpty(prhs[4])) {
+                noise = doubleInput(prhs[4], numberOfNeurons * msPerStep, "Noise must be a double nneurons x ms_per_step matrix.");
+            }
+
+            /// Optional reward, used by basal ganglia selection
+            double reward = nrhs >= 6 ? mxGetScalar(prhs[5]) : 0;
+
+            plhs[0] = mxCreateLogicalMatrix(numberOfNeurons, msPerStep);
+            mxArray *currents = mxCreateDoubleMatrix(numberOfNeurons, msPerStep, mxREAL);
+
+            brainObject->step(msPerStep, sensoryCurrent, numberOfSensoryInputs, noise, reward, (uint8_t*) mxGetData(plhs[0]), mxGetPr(currents));
+
+            if (nlhs > 1) {
+                plhs[1] = currents;
+            } else {
+                mxDestroyArray(currents);
+            }
+            return;
+        } else if ( !strcmp("release", cmd) ) {
+
+            delete brainObject;
+            brainObjects.erase(handle);
+            return;
+        }
+    }
+};
+
+/**
+ Standard MATLAB api for executing commands from it through mex.
+ */
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+    static NeuroRobot_Brain brainObject;
+
+    brainObject.processMexCall( nlhs, plhs, nrhs, prhs );
+}
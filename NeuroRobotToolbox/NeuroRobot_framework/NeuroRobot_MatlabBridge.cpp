@@ -7,18 +7,231 @@
 //
 
 #include "NeuroRobotManager.h"
+#include "Loop/ControlLoop.h"
 #include <iostream>
+#include <cstring>
+#include <map>
 #include <mex.h>
 
 #include "matrix.h"
 
 /**
  Base Neuro Robot API class. It is intended to have only one statically allocated object of this class and all mex calls will be executed through that object.
+ Every robot is identified by the handle returned from `init`, which has to be the second input of all other commands.
  */
 class NeuroRobot_Matlab
 {
 private:
-    NeuroRobotManager *robotObject = NULL;
+    
+    /// Robots created with `init`, identified by handle.
+    std::map<uint64_t, NeuroRobotManager *> robotObjects;
+    
+    /// Native control loops, identified by handle of their robot.
+    std::map<uint64_t, ControlLoop *> loopObjects;
+    
+    /// Handle which will be assigned to the next robot. Handles are never reused.
+    uint64_t nextHandle = 1;
+    
+    /**
+     Finds the robot which handle is forwarded as second input
+     */
+    NeuroRobotManager *robotForHandle( int nrhs, const mxArray *prhs[], uint64_t *handle )
+    {
+        if (nrhs < 2 || !mxIsNumeric(prhs[1]) || mxGetNumberOfElements(prhs[1]) != 1) { mexErrMsgTxt("Second input should be a robot handle returned by init."); return NULL; }
+        
+        *handle = (uint64_t)mxGetScalar(prhs[1]);
+        auto robot = robotObjects.find(*handle);
+        if (robot == robotObjects.end()) { mexErrMsgTxt("Invalid robot handle."); return NULL; }
+        
+        return robot->second;
+    }
+    
+    /**
+     Colour preferences as `ColorBlobs::numberOfValues` x `ColorBlobs::numberOfEyes` matrix, empty if there are none
+     */
+    static mxArray *visualPreferencesOutput( const double *values )
+    {
+        if (!values) { return mxCreateDoubleMatrix(0, 0, mxREAL); }
+        
+        mxArray *output = mxCreateDoubleMatrix(ColorBlobs::numberOfValues, ColorBlobs::numberOfEyes, mxREAL);
+        std::memcpy(mxGetPr(output), values, ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes * sizeof(double));
+        return output;
+    }
+    
+    /**
+     Finds control loop of the robot
+     */
+    ControlLoop *loopForHandle( uint64_t handle )
+    {
+        auto loop = loopObjects.find(handle);
+        if (loop == loopObjects.end()) { mexErrMsgTxt("Control loop is not started, call startLoop first."); return NULL; }
+        
+        return loop->second;
+    }
+    
+    /**
+     Scalar field of settings struct, default value if field is missing or empty
+     */
+    static double settingsField( const mxArray *settings, const char *name, double defaultValue )
+    {
+        const mxArray *field = settings ? mxGetField(settings, 0, name) : NULL;
+        return field && !mxIsEmpty(field) ? mxGetScalar(field) : defaultValue;
+    }
+    
+    /**
+     Thread settings from optional struct with fields `cpu`, `priority` (SCHED_FIFO) and `nice`
+     */
+    static ThreadSettings threadSettings( const mxArray *settingsStruct )
+    {
+        ThreadSettings settings;
+        if (settingsStruct && !mxIsStruct(settingsStruct)) { mexErrMsgTxt("Thread settings must be a struct."); return settings; }
+        
+        settings.cpu = (int)settingsField(settingsStruct, "cpu", settings.cpu);
+        settings.priority = (int)settingsField(settingsStruct, "priority", settings.priority);
+        settings.nice = (int)settingsField(settingsStruct, "nice", settings.nice);
+        return settings;
+    }
+    
+    /**
+     Control loop settings from optional struct with fields `pulse_period` (s), `ms_per_step`, `deadlines` (ms of sense, features, brain and motor stage),
+     `learning`, `bg_brain`, `threads`, `seed` and scheduling of loop thread `cpu`, `priority` and `nice`
+     */
+    static ControlLoop::Settings loopSettings( const mxArray *settingsStruct )
+    {
+        ControlLoop::Settings settings;
+        if (settingsStruct && !mxIsStruct(settingsStruct)) { mexErrMsgTxt("Loop settings must be a struct."); return settings; }
+        
+        settings.periodMs = settingsField(settingsStruct, "pulse_period", settings.periodMs / 1000) * 1000;
+        settings.msPerStep = (unsigned int)settingsField(settingsStruct, "ms_per_step", settings.msPerStep);
+        settings.ltpRecencyThresholdInSec = settingsField(settingsStruct, "ltp_recency_th_in_sec", settings.ltpRecencyThresholdInSec);
+        settings.learning = settingsField(settingsStruct, "learning", settings.learning) != 0;
+        settings.basalGanglia = settingsField(settingsStruct, "bg_brain", settings.basalGanglia) != 0;
+        settings.numberOfThreads = (unsigned int)settingsField(settingsStruct, "threads", settings.numberOfThreads);
+        settings.seed = (uint64_t)settingsField(settingsStruct, "seed", (double)settings.seed);
+        settings.thread = threadSettings(settingsStruct);
+        
+        const mxArray *deadlines = settingsStruct ? mxGetField(settingsStruct, 0, "deadlines") : NULL;
+        if (deadlines && !mxIsEmpty(deadlines)) {
+            if (!mxIsDouble(deadlines) || mxGetNumberOfElements(deadlines) != ControlLoop::NumberOfStages) { mexErrMsgTxt("Deadlines must be [sense features brain motor] in ms."); return settings; }
+            std::memcpy(settings.deadlinesMs, mxGetPr(deadlines), sizeof(settings.deadlinesMs));
+        }
+        return settings;
+    }
+    
+    /**
+     Control loop statistics as struct, stage values are columns of sense, features, brain and motor stage
+     */
+    static mxArray *loopStatisticsOutput( const ControlLoop::Statistics &statistics )
+    {
+        const char *fieldNames[] = { "steps", "periodOverruns", "skippedSteps", "jitterMs", "stepMs", "stageOverruns", "stageMs" };
+        mxArray *output = mxCreateStructMatrix(1, 1, 7, fieldNames);
+        
+        /// Timings are [last; mean; max]
+        mxArray *jitter = mxCreateDoubleMatrix(3, 1, mxREAL);
+        mxGetPr(jitter)[0] = statistics.lastJitterMs;
+        mxGetPr(jitter)[1] = statistics.meanJitterMs;
+        mxGetPr(jitter)[2] = statistics.maxJitterMs;
+        mxArray *step = mxCreateDoubleMatrix(3, 1, mxREAL);
+        mxGetPr(step)[0] = statistics.lastStepMs;
+        mxGetPr(step)[1] = statistics.meanStepMs;
+        mxGetPr(step)[2] = statistics.maxStepMs;
+        
+        mxArray *stageOverruns = mxCreateDoubleMatrix(1, ControlLoop::NumberOfStages, mxREAL);
+        mxArray *stageMs = mxCreateDoubleMatrix(3, ControlLoop::NumberOfStages, mxREAL);
+        for (unsigned int stage = 0; stage < ControlLoop::NumberOfStages; stage++) {
+            mxGetPr(stageOverruns)[stage] = (double)statistics.stages[stage].overruns;
+            mxGetPr(stageMs)[stage * 3] = statistics.stages[stage].lastMs;
+            mxGetPr(stageMs)[stage * 3 + 1] = statistics.stages[stage].meanMs;
+            mxGetPr(stageMs)[stage * 3 + 2] = statistics.stages[stage].maxMs;
+        }
+        
+        mxSetField(output, 0, "steps", mxCreateDoubleScalar((double)statistics.steps));
+        mxSetField(output, 0, "periodOverruns", mxCreateDoubleScalar((double)statistics.periodOverruns));
+        mxSetField(output, 0, "skippedSteps", mxCreateDoubleScalar((double)statistics.skippedSteps));
+        mxSetField(output, 0, "jitterMs", jitter);
+        mxSetField(output, 0, "stepMs", step);
+        mxSetField(output, 0, "stageOverruns", stageOverruns);
+        mxSetField(output, 0, "stageMs", stageMs);
+        return output;
+    }
+    
+    /**
+     Robot statistics as struct with `stages` struct array of latencies in us and `counters` struct
+     */
+    static mxArray *statsOutput( const RobotStatistics &statistics )
+    {
+        const char *stageFieldNames[] = { "name", "count", "meanUs", "maxUs", "p50Us", "p90Us", "p99Us", "p999Us" };
+        mxArray *stages = mxCreateStructMatrix(RobotStatistics::NumberOfStages, 1, 8, stageFieldNames);
+        for (unsigned int stage = 0; stage < RobotStatistics::NumberOfStages; stage++) {
+            LatencyHistogram::Summary summary = statistics.stageSummary((RobotStatistics::Stage)stage);
+            mxSetField(stages, stage, "name", mxCreateString(RobotStatistics::stageName((RobotStatistics::Stage)stage)));
+            mxSetField(stages, stage, "count", mxCreateDoubleScalar((double)summary.count));
+            mxSetField(stages, stage, "meanUs", mxCreateDoubleScalar(summary.meanUs));
+            mxSetField(stages, stage, "maxUs", mxCreateDoubleScalar((double)summary.maxUs));
+            mxSetField(stages, stage, "p50Us", mxCreateDoubleScalar((double)summary.p50Us));
+            mxSetField(stages, stage, "p90Us", mxCreateDoubleScalar((double)summary.p90Us));
+            mxSetField(stages, stage, "p99Us", mxCreateDoubleScalar((double)summary.p99Us));
+            mxSetField(stages, stage, "p999Us", mxCreateDoubleScalar((double)summary.p999Us));
+        }
+        
+        const char *counterNames[RobotStatistics::NumberOfCounters];
+        for (unsigned int counter = 0; counter < RobotStatistics::NumberOfCounters; counter++) {
+            counterNames[counter] = RobotStatistics::counterName((RobotStatistics::Counter)counter);
+        }
+        mxArray *counters = mxCreateStructMatrix(1, 1, RobotStatistics::NumberOfCounters, counterNames);
+        for (unsigned int counter = 0; counter < RobotStatistics::NumberOfCounters; counter++) {
+            mxSetFieldByNumber(counters, 0, counter, mxCreateDoubleScalar((double)statistics.counterValue((RobotStatistics::Counter)counter)));
+        }
+        
+        const char *fieldNames[] = { "stages", "counters" };
+        mxArray *output = mxCreateStructMatrix(1, 1, 2, fieldNames);
+        mxSetField(output, 0, "stages", stages);
+        mxSetField(output, 0, "counters", counters);
+        return output;
+    }
+    
+    /**
+     Last step of control loop as struct, with neuron state if requested
+     */
+    static mxArray *loopStateOutput( ControlLoop *loop, bool withNeurons )
+    {
+        ControlLoop::State state;
+        loop->readState(state);
+        
+        const char *fieldNames[] = { "step", "firing", "motorCommand", "visPrefVals", "frameSequence", "distance", "selectedNetwork", "v", "u" };
+        mxArray *output = mxCreateStructMatrix(1, 1, 9, fieldNames);
+        
+        mxArray *firing = mxCreateLogicalMatrix(state.firing.size(), 1);
+        mxLogical *firingData = mxGetLogicals(firing);
+        for (size_t i = 0; i < state.firing.size(); i++) {
+            firingData[i] = state.firing[i] != 0;
+        }
+        
+        /// `motor_command(1:4)`
+        mxArray *motorCommand = mxCreateDoubleMatrix(1, 4, mxREAL);
+        mxGetPr(motorCommand)[0] = state.motorCommand.rightTorque;
+        mxGetPr(motorCommand)[1] = state.motorCommand.rightDirection;
+        mxGetPr(motorCommand)[2] = state.motorCommand.leftTorque;
+        mxGetPr(motorCommand)[3] = state.motorCommand.leftDirection;
+        
+        mxSetField(output, 0, "step", mxCreateDoubleScalar((double)state.step));
+        mxSetField(output, 0, "firing", firing);
+        mxSetField(output, 0, "motorCommand", motorCommand);
+        mxSetField(output, 0, "visPrefVals", visualPreferencesOutput(state.hasVisualPreferences ? state.visualPreferences : NULL));
+        mxSetField(output, 0, "frameSequence", mxCreateDoubleScalar((double)state.frameSequence));
+        mxSetField(output, 0, "distance", mxCreateDoubleScalar(state.distance));
+        mxSetField(output, 0, "selectedNetwork", mxCreateDoubleScalar(state.selectedNetwork));
+        
+        if (withNeurons) {
+            size_t numberOfNeurons = loop->numberOfNeurons();
+            mxArray *v = mxCreateDoubleMatrix(numberOfNeurons, 1, mxREAL);
+            mxArray *u = mxCreateDoubleMatrix(numberOfNeurons, 1, mxREAL);
+            loop->readNeurons(mxGetPr(v), mxGetPr(u));
+            mxSetField(output, 0, "v", v);
+            mxSetField(output, 0, "u", u);
+        }
+        return output;
+    }
     
 public:
     
@@ -46,17 +259,54 @@ public:
             free(ipAddress);
             free(port);
             
-            robotObject = new NeuroRobotManager(ipAddressString, portString, nullptr, nullptr);
+            bool fastStart = nrhs >= 4 && mxGetScalar(prhs[3]) != 0;
+            
+            uint64_t handle = nextHandle++;
+            robotObjects[handle] = new NeuroRobotManager(ipAddressString, portString, nullptr, nullptr, "", fastStart);
+            
+            plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+            uint64_t *yp;
+            yp  = (uint64_t*) mxGetData(plhs[0]);
+            std::memcpy(yp, &handle, sizeof(uint64_t));
             return;
-        } else if ( !strcmp("start", cmd) ) {
+        }
+        
+        uint64_t handle = 0;
+        NeuroRobotManager *robotObject = robotForHandle(nrhs, prhs, &handle);
+        RobotStatistics::StageTimer bridgeCallTimer(&robotObject->readStats(), RobotStatistics::StageBridgeCall);
+        
+        if ( !strcmp("start", cmd) ) {
             
             robotObject->start();
+            std::string error = robotObject->readThreadSettingsError();
+            if (!error.empty()) {
+                mexWarnMsgTxt(("Scheduling of workers is not applied, " + error).c_str());
+            }
+            return;
+        } else if ( !strcmp("setThreadSettings", cmd) ) {
+            
+            /// Struct with optional fields `decode` and `socket`, used by the next start
+            if (nrhs < 3 || !mxIsStruct(prhs[2])) { mexErrMsgTxt("Missing struct with decode and socket thread settings."); return; }
+            
+            robotObject->setThreadSettings(threadSettings(mxGetField(prhs[2], 0, "decode")), threadSettings(mxGetField(prhs[2], 0, "socket")));
             return;
         } else if ( !strcmp("readAudio", cmd) ) {
             size_t totalBytes = 0;
             unsigned short bytesPerSample = 0;
             
+            if (nrhs >= 3) {
+                /// Fill preallocated single buffer in place, output is the number of valid samples
+                if (!mxIsSingle(prhs[2])) { mexErrMsgTxt("Audio buffer must be single."); return; }
+                
+                robotObject->readAudio(mxGetData(prhs[2]), mxGetNumberOfElements(prhs[2]) * sizeof(float), &totalBytes, &bytesPerSample);
+                if (nlhs > 0) {
+                    plhs[0] = mxCreateDoubleScalar(bytesPerSample ? (double)(totalBytes / bytesPerSample) : 0);
+                }
+                return;
+            }
+            
             void *audioData = robotObject->readAudio(&totalBytes, &bytesPerSample);
+            if (bytesPerSample == 0) { totalBytes = 0; bytesPerSample = 1; }
             
             plhs[0] = mxCreateNumericMatrix(1, totalBytes / bytesPerSample, mxSINGLE_CLASS, mxREAL);
             
@@ -67,19 +317,213 @@ public:
             return;
         } else if ( !strcmp("readVideo", cmd) ) {
             
-            uint8_t *videoData = robotObject->readVideoFrame();
+            if (nrhs >= 3) {
+                /// Fill preallocated uint8 buffer in place, output is the number of copied bytes
+                if (!mxIsUint8(prhs[2])) { mexErrMsgTxt("Video buffer must be uint8."); return; }
+                if (mxGetNumberOfElements(prhs[2]) < robotObject->videoFrameBytes()) { mexErrMsgTxt("Video buffer is smaller than the frame."); return; }
+                
+                size_t copiedBytes = robotObject->readVideoFrame((uint8_t*) mxGetData(prhs[2]), mxGetNumberOfElements(prhs[2]));
+                if (nlhs > 0) {
+                    plhs[0] = mxCreateDoubleScalar((double)copiedBytes);
+                }
+                return;
+            }
             
-            plhs[0] = mxCreateNumericMatrix(1, robotObject->videoFrameBytes(), mxUINT8_CLASS, mxREAL);
+            size_t frameBytes = robotObject->videoFrameBytes();
+            plhs[0] = mxCreateNumericMatrix(1, frameBytes, mxUINT8_CLASS, mxREAL);
             uint8_t *yp;
             yp  = (uint8_t*) mxGetData(plhs[0]);
-            std::memcpy(yp, videoData, robotObject->videoFrameBytes());
+            robotObject->readVideoFrame(yp, frameBytes);
             
+            return;
+        } else if ( !strcmp("step", cmd) ) {
+            
+            /// Optional outgoing serial command (motors, LEDs) is sent before reading the robot's state
+            if (nrhs >= 3 && mxIsChar(prhs[2]) && !mxIsEmpty(prhs[2])) {
+                char *command = mxArrayToString(prhs[2]);
+                robotObject->writeSerial(std::string(command));
+                mxFree(command);
+            }
+            
+            /// Optional preallocated uint8 buffer for frame, like with `readVideo`
+            bool frameInPlace = nrhs >= 4;
+            if (frameInPlace && !mxIsUint8(prhs[3])) { mexErrMsgTxt("Video buffer must be uint8."); return; }
+            
+            const char *fieldNames[] = { "frame", "width", "height", "frameBytes", "frameSequence", "visPrefVals", "audio", "audioSampleRate", "audioSequence", "serial", "serialSequence", "isRunning" };
+            plhs[0] = mxCreateStructMatrix(1, 1, 12, fieldNames);
+            
+            mxArray *frame = NULL;
+            uint8_t *frameData = NULL;
+            size_t frameCapacity = 0;
+            if (frameInPlace) {
+                frameData = (uint8_t*) mxGetData(prhs[3]);
+                frameCapacity = mxGetNumberOfElements(prhs[3]);
+            } else {
+                frameCapacity = robotObject->videoFrameBytes();
+                frame = mxCreateNumericMatrix(1, frameCapacity, mxUINT8_CLASS, mxREAL);
+                frameData = (uint8_t*) mxGetData(frame);
+            }
+            
+            size_t audioSamplesCapacity = robotObject->audioCapacityBytes() / sizeof(float);
+            mxArray *audio = mxCreateNumericMatrix(1, audioSamplesCapacity, mxSINGLE_CLASS, mxREAL);
+            
+            SharedMemorySnapshot snapshot;
+            robotObject->readSnapshot(frameData, frameCapacity, mxGetData(audio), audioSamplesCapacity * sizeof(float), &snapshot);
+            
+            /// Shrink audio to valid samples, memory is not reallocated
+            size_t audioSamples = snapshot.bytesPerSample ? snapshot.audioBytes / snapshot.bytesPerSample : 0;
+            if (audioSamples > audioSamplesCapacity) { audioSamples = audioSamplesCapacity; }
+            mxSetN(audio, audioSamples);
+            
+            if (frame && snapshot.frameBytes == 0) {
+                /// Frame size changed in the meantime or there is no frame yet
+                mxSetN(frame, 0);
+            }
+            
+            mxSetField(plhs[0], 0, "frame", frame ? frame : mxCreateNumericMatrix(0, 0, mxUINT8_CLASS, mxREAL));
+            mxSetField(plhs[0], 0, "width", mxCreateDoubleScalar(snapshot.videoWidth));
+            mxSetField(plhs[0], 0, "height", mxCreateDoubleScalar(snapshot.videoHeight));
+            mxSetField(plhs[0], 0, "frameBytes", mxCreateDoubleScalar((double)snapshot.frameBytes));
+            mxSetField(plhs[0], 0, "frameSequence", mxCreateDoubleScalar((double)snapshot.frameSequence));
+            mxSetField(plhs[0], 0, "visPrefVals", visualPreferencesOutput(snapshot.hasVisualPreferences ? snapshot.visualPreferences : NULL));
+            mxSetField(plhs[0], 0, "audio", audio);
+            mxSetField(plhs[0], 0, "audioSampleRate", mxCreateDoubleScalar(snapshot.audioSampleRate));
+            mxSetField(plhs[0], 0, "audioSequence", mxCreateDoubleScalar((double)snapshot.audioSequence));
+            mxSetField(plhs[0], 0, "serial", mxCreateString(snapshot.serialData.c_str()));
+            mxSetField(plhs[0], 0, "serialSequence", mxCreateDoubleScalar((double)snapshot.serialSequence));
+            /// State of workers is not kept in shared memory, it is read right after the snapshot and is not a part of it
+            mxSetField(plhs[0], 0, "isRunning", mxCreateLogicalScalar(robotObject->isRunning()));
+            
+            return;
+        } else if ( !strcmp("setColorBlobs", cmd) ) {
+            
+            /// Without cuts colour preferences are not computed anymore
+            if (nrhs < 5) {
+                robotObject->disableColorBlobs();
+                return;
+            }
+            if (!mxIsDouble(prhs[2]) || mxGetNumberOfElements(prhs[2]) != 4 || !mxIsDouble(prhs[3]) || mxGetNumberOfElements(prhs[3]) != 4) { mexErrMsgTxt("Cuts must be [first row, last row, first column, last column]."); return; }
+            if (!mxIsDouble(prhs[4]) || mxGetNumberOfElements(prhs[4]) < 2) { mexErrMsgTxt("Size must be [height, width]."); return; }
+            
+            ColorBlobs::Cut cuts[ColorBlobs::numberOfEyes];
+            for (unsigned int eye = 0; eye < ColorBlobs::numberOfEyes; eye++) {
+                const double *cut = mxGetPr(prhs[2 + eye]);
+                cuts[eye].firstRow = (unsigned int)cut[0];
+                cuts[eye].lastRow = (unsigned int)cut[1];
+                cuts[eye].firstColumn = (unsigned int)cut[2];
+                cuts[eye].lastColumn = (unsigned int)cut[3];
+            }
+            const double *size = mxGetPr(prhs[4]);
+            
+            std::string error;
+            if (!robotObject->setColorBlobs(cuts, (unsigned int)size[0], (unsigned int)size[1], error)) { mexErrMsgTxt(error.c_str()); return; }
+            return;
+        } else if ( !strcmp("readVisualPreferences", cmd) ) {
+            
+            double values[ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes];
+            uint64_t frameSequence = 0;
+            bool hasValues = robotObject->readVisualPreferences(values, &frameSequence);
+            plhs[0] = visualPreferencesOutput(hasValues ? values : NULL);
+            if (nlhs > 1) {
+                plhs[1] = mxCreateDoubleScalar((double)frameSequence);
+            }
+            return;
+        } else if ( !strcmp("waitForFrame", cmd) ) {
+            if (nrhs < 4) { mexErrMsgTxt("Missing last sequence and timeout inputs."); return; }
+            
+            uint64_t lastSequence = (uint64_t)mxGetScalar(prhs[2]);
+            unsigned int timeoutMs = (unsigned int)mxGetScalar(prhs[3]);
+            
+            uint64_t sequence = robotObject->waitForFrame(lastSequence, timeoutMs);
+            plhs[0] = mxCreateDoubleScalar((double)sequence);
+            return;
+        } else if ( !strcmp("startLoop", cmd) ) {
+            if (nrhs < 3 || !mxIsChar(prhs[2])) { mexErrMsgTxt("Third input should be a path of brain image."); return; }
+            
+            ControlLoop::Settings settings = loopSettings(nrhs >= 4 ? prhs[3] : NULL);
+            char *path = mxArrayToString(prhs[2]);
+            std::string brainPath(path);
+            mxFree(path);
+            
+            ControlLoop *loop = loopObjects[handle];
+            if (!loop) {
+                loop = loopObjects[handle] = new ControlLoop(robotObject);
+            }
+            std::string error;
+            if (!loop->start(brainPath, settings, error)) { mexErrMsgTxt(error.c_str()); return; }
+            if (!loop->readThreadSettingsError().empty()) {
+                mexWarnMsgTxt(("Scheduling of loop is not applied, " + loop->readThreadSettingsError()).c_str());
+            }
+            return;
+        } else if ( !strcmp("stopLoop", cmd) ) {
+            
+            auto loop = loopObjects.find(handle);
+            if (loop == loopObjects.end()) { return; }
+            if (nlhs > 0) {
+                loop->second->stop();
+                ControlLoop::Statistics statistics;
+                loop->second->readStatistics(statistics);
+                plhs[0] = loopStatisticsOutput(statistics);
+            }
+            delete loop->second;
+            loopObjects.erase(loop);
+            return;
+        } else if ( !strcmp("readLoopStatistics", cmd) ) {
+            
+            ControlLoop::Statistics statistics;
+            loopForHandle(handle)->readStatistics(statistics);
+            plhs[0] = loopStatisticsOutput(statistics);
+            return;
+        } else if ( !strcmp("readLoopState", cmd) ) {
+            
+            /// Neuron state waits for the brain stage to finish, so it is read only when asked for
+            bool withNeurons = nrhs >= 3 && mxGetScalar(prhs[2]) != 0;
+            plhs[0] = loopStateOutput(loopForHandle(handle), withNeurons);
+            return;
+        } else if ( !strcmp("readLoopConnectome", cmd) ) {
+            
+            ControlLoop *loop = loopForHandle(handle);
+            size_t numberOfNeurons = loop->numberOfNeurons();
+            plhs[0] = mxCreateDoubleMatrix(numberOfNeurons, numberOfNeurons, mxREAL);
+            loop->readConnectome(mxGetPr(plhs[0]));
+            return;
+        } else if ( !strcmp("setLoopConnectome", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing connectome input."); return; }
+            
+            ControlLoop *loop = loopForHandle(handle);
+            size_t numberOfNeurons = loop->numberOfNeurons();
+            if (!mxIsDouble(prhs[2]) || mxIsSparse(prhs[2]) || mxIsComplex(prhs[2]) || mxGetM(prhs[2]) != numberOfNeurons || mxGetN(prhs[2]) != numberOfNeurons) { mexErrMsgTxt("Connectome must be a full double nneurons x nneurons matrix."); return; }
+            
+            loop->setConnectome(mxGetPr(prhs[2]));
+            return;
+        } else if ( !strcmp("setLoopReward", cmd) ) {
+            if (nrhs < 3) { mexErrMsgTxt("Missing reward input."); return; }
+            
+            loopForHandle(handle)->setReward(mxGetScalar(prhs[2]));
             return;
         } else if ( !strcmp("stop", cmd) ) {
             
+            /// Loop drives the robot, so it stops first
+            auto loop = loopObjects.find(handle);
+            if (loop != loopObjects.end()) {
+                delete loop->second;
+                loopObjects.erase(loop);
+            }
+            
             robotObject->stop();
             
+            bridgeCallTimer.cancel();
             delete robotObject;
+            robotObjects.erase(handle);
+            return;
+        } else if ( !strcmp("readStats", cmd) ) {
+            
+            /// Optional third input resets statistics after reading, so the next call covers only new events
+            RobotStatistics &statistics = robotObject->readStats();
+            plhs[0] = statsOutput(statistics);
+            if (nrhs >= 3 && mxGetScalar(prhs[2]) != 0) {
+                statistics.reset();
+            }
             return;
         } else if ( !strcmp("isRunning", cmd) ) {
             
@@ -96,8 +540,8 @@ public:
             int   buflen,status;
             
             /* Check for proper number of arguments. */
-            if (nrhs != 2)
-                mexErrMsgTxt("One input required.");
+            if (nrhs != 3)
+                mexErrMsgTxt("Robot handle and one input required.");
             else if (nlhs > 2)
                 mexErrMsgTxt("Too many output arguments.");
             
@@ -110,14 +554,14 @@ public:
                 mexErrMsgTxt("Input must be a row vector.");
             
             /* Get the length of the input string. */
-            buflen = (mxGetM(prhs[1]) * mxGetN(prhs[1])) + 1;
+            buflen = (mxGetM(prhs[2]) * mxGetN(prhs[2])) + 1;
             
             /* Allocate memory for input and output strings. */
             input_buf = (char*) mxCalloc(buflen, sizeof(char));
             
             /* Copy the string data from prhs[0] into a C string
              * input_buf. */
-            status = mxGetString(prhs[1], input_buf, buflen);
+            status = mxGetString(prhs[2], input_buf, buflen);
             if (status != 0)
                 mexWarnMsgTxt("Not enough space. String is truncated.");
             
@@ -126,15 +570,29 @@ public:
             
             return;
         } else if ( !strcmp("readSerial", cmd) ) {
+            
+            if (nrhs >= 3) {
+                /// Fill preallocated uint8 buffer in place, output is the number of valid bytes
+                if (!mxIsUint8(prhs[2])) { mexErrMsgTxt("Serial buffer must be uint8."); return; }
+                
+                size_t copiedBytes = robotObject->readSerial((char*) mxGetData(prhs[2]), mxGetNumberOfElements(prhs[2]));
+                if (nlhs > 0) {
+                    plhs[0] = mxCreateDoubleScalar((double)copiedBytes);
+                }
+                return;
+            }
+            
             size_t size = 0;
             char *serialData = robotObject->readSerial(&size);
             plhs[0] = mxCreateString(serialData);
             return;
         } else if ( !strcmp("sendAudio", cmd) ) {
             
-            short columns = mxGetN(prhs[1]);
-            long long rows = mxGetM(prhs[1]);
-            int16_t *data = (int16_t *)mxGetData(prhs[1]);
+            if (nrhs < 3) { mexErrMsgTxt("Missing audio data input."); return; }
+            
+            short columns = mxGetN(prhs[2]);
+            long long rows = mxGetM(prhs[2]);
+            int16_t *data = (int16_t *)mxGetData(prhs[2]);
             columns = 2;
             
             robotObject->sendAudio(data, rows * 2);
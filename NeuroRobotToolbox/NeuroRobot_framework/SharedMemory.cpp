@@ -13,30 +13,22 @@
 #include "Macros.h"
 
 #include <iostream>
-#include <thread>
+#include <cstring>
+#include <algorithm>
 
 const static unsigned int maxAudioCounter = 20;
 
-/// Null, because instance will be initialized on demand.
-SharedMemory* SharedMemory::instance = 0;
-SharedMemory* SharedMemory::getInstance()
-{
-    if (instance == 0) {
-        instance = new SharedMemory();
-    }
-    return instance;
-}
-
 SharedMemory::SharedMemory()
 : Log("SharedMemory")
 {
-    logMessage("SharedMemory >>> init");
+    LOG_INFO("SharedMemory >>> init");
 }
 
 SharedMemory::~SharedMemory()
 {
     delete [] frameData;
     delete [] audioData;
+    delete [] audioDataRead;
     delete [] serialData;
 }
 
@@ -50,7 +42,7 @@ void SharedMemory::unblockWritters()
     isWritingBlocked = false;
 }
 
-void SharedMemory::writeFrame(uint8_t* data, size_t totalBytes)
+void SharedMemory::writeFrame(uint8_t* data, size_t totalBytes, std::chrono::steady_clock::time_point packetTime, const double* visualPreferences_)
 {
     if (totalBytes == 0) { return; }
     
@@ -58,8 +50,9 @@ void SharedMemory::writeFrame(uint8_t* data, size_t totalBytes)
     
     if (totalBytes != frameTotalBytes) {
         if (frameData) {
-            logMessage("writeFrame >>> Rebasing frameData");
+            LOG_DEBUG("writeFrame >>> Rebasing frameData");
             delete [] frameData;
+            frameData = NULL;
         }
         frameTotalBytes = totalBytes;
     }
@@ -68,7 +61,15 @@ void SharedMemory::writeFrame(uint8_t* data, size_t totalBytes)
     }
     
     memcpy(frameData, data, frameTotalBytes);
+    frameCounter++;
+    framePacketTime = packetTime;
+    hasVisualPreferences = visualPreferences_ != NULL;
+    if (hasVisualPreferences) {
+        memcpy(visualPreferences, visualPreferences_, sizeof(visualPreferences));
+    }
     mutexVideo.unlock();
+    
+    frameWritten.notify_all();
 }
 
 uint8_t* SharedMemory::readVideoFrame()
@@ -76,17 +77,52 @@ uint8_t* SharedMemory::readVideoFrame()
     return frameData;
 }
 
-void SharedMemory::writeAudio(uint8_t* data, size_t numberOfSamples_, unsigned short bytesPerSample_)
+uint64_t SharedMemory::waitForFrame(uint64_t lastSequence, unsigned int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutexVideo);
+    
+    frameWritten.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, lastSequence] { return frameCounter > lastSequence; });
+    return frameCounter > lastSequence ? frameCounter : lastSequence;
+}
+
+size_t SharedMemory::readVideoFrame(uint8_t* destination, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutexVideo);
+    
+    if (!frameData || capacity < frameTotalBytes) { return 0; }
+    
+    memcpy(destination, frameData, frameTotalBytes);
+    return frameTotalBytes;
+}
+
+bool SharedMemory::readVisualPreferences(double* values, uint64_t* frameSequence)
 {
-    std::thread processThread(&SharedMemory::writeAudioThreaded, this, data, numberOfSamples_, bytesPerSample_);
-    processThread.detach();
+    std::lock_guard<std::mutex> lock(mutexVideo);
+    
+    if (frameSequence) {
+        *frameSequence = frameCounter;
+    }
+    if (!hasVisualPreferences) { return false; }
+    
+    memcpy(values, visualPreferences, sizeof(visualPreferences));
+    return true;
 }
 
-void SharedMemory::writeAudioThreaded(uint8_t* data, size_t numberOfSamples_, unsigned short bytesPerSample_)
+uint64_t SharedMemory::readFrameCounter(std::chrono::steady_clock::time_point* packetTime)
 {
-    if (numberOfSamples_ == 0) { logMessage("numberOfSamples_ == 0"); return; }
-    if (bytesPerSample_ == 0) { logMessage("bytesPerSample_ == 0"); return; }
-    if (isWritingBlocked) { logMessage("Blocked audio"); return; }
+    std::lock_guard<std::mutex> lock(mutexVideo);
+    
+    if (packetTime) {
+        *packetTime = framePacketTime;
+    }
+    return frameCounter;
+}
+
+void SharedMemory::writeAudio(uint8_t* data, size_t numberOfSamples_, unsigned short bytesPerSample_)
+{
+    if (numberOfSamples_ == 0) { LOG_TRACE("numberOfSamples_ == 0"); return; }
+    if (bytesPerSample_ == 0) { LOG_TRACE("bytesPerSample_ == 0"); return; }
+    if (isWritingBlocked) { LOG_TRACE("Blocked audio"); return; }
     
     mutexAudio.lock();
     
@@ -108,41 +144,115 @@ void SharedMemory::writeAudioThreaded(uint8_t* data, size_t numberOfSamples_, un
     /// Write at the end of valid data
     memcpy(&audioData[audioTotalBytes * audioCounter], data, audioTotalBytes);
     audioCounter++;
+    audioSequence++;
     
     mutexAudio.unlock();
 }
 
 uint8_t* SharedMemory::readAudio(size_t* totalBytes_, unsigned short* bytesPerSample_)
 {
-    static uint8_t *audioDataFoo = new uint8_t[audioTotalBytes * maxAudioCounter];
+    mutexAudio.lock();
+    
     *totalBytes_ = (size_t)(audioTotalBytes * audioCounter);
     *bytesPerSample_ = bytesPerSample;
     
+    /// Alloc read buffer per object, it grows only if the packet size changes
+    if (audioDataReadBytes < audioTotalBytes * maxAudioCounter) {
+        delete [] audioDataRead;
+        audioDataReadBytes = audioTotalBytes * maxAudioCounter;
+        audioDataRead = new uint8_t[audioDataReadBytes + 1];
+    }
+    
     if (audioCounter != 0) {
-        
-        mutexAudio.lock();
         audioCounter = 0;
-        
-        memcpy(audioDataFoo, audioData, *totalBytes_);
+        memcpy(audioDataRead, audioData, *totalBytes_);
+    }
+    
+    mutexAudio.unlock();
+    
+    return audioDataRead;
+}
+
+void SharedMemory::readAudio(uint8_t* destination, size_t capacity, size_t* totalBytes_, unsigned short* bytesPerSample_)
+{
+    mutexAudio.lock();
+    copyAudio(destination, capacity, totalBytes_, bytesPerSample_);
+    mutexAudio.unlock();
+}
+
+void SharedMemory::copyAudio(uint8_t* destination, size_t capacity, size_t* totalBytes_, unsigned short* bytesPerSample_)
+{
+    *bytesPerSample_ = bytesPerSample;
+    *totalBytes_ = (size_t)(audioTotalBytes * audioCounter);
+    
+    /// Keep only the newest samples if the buffer is too small
+    size_t skippedBytes = 0;
+    if (*totalBytes_ > capacity) {
+        skippedBytes = *totalBytes_ - capacity;
+        if (bytesPerSample) { skippedBytes += (bytesPerSample - skippedBytes % bytesPerSample) % bytesPerSample; }
+        *totalBytes_ -= skippedBytes;
+    }
+    
+    if (*totalBytes_ != 0) {
+        memcpy(destination, &audioData[skippedBytes], *totalBytes_);
+    }
+    audioCounter = 0;
+}
+
+size_t SharedMemory::audioCapacityBytes()
+{
+    std::lock_guard<std::mutex> lock(mutexAudio);
+    return audioTotalBytes * maxAudioCounter;
+}
 
-        mutexAudio.unlock();
+void SharedMemory::readSnapshot(uint8_t* frameDestination, size_t frameCapacity, uint8_t* audioDestination, size_t audioCapacity, SharedMemorySnapshot* snapshot)
+{
+    std::lock(mutexVideo, mutexAudio, mutexSerialRead);
+    std::lock_guard<std::mutex> lockVideo(mutexVideo, std::adopt_lock);
+    std::lock_guard<std::mutex> lockAudio(mutexAudio, std::adopt_lock);
+    std::lock_guard<std::mutex> lockSerial(mutexSerialRead, std::adopt_lock);
+    
+    /// Video
+    snapshot->frameSequence = frameCounter;
+    snapshot->videoWidth = videoWidth;
+    snapshot->videoHeight = videoHeight;
+    snapshot->frameBytes = 0;
+    if (frameDestination && frameData && frameCapacity >= frameTotalBytes) {
+        memcpy(frameDestination, frameData, frameTotalBytes);
+        snapshot->frameBytes = frameTotalBytes;
+    }
+    snapshot->hasVisualPreferences = hasVisualPreferences;
+    if (hasVisualPreferences) {
+        memcpy(snapshot->visualPreferences, visualPreferences, sizeof(visualPreferences));
+    }
+    
+    /// Audio
+    snapshot->audioSequence = audioSequence;
+    snapshot->audioSampleRate = audioSampleRate;
+    snapshot->audioBytes = 0;
+    snapshot->bytesPerSample = bytesPerSample;
+    if (audioDestination) {
+        copyAudio(audioDestination, audioCapacity, &snapshot->audioBytes, &snapshot->bytesPerSample);
     }
     
-    return audioDataFoo;
+    /// Serial
+    snapshot->serialSequence = serialSequence;
+    snapshot->serialData = lastSerialResult;
 }
 
 void SharedMemory::setSerialData(std::string data)
 {
     if (isWritingBlocked) {
-        logMessage("setSerialData >>> Blocked serial writing");
+        LOG_TRACE("setSerialData >>> Blocked serial writing");
         return;
     }
     mutexSerialRead.lock();
     
     if (data.length() > serialDataBufferCount) {
-        logMessage("data.length(): " + std::to_string(data.length()) + " > serialDataBufferCount: " + std::to_string(serialDataBufferCount));
+        LOG_WARNING("data.length(): " + std::to_string(data.length()) + " > serialDataBufferCount: " + std::to_string(serialDataBufferCount));
     }
     lastSerialResult = data;
+    serialSequence++;
     
     mutexSerialRead.unlock();
 }
@@ -155,7 +265,7 @@ char* SharedMemory::getSerialData(size_t* totalBytes)
     
     if (!serialData) {
         serialData = new char[serialDataBufferCount];
-        logMessage("serialData = new uint8_t[serialDataBufferCount];");
+        LOG_DEBUG("serialData = new uint8_t[serialDataBufferCount];");
     }
     
     strcpy(serialData, lastSerialResult.c_str());
@@ -165,4 +275,13 @@ char* SharedMemory::getSerialData(size_t* totalBytes)
     return serialData;
 }
 
+size_t SharedMemory::getSerialData(char* destination, size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutexSerialRead);
+    
+    size_t totalBytes = std::min(lastSerialResult.length(), capacity);
+    memcpy(destination, lastSerialResult.data(), totalBytes);
+    return totalBytes;
+}
+
 #endif // ! _SharedMemory_cpp
@@ -11,50 +11,82 @@
 
 #include <iostream>
 #include "Log.h"
+#include "Vision/ColorBlobs.h"
+#include "Core/RobotStatistics.h"
 
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 
-/// Class for storing the data. Intended for using with `singleton` mechanism.
-class SharedMemory : public Log {
+/// Consistent copy of all data in shared memory, taken under one acquisition of all locks.
+/// Sequence numbers count writes since creation of shared memory, so a reader can see what is new.
+struct SharedMemorySnapshot {
     
-private:
+    /// Video
+    uint64_t frameSequence = 0;
+    size_t frameBytes = 0;
+    unsigned int videoWidth = 0;
+    unsigned int videoHeight = 0;
     
-    /// Instance for used for `singleton` mechanism
-    static SharedMemory* instance;
+    /// Colour preferences of the frame, `vis_pref_vals(1:6, :)`, valid if `hasVisualPreferences`
+    bool hasVisualPreferences = false;
+    double visualPreferences[ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes];
     
-    /// Private constructor to prevent instancing
-    SharedMemory();
-    ~SharedMemory();
+    /// Audio
+    uint64_t audioSequence = 0;
+    size_t audioBytes = 0;
+    unsigned short bytesPerSample = 0;
+    unsigned int audioSampleRate = 0;
+    
+    /// Serial
+    uint64_t serialSequence = 0;
+    std::string serialData;
+};
+
+/// Class for storing the data.
+/// Every `NeuroRobotManager` owns one object of this class, so several robots can be driven from one process.
+class SharedMemory : public Log {
+    
+private:
     
     /// Mutex used in blocking access to some data
     std::mutex mutexVideo;
     std::mutex mutexAudio;
     std::mutex mutexSerialRead;
     
+    /// Signaled every time when new frame is written
+    std::condition_variable frameWritten;
+    
     /// Video data
     uint8_t *frameData = NULL;
     
+    /// Colour preferences of the last frame
+    bool hasVisualPreferences = false;
+    double visualPreferences[ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes];
+    
     /// Audio data
     uint8_t *audioData = NULL;
     unsigned short audioCounter = 0;
+    uint64_t audioSequence = 0;
+    uint8_t *audioDataRead = NULL;
+    size_t audioDataReadBytes = 0;
     unsigned short bytesPerSample = 0;
     bool isWritingBlocked = false;
     
     /// Serial data
     std::string lastSerialResult;
+    uint64_t serialSequence = 0;
     char *serialData = NULL;
     static const unsigned int serialDataBufferCount = 1000;
     
-    /// Writes audio data to store.
-    /// @param data Audio data
-    /// @param numberOfSamples_ Number of samples
-    /// @param bytesPerSample_ Bytes per sample
-    void writeAudioThreaded(uint8_t* data, size_t numberOfSamples_, unsigned short bytesPerSample_);
+    /// Copy audio data to forwarded buffer and mark it as read.
+    /// @warning `mutexAudio` has to be locked by caller.
+    void copyAudio(uint8_t* destination, size_t capacity, size_t* totalBytes_, unsigned short* bytesPerSample_);
     
 public:
     
-    /// Static instance.
-    static SharedMemory* getInstance();
+    SharedMemory();
+    ~SharedMemory();
     
     /// Total number of audio data bytes.
     size_t audioTotalBytes = 0;
@@ -71,6 +103,15 @@ public:
     /// Video height in px
     unsigned int videoHeight = 0;
     
+    /// Number of frames written since object creation.
+    uint64_t frameCounter = 0;
+    
+    /// Time when the packet of the last written frame was read from the stream.
+    std::chrono::steady_clock::time_point framePacketTime;
+    
+    /// Latencies and counters recorded by workers of the robot.
+    RobotStatistics statistics;
+    
     /// Block writers.
     void blockWritters();
     
@@ -80,13 +121,38 @@ public:
     /// Write one frame of video data to shared memory.
     /// @param data Video frame data
     /// @param frameSizeInBytes Data size in bytes
-    void writeFrame(uint8_t* data, size_t frameSizeInBytes);
+    /// @param packetTime Time when the packet of the frame was read from the stream
+    /// @param visualPreferences Colour preferences computed from the frame, `NULL` if they are not computed
+    void writeFrame(uint8_t* data, size_t frameSizeInBytes, std::chrono::steady_clock::time_point packetTime = std::chrono::steady_clock::now(), const double* visualPreferences = NULL);
     
     /// Read video frame from shared memory.
     /// @return Video frame data
     uint8_t* readVideoFrame();
     
-    /// Delegates other thread to write audio data to store.
+    /// Copy video frame from shared memory to forwarded buffer.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes
+    /// @return Number of copied bytes, 0 if there is no frame or the buffer is too small
+    size_t readVideoFrame(uint8_t* destination, size_t capacity);
+    
+    /// Read number of written frames.
+    /// @param packetTime Time when the packet of the last written frame was read, if not `NULL`
+    /// @return Number of frames written since object creation
+    uint64_t readFrameCounter(std::chrono::steady_clock::time_point* packetTime = NULL);
+    
+    /// Read colour preferences of the last frame.
+    /// @param values Buffer for `ColorBlobs::numberOfValues` x `ColorBlobs::numberOfEyes` values
+    /// @param frameSequence Sequence number of the frame, if not `NULL`
+    /// @return False if preferences were not computed for the last frame
+    bool readVisualPreferences(double* values, uint64_t* frameSequence = NULL);
+    
+    /// Block current thread until frame newer than `lastSequence` is written or timeout expires.
+    /// @param lastSequence Sequence number of the last frame caller has seen
+    /// @param timeoutMs Maximum waiting time in ms
+    /// @return Sequence number of the newest frame, equal to `lastSequence` on timeout
+    uint64_t waitForFrame(uint64_t lastSequence, unsigned int timeoutMs);
+    
+    /// Write audio data to store.
     /// @param data Audio data
     /// @param numberOfSamples_ Number of samples
     /// @param bytesPerSample_ Bytes per sample
@@ -98,6 +164,26 @@ public:
     /// @return Audio data from store
     uint8_t* readAudio(size_t* totalBytes_, unsigned short* bytesPerSample_);
     
+    /// Reads audio data from store directly to forwarded buffer.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes
+    /// @param totalBytes_ Total number of copied bytes
+    /// @param bytesPerSample_ Number of bytes per sample
+    void readAudio(uint8_t* destination, size_t capacity, size_t* totalBytes_, unsigned short* bytesPerSample_);
+    
+    /// Size of the biggest audio chunk which can be read at once.
+    /// @return Size in bytes
+    size_t audioCapacityBytes();
+    
+    /// Copy video, audio and serial data under one acquisition of all locks.
+    /// Audio is consumed like with `readAudio()`.
+    /// @param frameDestination Buffer for frame, frame is skipped if `NULL` or too small
+    /// @param frameCapacity Size of frame buffer in bytes
+    /// @param audioDestination Buffer for audio, audio is skipped if `NULL`
+    /// @param audioCapacity Size of audio buffer in bytes
+    /// @param snapshot Sizes, sequence numbers and serial data of the copied data
+    void readSnapshot(uint8_t* frameDestination, size_t frameCapacity, uint8_t* audioDestination, size_t audioCapacity, SharedMemorySnapshot* snapshot);
+    
     /// Write serial data to store.
     /// @param data Data to write
     void setSerialData(std::string data);
@@ -106,6 +192,12 @@ public:
     /// @param totalBytes Size of serial data which is forwarded parallel
     /// @return Serial data from store
     char* getSerialData(size_t* totalBytes);
+    
+    /// Copy serial data from store to forwarded buffer, without terminating `\0`.
+    /// @param destination Buffer to fill
+    /// @param capacity Size of buffer in bytes, longer data is truncated
+    /// @return Number of copied bytes
+    size_t getSerialData(char* destination, size_t capacity);
 };
 
 #endif /* SharedMemory_h */
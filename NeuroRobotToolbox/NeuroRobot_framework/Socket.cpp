@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <chrono>
+#include <cstring>
 
 #ifdef XCODE
     #include "Bridge/Helpers/AudioHelper.hpp"
@@ -44,15 +45,17 @@ static char* lltoa(long long number)
 }
 
 //MARK:- Socket
-Socket::Socket(std::string ip_, std::string port_, SocketErrorOccurredCallback callback_)
+Socket::Socket(std::string ip_, std::string port_, SharedMemory *sharedMemory_, SocketErrorOccurredCallback callback_)
 : socket(io_context)
 , audioSocket(io_context)
 , resolver(io_context)
 , audioResolver(io_context)
+, serialJobs(ThreadPool::getInstance())
 , Log("Socket")
 {
     ipAddress = ip_;
     port = port_;
+    sharedMemory = sharedMemory_;
     errorCallback = callback_;
     
     connectSerialSocket(ipAddress, port);
@@ -60,50 +63,52 @@ Socket::Socket(std::string ip_, std::string port_, SocketErrorOccurredCallback c
 
 Socket::~Socket()
 {
-    if (whileLoopIsRunning) {
-        semaphore.wait();
+    join();
+    
+    /// Audio sending wakes up from its sleeps on stop. Queued serial commands, e.g. stop of motors, are still sent.
+    {
+        std::lock_guard<std::mutex> lock(mutexAudioSender);
+        if (audioSender) { audioSender->join(); }
     }
+    serialJobs.join();
     closeSockets();
 }
 
 void Socket::run()
 {
-    logMessage("run >> entered ");
+    LOG_INFO("run >> entered ");
     
-    whileLoopIsRunning = true;
     while (isRunning()) {
-        logMessage("run >> while >> entered ");
+        LOG_TRACE("run >> while >> entered ");
         
         boost::system::error_code ec;
         std::string readSerialData = receiveSerial(&ec);
-        logMessage("run >> while >> received ");
+        LOG_TRACE("run >> while >> received ");
         
         if (ec) {
-            logMessage("run >> while >> error ");
+            LOG_WARNING("run >> while >> error ");
             updateState(SocketStateEOF, ec);
             
+            sharedMemory->statistics.count(RobotStatistics::CounterSerialReconnects);
             mutexReconnecting.lock();
             closeDataSocket();
-            boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+            sleepFor(std::chrono::milliseconds(100));
             connectSerialSocket(ipAddress, port);
             mutexReconnecting.unlock();
         }
-        logMessage("run >> while >> no err ");
+        LOG_TRACE("run >> while >> no err ");
         
         if (readSerialData.length() > 0) {
             if (isRunning()) {
-                SharedMemory::getInstance()->setSerialData(readSerialData);
-                logMessage("run >> while >> setSerialData");
+                sharedMemory->setSerialData(readSerialData);
+                LOG_TRACE("run >> while >> setSerialData");
             }
-            readSerialData.erase(std::remove(readSerialData.begin(), readSerialData.end(), '\n'), readSerialData.end());
-            logMessage(readSerialData);
+            LOG_TRACE(boost::erase_all_copy(readSerialData, "\n"));
         }
     }
-    whileLoopIsRunning = false;
     closeSockets();
-    semaphore.signal();
     
-    logMessage("Socket -> read serial ended");
+    LOG_INFO("Socket -> read serial ended");
 }
 
 void Socket::send(std::string stringData)
@@ -115,11 +120,11 @@ void Socket::send(std::string stringData)
     if (sendingInProgress) {
         pendingWriting = true;
         pendingData = pendingData + "\n" + stringData;
+        sharedMemory->statistics.count(RobotStatistics::CounterCoalescedSerialSends);
     } else {
         sendingInProgress = true;
         pendingData = "";
-        std::thread thread(&Socket::writeSerialThreadedString, this, stringData);
-        thread.detach();
+        serialJobs.enqueue(std::bind(&Socket::writeSerialThreadedString, this, stringData));
     }
     mutexSendingToSocket2.unlock();
 }
@@ -138,7 +143,8 @@ void Socket::writeSerialThreadedString(std::string stringData)
     memcpy(&wholeData[totalBytes - 1], footer, 1);
     
     size_t sentBytes = send(&socket, wholeData, totalBytes);
-    logMessage("serial data sent size: " + std::to_string(sentBytes));
+    sharedMemory->statistics.count(RobotStatistics::CounterSerialSends);
+    LOG_TRACE("serial data sent size: " + std::to_string(sentBytes));
     delete [] wholeData;
     
     sendingInProgress = false;
@@ -155,12 +161,19 @@ void Socket::sendAudio(int16_t* data, size_t numberOfBytes)
     }
     int16_t* dataToSend = (int16_t*)malloc(numberOfBytes + 1);
     std::memcpy(dataToSend, data, numberOfBytes);
-    std::thread thread(&Socket::sendAudioThreaded, this, dataToSend, numberOfBytes);
-    thread.detach();
+    
+    std::lock_guard<std::mutex> lock(mutexAudioSender);
+    if (!audioSender) { audioSender.reset(new ThreadPool(1)); }
+    audioSender->enqueue(std::bind(&Socket::sendAudioThreaded, this, dataToSend, numberOfBytes));
 }
 
 void Socket::sendAudioThreaded(int16_t* data, size_t numberOfBytes)
 {
+    /// Clips queued behind the one playing at stop are dropped without connecting
+    if (!isRunning()) {
+        free(data);
+        return;
+    }
     mutexSendingAudio.lock();
     
     int sampleRate = 8000;
@@ -193,8 +206,8 @@ void Socket::sendAudioThreaded(int16_t* data, size_t numberOfBytes)
     header.append("Connection: keepalive\r\n");
     header.append("Accept: */*\r\n\r\n");
     send(&audioSocket, header.c_str(), header.length());
-    logMessage(header);
-    boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+    LOG_DEBUG(header);
+    sleepFor(std::chrono::milliseconds(100));
     
     uint8_t* repackedData = AudioHelper::repack(data, numberOfBytes);
     free(data);
@@ -208,13 +221,15 @@ void Socket::sendAudioThreaded(int16_t* data, size_t numberOfBytes)
         elapsedTime = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - beginTime).count();
         long long sentDataInMilliseconds = (float)sentBytes / packetSize * packetSizeInMilliseconds;
         difference = sentDataInMilliseconds - elapsedTime;
-        logMessage("sendAudioThreaded >>> difference: " + std::to_string(difference));
+        LOG_TRACE("sendAudioThreaded >>> difference: " + std::to_string(difference));
         
         /// Keep apx. 500ms in robot's buffer. For 1000ms, video stream stuck.
         /// Make delay of at least 100ms and make sure not to block robot only with audio data.
         long long sleepMS = difference - maxMSInBuffer;
         if (sleepMS < 100) sleepMS = 100;
-        boost::this_thread::sleep_for(boost::chrono::milliseconds(sleepMS));
+        std::chrono::steady_clock::time_point wakeUp = std::chrono::steady_clock::now() + std::chrono::milliseconds(sleepMS);
+        if (!sleepUntil(wakeUp)) { break; }
+        sharedMemory->statistics.record(RobotStatistics::StageWakeUp, wakeUp);
         
         /// Whether to send full packet or rest of the audio data.
         if (numberOfBytes > packetSize) {
@@ -229,9 +244,10 @@ void Socket::sendAudioThreaded(int16_t* data, size_t numberOfBytes)
             /// Wait until the song is over and add additionally 2 sec just in case
             sentDataInMilliseconds = (float)sentBytes / packetSize * packetSizeInMilliseconds;
             difference = sentDataInMilliseconds - elapsedTime;
-            boost::this_thread::sleep_for(boost::chrono::milliseconds(difference + 2000));
+            sleepFor(std::chrono::milliseconds(difference + 2000));
         }
-        logMessage("audio chunk sent");
+        sharedMemory->statistics.count(RobotStatistics::CounterAudioChunks);
+        LOG_TRACE("audio chunk sent");
     }
     
     free(repackedData);
@@ -242,29 +258,30 @@ void Socket::sendAudioThreaded(int16_t* data, size_t numberOfBytes)
 
 void Socket::connectSerialSocket(const std::string& ipAddress, const std::string& port)
 {
+    RobotStatistics::StageTimer connectTimer(&sharedMemory->statistics, RobotStatistics::StageSerialConnect);
     boost::system::error_code ec;
     updateState(SocketStateConnecting, ec);
     
     boost::asio::connect(socket, resolver.resolve(ipAddress, port), ec);
     if (ec) {
         updateState(SocketErrorCannotConnect, ec);
-        logMessage("connectSerialSocket >>> error: " + ec.message() + " ipAddress: " + ipAddress + " port: " + port);
+        LOG_ERROR("connectSerialSocket >>> error: " + ec.message() + " ipAddress: " + ipAddress + " port: " + port);
     } else {
         #ifdef _WIN32
             socket.set_option(rcv_timeout_option{ 1000 }, ec);
             if (ec) {
-                logMessage("connectSerialSocket >>> socket.set_option error: " + ec.message());
+                LOG_WARNING("connectSerialSocket >>> socket.set_option error: " + ec.message());
             }
         #endif
         
         uint8_t dataToOpenReceiving[] = { 0x01, 0x55 };
         size_t sentSize = socket.send(boost::asio::buffer(dataToOpenReceiving, 2), 0, ec);
         
-        logMessage("connectSerialSocket >>> sentSize: " + std::to_string(sentSize));
+        LOG_DEBUG("connectSerialSocket >>> sentSize: " + std::to_string(sentSize));
         
         if (!sentSize || ec) {
-            logMessage("connectSerialSocket >>> cannot open socket");
-            logMessage("connectSerialSocket >>> ec: " + ec.message());
+            LOG_ERROR("connectSerialSocket >>> cannot open socket");
+            LOG_ERROR("connectSerialSocket >>> ec: " + ec.message());
         } else {
             boost::this_thread::sleep_for(boost::chrono::milliseconds(200));
             updateState(SocketStateConnected, ec);
@@ -283,27 +300,30 @@ void Socket::connectAudioSocket(const std::string& ipAddress, const std::string&
 
 size_t Socket::send(tcp::socket* socket, const void* data, size_t totalBytes)
 {
-    logMessage("send >> enter");
+    LOG_TRACE("send >> enter");
     if (stateType != SocketStateConnected) {
         return 0;
     }
     boost::system::error_code ec;
     
     mutexSendingToSocket.lock();
+    std::chrono::steady_clock::time_point writeBegin = std::chrono::steady_clock::now();
     size_t sentSize = boost::asio::write(*socket, boost::asio::buffer(data, totalBytes), ec);
-    logMessage("send >> boost::asio::write >> size: " + std::to_string(sentSize));
+    sharedMemory->statistics.record(socket == &audioSocket ? RobotStatistics::StageAudioSend : RobotStatistics::StageSerialSend, writeBegin);
+    LOG_TRACE("send >> boost::asio::write >> size: " + std::to_string(sentSize));
     if (ec) {
-        logMessage("send >> error " + ec.message());
+        sharedMemory->statistics.count(RobotStatistics::CounterSendErrors);
+        LOG_ERROR("send >> error " + ec.message());
         if ((boost::asio::error::eof == ec) || (boost::asio::error::connection_reset == ec)) {
             //when we lose wifi network completely this error will appear net time we try to send something:
             //Error in Socket::send: An existing connection was forcibly closed by the remote host
-            logMessage("We lost WiFi network. Need to reset everything.");
+            LOG_ERROR("We lost WiFi network. Need to reset everything.");
             updateState(SocketErrorLostConnection, ec);
         } else {
             updateState(SocketErrorWhileSending, ec);
         }
     }
-    logMessage("send >> no err ");
+    LOG_TRACE("send >> no err ");
     boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
     mutexSendingToSocket.unlock();
     
@@ -312,18 +332,19 @@ size_t Socket::send(tcp::socket* socket, const void* data, size_t totalBytes)
 
 std::string Socket::receiveSerial(boost::system::error_code* ec)
 {
-    logMessage("receiveSerial >> entered");
+    LOG_TRACE("receiveSerial >> entered");
     if (stateType != SocketStateConnected && !socket.is_open()) {
         return "";
     }
-    logMessage("receiveSerial >> passed >> stateType != SocketStateConnected");
+    LOG_TRACE("receiveSerial >> passed >> stateType != SocketStateConnected");
     boost::asio::streambuf b(10000);
-    logMessage("receiveSerial >> boost::asio::streambuf b;");
+    LOG_TRACE("receiveSerial >> boost::asio::streambuf b;");
     boost::asio::read_until(socket, b, "\r\n", *ec);
-    logMessage("receiveSerial >> boost::asio::read_until(");
+    LOG_TRACE("receiveSerial >> boost::asio::read_until(");
     
-    if (*ec) { logMessage("receiveSerial >> ec >> " + ec->message()); return ""; }
+    if (*ec) { LOG_WARNING("receiveSerial >> ec >> " + ec->message()); return ""; }
     
+    RobotStatistics::StageTimer parseTimer(&sharedMemory->statistics, RobotStatistics::StageSerialReceive);
     std::istream is(&b);
     std::string data;
     std::string dataFoo;
@@ -331,6 +352,7 @@ std::string Socket::receiveSerial(boost::system::error_code* ec)
     std::string dataPreLastLine;
     
     while (std::getline(is, dataFoo)) {
+        sharedMemory->statistics.count(RobotStatistics::CounterSerialLines);
         dataPreLastLine = dataLastLine;
         dataLastLine = dataFoo;
     }
@@ -340,7 +362,7 @@ std::string Socket::receiveSerial(boost::system::error_code* ec)
     }
     
     boost::erase_all(dataPreLastLine, "\x01U");
-    logMessage("receiveSerial >> done");
+    LOG_TRACE("receiveSerial >> done");
     
     return dataPreLastLine;
 }
@@ -351,7 +373,7 @@ void Socket::closeSockets()
     boost::system::error_code ec;
     updateState(SocketStateStopped, ec);
     
-    logMessage("------------- closeSockets -----------");
+    LOG_INFO("------------- closeSockets -----------");
     
     closeDataSocket();
     closeAudioSocket();
@@ -401,7 +423,7 @@ void Socket::updateState(SocketStateType stateType_, boost::system::error_code e
         errorMessage = errorCode.message();
     }
     
-    logMessage("updateState >>> state: '" + std::string(getSocketStateMessage(stateType)) + "' >>> " + errorMessage);
+    LOG_INFO("updateState >>> state: '" + std::string(getSocketStateMessage(stateType)) + "' >>> " + errorMessage);
     if (errorCallback && stateType >= 100) {
         errorCallback(stateType);
     }
@@ -13,7 +13,7 @@
 #include "Macros.h"
 #include "SharedMemory.h"
 #include "Log.h"
-#include "Core/Semaphore.h"
+#include "Core/ThreadPool.h"
 
 #ifdef MATLAB
     #include "TypeDefs.h"
@@ -22,6 +22,7 @@
 #endif
 
 #include <chrono>
+#include <memory>
 
 #include <boost/asio.hpp>
 
@@ -37,6 +38,9 @@ private:
     std::string ipAddress;
     std::string port;
     
+    /// Storage for received serial data. Owned by `NeuroRobotManager`.
+    SharedMemory *sharedMemory = NULL;
+    
     boost::asio::io_context io_context;
     tcp::socket socket;
     tcp::socket audioSocket;
@@ -48,8 +52,14 @@ private:
     std::mutex mutexSendingToSocket;
     std::mutex mutexSendingToSocket2;
     std::mutex mutexSendingAudio;
-    Semaphore semaphore;
-    bool whileLoopIsRunning = false;
+    
+    /// Serial sends run on the shared pool, joined before socket is destroyed so no job outlives it.
+    ThreadPoolGroup serialJobs;
+    
+    /// Worker of audio sends, created with the first clip. Not on the shared pool, because one clip
+    /// holds the worker for the length of the clip.
+    std::mutex mutexAudioSender;
+    std::unique_ptr<ThreadPool> audioSender;
     
     /// Serial communication
     bool sendingInProgress = false;
@@ -110,8 +120,9 @@ public:
     /// Init socket and connect to serial socket.
     /// @param ip IP address of robot
     /// @param port Port of socket
+    /// @param sharedMemory Storage for received serial data
     /// @param callback Callback in case if the error occurs
-    Socket(std::string ip, std::string port, SocketErrorOccurredCallback callback);
+    Socket(std::string ip, std::string port, SharedMemory *sharedMemory, SocketErrorOccurredCallback callback);
     
     ~Socket();
     
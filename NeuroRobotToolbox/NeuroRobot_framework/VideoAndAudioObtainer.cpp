@@ -15,16 +15,13 @@
 #endif
 
 #include <iostream>
+#include <fstream>
+#include <iomanip>
 #include <thread>
-
-/// Used for `interruptFunction`.
-static std::chrono::system_clock::time_point beginTime;
-
-/// Used to derermine whether is process of reading new packet running.
-static bool isReadingNextFrame = false;
-
-/// Used to deremine if initial setup of streamers is done.
-static bool initDone = false;
+#include <map>
+#include <mutex>
+#include <vector>
+#include <boost/filesystem.hpp>
 
 /// Used as maxium ms for connecting.
 static long long timeOutWhileConnecting = 5000;
@@ -32,23 +29,242 @@ static long long timeOutWhileConnecting = 5000;
 /// Used as maxium ms for obtaining new packet from robot.
 static long long timeOutWhileObtainingPacket = 2000;
 
-/// Interrupt function used for determining if some critical point in code are blocking other parts more then expected.
-/// @param ctx Pointer to `AVFormatContext`
-static int interruptFunction(void* ctx)
+/// Probing limits of fast start. Parameters which are not found within them are taken from the last connection.
+/// Probe size is the minimum of ffmpeg, analyze duration 0 would mean ffmpeg default (5 s).
+static const char *fastStartProbeSize = "32";
+static const char *fastStartAnalyzeDurationUs = "100000";
+static const char *fastStartFpsProbeSize = "0";
+
+//MARK:- Stream parameters of last connections
+
+/// Stream of the last fully probed connection to one url.
+struct CachedStream {
+    /// Session description announced by the source, see `VideoAndAudioObtainer::describeSession()`
+    std::string sessionDescription;
+    
+    /// Codec parameters of all streams
+    std::vector<AVCodecParameters *> parameters;
+};
+
+/// Last connections per url. Shared by all robots of the process and persisted in `streamCacheDirectory`, so fast start works also in the first connection of a session.
+static std::mutex mutexCachedStreams;
+static std::map<std::string, CachedStream> cachedStreams;
+
+/// Folder with one file per url, next to the logs.
+static const char *streamCacheDirectory = "Logs/cache";
+
+/// Version of cache file, files of other versions are ignored.
+static const int streamCacheVersion = 1;
+
+/// Bigger extradata is taken as damaged cache file.
+static const int maxExtradataSize = 1 << 20;
+
+static void freeStreamParameters(std::vector<AVCodecParameters *> &parameters)
+{
+    for (AVCodecParameters *streamParameters : parameters) {
+        avcodec_parameters_free(&streamParameters);
+    }
+    parameters.clear();
+}
+
+/// Copy parameters of all streams of `formatCtx`.
+static void copyStreamParameters(const AVFormatContext *formatCtx, std::vector<AVCodecParameters *> &parameters)
+{
+    for (unsigned int i = 0; i < formatCtx->nb_streams; i++) {
+        AVCodecParameters *streamParameters = avcodec_parameters_alloc();
+        avcodec_parameters_copy(streamParameters, formatCtx->streams[i]->codecpar);
+        parameters.push_back(streamParameters);
+    }
+}
+
+/// Path of cache file of `url`. Every character which is not allowed in file names is replaced.
+static boost::filesystem::path streamCachePath(const std::string &url)
+{
+    std::string fileName = url;
+    for (char &character : fileName) {
+        if (!isalnum((unsigned char)character) && character != '.' && character != '-') {
+            character = '_';
+        }
+    }
+    return boost::filesystem::path(streamCacheDirectory) / (fileName + ".txt");
+}
+
+/// Write `cachedStream` of `url` to disk. Failures are ignored, the stream is then fully probed in the next session.
+static void writeStreamCacheFile(const std::string &url, const CachedStream &cachedStream)
+{
+    boost::system::error_code error;
+    boost::filesystem::create_directories(streamCacheDirectory, error);
+    if (error) { return; }
+    
+    std::ofstream file(streamCachePath(url).string(), std::ios::trunc);
+    if (!file) { return; }
+    
+    file << "version " << streamCacheVersion << "\n";
+    file << "sdp " << cachedStream.sessionDescription.size() << "\n" << cachedStream.sessionDescription << "\n";
+    file << "streams " << cachedStream.parameters.size() << "\n";
+    for (const AVCodecParameters *streamParameters : cachedStream.parameters) {
+        file << streamParameters->codec_type << " " << streamParameters->codec_id << " " << streamParameters->codec_tag << " "
+            << streamParameters->format << " " << streamParameters->bit_rate << " " << streamParameters->profile << " " << streamParameters->level << " "
+            << streamParameters->width << " " << streamParameters->height << " "
+            << streamParameters->sample_aspect_ratio.num << " " << streamParameters->sample_aspect_ratio.den << " "
+            << streamParameters->sample_rate << " " << streamParameters->channels << " " << streamParameters->channel_layout << " "
+            << streamParameters->frame_size << " " << streamParameters->extradata_size;
+        
+        file << std::hex << std::setfill('0');
+        for (int i = 0; i < streamParameters->extradata_size; i++) {
+            file << " " << std::setw(2) << (int)streamParameters->extradata[i];
+        }
+        file << std::dec << "\n";
+    }
+}
+
+/// Read cache of `url` written by `writeStreamCacheFile()`.
+/// @return False if there is no valid cache file
+static bool readStreamCacheFile(const std::string &url, CachedStream &cachedStream)
+{
+    std::ifstream file(streamCachePath(url).string());
+    if (!file) { return false; }
+    
+    std::string key;
+    int version = 0;
+    size_t sessionDescriptionSize = 0;
+    size_t numberOfStreams = 0;
+    
+    file >> key >> version;
+    if (!file || key != "version" || version != streamCacheVersion) { return false; }
+    
+    file >> key >> sessionDescriptionSize;
+    if (!file || key != "sdp") { return false; }
+    file.get();
+    cachedStream.sessionDescription.resize(sessionDescriptionSize);
+    file.read(&cachedStream.sessionDescription[0], sessionDescriptionSize);
+    
+    file >> key >> numberOfStreams;
+    if (!file || key != "streams") { return false; }
+    
+    for (size_t i = 0; i < numberOfStreams; i++) {
+        AVCodecParameters *streamParameters = avcodec_parameters_alloc();
+        cachedStream.parameters.push_back(streamParameters);
+        
+        int codecType = 0;
+        int codecId = 0;
+        file >> codecType >> codecId >> streamParameters->codec_tag
+            >> streamParameters->format >> streamParameters->bit_rate >> streamParameters->profile >> streamParameters->level
+            >> streamParameters->width >> streamParameters->height
+            >> streamParameters->sample_aspect_ratio.num >> streamParameters->sample_aspect_ratio.den
+            >> streamParameters->sample_rate >> streamParameters->channels >> streamParameters->channel_layout
+            >> streamParameters->frame_size >> streamParameters->extradata_size;
+        if (!file || streamParameters->extradata_size < 0 || streamParameters->extradata_size > maxExtradataSize) {
+            streamParameters->extradata_size = 0;
+            freeStreamParameters(cachedStream.parameters);
+            return false;
+        }
+        streamParameters->codec_type = (AVMediaType)codecType;
+        streamParameters->codec_id = (AVCodecID)codecId;
+        
+        if (streamParameters->extradata_size > 0) {
+            streamParameters->extradata = (uint8_t *)av_mallocz(streamParameters->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+            file >> std::hex;
+            for (int j = 0; j < streamParameters->extradata_size; j++) {
+                int value = 0;
+                file >> value;
+                streamParameters->extradata[j] = (uint8_t)value;
+            }
+            file >> std::dec;
+        }
+        if (!file) {
+            freeStreamParameters(cachedStream.parameters);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Copy cached stream of `url` to `sessionDescription` and `parameters`, from disk if it is not cached in this process yet.
+/// @return False if there is no connection to `url` cached
+static bool readCachedStreamParameters(const std::string &url, std::string &sessionDescription, std::vector<AVCodecParameters *> &parameters)
+{
+    std::lock_guard<std::mutex> lock(mutexCachedStreams);
+    std::map<std::string, CachedStream>::iterator cached = cachedStreams.find(url);
+    if (cached == cachedStreams.end()) {
+        CachedStream cachedStream;
+        if (!readStreamCacheFile(url, cachedStream)) { return false; }
+        cached = cachedStreams.insert(std::make_pair(url, cachedStream)).first;
+    }
+    
+    sessionDescription = cached->second.sessionDescription;
+    for (AVCodecParameters *cachedParameters : cached->second.parameters) {
+        AVCodecParameters *streamParameters = avcodec_parameters_alloc();
+        avcodec_parameters_copy(streamParameters, cachedParameters);
+        parameters.push_back(streamParameters);
+    }
+    return true;
+}
+
+/// Whether probing found everything needed to decode stream.
+static bool hasStreamParameters(const AVCodecParameters *streamParameters)
+{
+    switch (streamParameters->codec_type) {
+        case AVMEDIA_TYPE_VIDEO:
+            return streamParameters->width > 0 && streamParameters->height > 0;
+        case AVMEDIA_TYPE_AUDIO:
+            return streamParameters->sample_rate > 0;
+        default:
+            return true;
+    }
+}
+
+/// Cache session description and parameters of all streams of `formatCtx` for `url`, unless probing did not find some of them.
+static void storeCachedStreamParameters(const std::string &url, const std::string &sessionDescription, const AVFormatContext *formatCtx)
+{
+    for (unsigned int i = 0; i < formatCtx->nb_streams; i++) {
+        if (!hasStreamParameters(formatCtx->streams[i]->codecpar)) { return; }
+    }
+    
+    CachedStream cachedStream;
+    cachedStream.sessionDescription = sessionDescription;
+    copyStreamParameters(formatCtx, cachedStream.parameters);
+    
+    std::lock_guard<std::mutex> lock(mutexCachedStreams);
+    freeStreamParameters(cachedStreams[url].parameters);
+    cachedStreams[url] = cachedStream;
+    writeStreamCacheFile(url, cachedStream);
+}
+
+static void forgetCachedStreamParameters(const std::string &url)
+{
+    std::lock_guard<std::mutex> lock(mutexCachedStreams);
+    boost::system::error_code error;
+    boost::filesystem::remove(streamCachePath(url), error);
+    
+    std::map<std::string, CachedStream>::iterator cached = cachedStreams.find(url);
+    if (cached == cachedStreams.end()) { return; }
+    
+    freeStreamParameters(cached->second.parameters);
+    cachedStreams.erase(cached);
+}
+
+//MARK:- VideoAndAudioObtainer
+
+int VideoAndAudioObtainer::interruptFunction(void* ctx)
 {
-    if (!initDone) {
-        AVFormatContext* formatCtx = (AVFormatContext*) ctx;
-        long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - beginTime).count();
+    VideoAndAudioObtainer* self = (VideoAndAudioObtainer*) ctx;
+    if (!self->initDone) {
+        long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - self->beginTime).count();
 //        std::cout << "init >>> elapsed time [ms]: " << elapsedTime << std::endl;
-        if (elapsedTime > timeOutWhileConnecting && formatCtx) {
+        if (elapsedTime > timeOutWhileConnecting && self->formatCtx) {
             return 1;
         }
-    } else if (isReadingNextFrame) {
-        long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - beginTime).count();
+    } else if (self->isReadingNextFrame) {
+        /// Stop does not wait for the next packet
+        if (!self->isRunning()) {
+            return 1;
+        }
+        long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - self->beginTime).count();
 //        std::cout << "Reading frame >>> elapsed time [ms]: " << elapsedTime << std::endl;
         if (elapsedTime > timeOutWhileObtainingPacket) {
             std::cout << "Continue to reconnection" << std::endl;
-            isReadingNextFrame = false;
+            self->isReadingNextFrame = false;
             return 1;
         }
     }
@@ -56,13 +272,21 @@ static int interruptFunction(void* ctx)
 }
 
 // 1111 ////
-VideoAndAudioObtainer::VideoAndAudioObtainer(std::string ipAddress, StreamErrorOccurredCallback callback, bool audioBlocked)
+VideoAndAudioObtainer::VideoAndAudioObtainer(std::string ipAddress, SharedMemory *sharedMemory, StreamErrorOccurredCallback callback, bool audioBlocked, std::string url, bool fastStart)
 : Log("VideoAndAudioObtainer")
 {
+    this->sharedMemory = sharedMemory;
+    this->fastStart = fastStart;
     this->errorCallback = callback;
-    this->url = StringHelper::createUrl("admin", "admin", ipAddress);
+    if (url.empty()) {
+        this->url = StringHelper::createUrl("admin", "admin", ipAddress);
+    } else {
+        this->url = url;
+        /// Local files are replayed at the speed they were recorded
+        this->realTimePacing = url.find("://") == std::string::npos || url.compare(0, 7, "file://") == 0;
+    }
     this->audioBlocked = audioBlocked;
-    logMessage("ip: " + ipAddress);
+    LOG_INFO("ip: " + ipAddress + " url: " + this->url);
     setupStreamers();
 }
 // //// 2222 ////
@@ -80,63 +304,64 @@ VideoAndAudioObtainer::VideoAndAudioObtainer(std::string ipAddress, StreamErrorO
 
 VideoAndAudioObtainer::~VideoAndAudioObtainer()
 {
-    if (whileLoopIsRunning) {
-        semaphore.wait();
-    }
+    join();
     closeStreams();
 }
 
 bool VideoAndAudioObtainer::setupStreamers()
 {
-    logMessage("reset >>> started");
+    LOG_INFO("reset >>> started");
     
     int retVal = -1;
     
-    SharedMemory::getInstance()->unblockWritters();
+    sharedMemory->unblockWritters();
 
-    logMessage("setupStreamers >>> SharedMemory::getInstance()->unblockWritters(); >> ok");
-    formatCtx = avformat_alloc_context();
-    logMessage("setupStreamers >>> formatCtx = avformat_alloc_context(); >> ok");
+    LOG_DEBUG("setupStreamers >>> sharedMemory->unblockWritters(); >> ok");
     frame = av_frame_alloc();
-    logMessage("setupStreamers >>> frame = av_frame_alloc(); >> ok");
+    LOG_DEBUG("setupStreamers >>> frame = av_frame_alloc(); >> ok");
     pictureRgb = av_frame_alloc();
-    logMessage("setupStreamers >>> pictureRgb = av_frame_alloc(); >> ok");
+    LOG_DEBUG("setupStreamers >>> pictureRgb = av_frame_alloc(); >> ok");
 
     /// Register everything
     avformat_network_init();
-    logMessage("setupStreamers >>> avformat_network_init(); >> ok");
-
-    /// Open RTSP
-    AVDictionary* stream_opts = 0;
-    av_dict_set(&stream_opts, "rtp", "write_to_source", 0);
+    LOG_DEBUG("setupStreamers >>> avformat_network_init(); >> ok");
     
-    /// Reset time for interrupt
-    beginTime = std::chrono::system_clock::now();
     initDone = false;
-    
-    AVIOInterruptCB int_cb = { interruptFunction, &formatCtx };
-    formatCtx->interrupt_callback = int_cb;
-    
-    /// Set flag because 16 is flag indicates to send bye packets while closing stream
-    formatCtx->flags = formatCtx->flags | 16;
-    logMessage("setupStreamers >>> formatCtx->flags >> ok " + std::to_string(formatCtx->flags));
-    
-    retVal = avformat_open_input(&formatCtx, url.c_str(), NULL, &stream_opts);
-    av_dict_free(&stream_opts);
-    if (retVal != 0) {
-        StreamStateType stateType = StreamErrorAvformatOpenInput;
-        if (retVal == AVERROR_EXIT) {
-            /// If it's returned by interrupt
-            stateType = StreamErrorNotConnected;
-        }
-        updateState(stateType, retVal);
+    pacingStartPts = AV_NOPTS_VALUE;
+    streamParametersMismatch = false;
+    std::chrono::steady_clock::time_point openBegin = std::chrono::steady_clock::now();
+    
+    /// Fast start probes only the first packets and takes the rest from the last connection to the same url.
+    /// Probing is skipped if the source announces the same session as in the last connection.
+    std::string cachedSessionDescription;
+    std::vector<AVCodecParameters *> cachedParameters;
+    fastStarted = fastStart && readCachedStreamParameters(url, cachedSessionDescription, cachedParameters);
+    
+    StreamStateType failedState = StreamStateNotStarted;
+    retVal = openStream(fastStarted, fastStarted ? cachedSessionDescription : "", &failedState);
+    
+    /// Stream is opened but differs from the last connection, probe it fully. Connection errors are not retried.
+    if (fastStarted && formatCtx && (retVal < 0 || !applyCachedParameters(cachedParameters))) {
+        LOG_WARNING("setupStreamers >>> stream differs from the last connection >>> full probing");
+        sharedMemory->statistics.count(RobotStatistics::CounterFastStartFallbacks);
+        forgetCachedStreamParameters(url);
+        fastStarted = false;
+        avformat_close_input(&formatCtx);
+        retVal = openStream(false, "", &failedState);
+    }
+    freeStreamParameters(cachedParameters);
+    if (retVal < 0) {
+        updateState(failedState, retVal);
         return false;
     }
-    logMessage("setupStreamers >>> avformat_open_input >> ok");
-
-    retVal = avformat_find_stream_info(formatCtx, NULL);
-    if (retVal < 0) { updateState(StreamErrorAvformatFindStreamInfo, retVal); return false; }
-    logMessage("setupStreamers >>> avformat_find_stream_info >> ok");
+    
+    if (fastStarted) {
+        sharedMemory->statistics.count(RobotStatistics::CounterFastStarts);
+    } else if (fastStart) {
+        storeCachedStreamParameters(url, sessionDescription, formatCtx);
+    }
+    sharedMemory->statistics.record(RobotStatistics::StageStreamOpen, openBegin);
+    openDuration = std::chrono::steady_clock::now() - openBegin;
 
     /// Search for video and audio stream index
     for (int i = 0; i < formatCtx->nb_streams; i++) {
@@ -149,20 +374,97 @@ bool VideoAndAudioObtainer::setupStreamers()
 
     av_read_play(formatCtx);
     
-    if (videoStreamIndex == -1) { logMessage("setupStreamers >>> Cannot find video stream"); }
+    if (videoStreamIndex == -1) { LOG_WARNING("setupStreamers >>> Cannot find video stream"); }
     setupVideoStreamer();
     
     if (!audioBlocked && audioStreamIndex != -1) {
         setupAudioStreamer();
     } else {
-        logMessage("setupStreamers >>> Audio blocked or cannot find audio stream");
+        LOG_INFO("setupStreamers >>> Audio blocked or cannot find audio stream");
     }
     
     stateType = StreamStateNotStarted;
     
     initDone = true;
-    logMessage("setupStreamers >>> done");
+    LOG_INFO("setupStreamers >>> done");
+    
+    return true;
+}
+
+int VideoAndAudioObtainer::openStream(bool minimalProbing, const std::string &knownSessionDescription, StreamStateType *failedState)
+{
+    int retVal = -1;
+    
+    formatCtx = avformat_alloc_context();
+    LOG_DEBUG("openStream >>> formatCtx = avformat_alloc_context(); >> ok");
+    
+    /// Open RTSP
+    AVDictionary* stream_opts = 0;
+    av_dict_set(&stream_opts, "rtp", "write_to_source", 0);
+    if (minimalProbing) {
+        av_dict_set(&stream_opts, "probesize", fastStartProbeSize, 0);
+        av_dict_set(&stream_opts, "analyzeduration", fastStartAnalyzeDurationUs, 0);
+        av_dict_set(&stream_opts, "fpsprobesize", fastStartFpsProbeSize, 0);
+    }
+    
+    /// Reset time for interrupt
+    beginTime = std::chrono::system_clock::now();
+    
+    AVIOInterruptCB int_cb = { interruptFunction, this };
+    formatCtx->interrupt_callback = int_cb;
+    
+    /// Set flag because 16 is flag indicates to send bye packets while closing stream
+    formatCtx->flags = formatCtx->flags | 16;
+    LOG_DEBUG("openStream >>> formatCtx->flags >> ok " + std::to_string(formatCtx->flags));
+    
+    retVal = avformat_open_input(&formatCtx, url.c_str(), NULL, &stream_opts);
+    av_dict_free(&stream_opts);
+    if (retVal != 0) {
+        *failedState = StreamErrorAvformatOpenInput;
+        if (retVal == AVERROR_EXIT) {
+            /// If it's returned by interrupt
+            *failedState = StreamErrorNotConnected;
+        }
+        return retVal;
+    }
+    LOG_DEBUG("openStream >>> avformat_open_input >> ok");
     
+    /// Session is described before probing, which completes parameters of streams
+    sessionDescription = describeSession();
+    if (!knownSessionDescription.empty() && sessionDescription == knownSessionDescription) {
+        LOG_DEBUG("openStream >>> session is the same as in the last connection >> probing skipped");
+        return 0;
+    }
+    
+    retVal = avformat_find_stream_info(formatCtx, NULL);
+    if (retVal < 0) {
+        *failedState = StreamErrorAvformatFindStreamInfo;
+        return retVal;
+    }
+    LOG_DEBUG("openStream >>> avformat_find_stream_info >> ok" + std::string(minimalProbing ? " >> fast start" : ""));
+    
+    return 0;
+}
+
+std::string VideoAndAudioObtainer::describeSession()
+{
+    char description[sessionDescriptionCapacity];
+    if (av_sdp_create(&formatCtx, 1, description, sizeof(description)) < 0) { return ""; }
+    return description;
+}
+
+bool VideoAndAudioObtainer::applyCachedParameters(const std::vector<AVCodecParameters *> &cachedParameters)
+{
+    if (formatCtx->nb_streams != cachedParameters.size()) { return false; }
+    
+    for (unsigned int i = 0; i < formatCtx->nb_streams; i++) {
+        AVCodecParameters *streamParameters = formatCtx->streams[i]->codecpar;
+        if (streamParameters->codec_type != cachedParameters[i]->codec_type || streamParameters->codec_id != cachedParameters[i]->codec_id) { return false; }
+        
+        if (!hasStreamParameters(streamParameters)) {
+            avcodec_parameters_copy(streamParameters, cachedParameters[i]);
+        }
+    }
     return true;
 }
 
@@ -173,41 +475,41 @@ bool VideoAndAudioObtainer::setupVideoStreamer()
     /// Get the codec
     videoCodec = avcodec_find_decoder(AV_CODEC_ID_H264);
     if (!videoCodec) { updateState(StreamErrorAvcodecFindDecoderVideo, -1); return false; }
-    logMessage("setupVideoStreamer >>> avcodec_find_decoder >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> avcodec_find_decoder >> ok");
 
     videoCodecCtx = avcodec_alloc_context3(videoCodec);
 
     retVal = avcodec_parameters_to_context(videoCodecCtx, formatCtx->streams[videoStreamIndex]->codecpar);
     if (retVal < 0) { updateState(StreamErrorAvcodecParametersToContextVideo, retVal); return false; }
-    logMessage("setupVideoStreamer >>> avcodec_parameters_to_context >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> avcodec_parameters_to_context >> ok");
 
     retVal = avcodec_open2(videoCodecCtx, videoCodec, NULL);
     if (retVal < 0) { updateState(StreamErrorAvcodecOpen2Video, retVal); return false; }
-    logMessage("setupVideoStreamer >>> avcodec_open2 >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> avcodec_open2 >> ok");
     
     frameSize = av_image_get_buffer_size(AV_PIX_FMT_RGB24, videoCodecCtx->width, videoCodecCtx->height, 1);
     if (frameSize < 0) {
-        logMessage("run >>> width: " + std::to_string(videoCodecCtx->width) + " height: " + std::to_string(videoCodecCtx->height));
+        LOG_WARNING("run >>> width: " + std::to_string(videoCodecCtx->width) + " height: " + std::to_string(videoCodecCtx->height));
         updateState(StreamErrorAvcodecFrameSize, frameSize);
         frameSize = 6220800; // 1080 * 1920 * 3
     }
-    logMessage("setupVideoStreamer >>> frameSize: " + std::to_string(frameSize));
+    LOG_DEBUG("setupVideoStreamer >>> frameSize: " + std::to_string(frameSize));
     
-    SharedMemory::getInstance()->frameTotalBytes = frameSize;
-    SharedMemory::getInstance()->videoWidth = videoCodecCtx->width;
-    SharedMemory::getInstance()->videoHeight = videoCodecCtx->height;
+    sharedMemory->frameTotalBytes = frameSize;
+    sharedMemory->videoWidth = videoCodecCtx->width;
+    sharedMemory->videoHeight = videoCodecCtx->height;
     
     uint8_t* frameBufferFoo = (uint8_t*)(av_malloc(frameSize));
-    logMessage("setupVideoStreamer >>> frameBufferFoo malloc >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> frameBufferFoo malloc >> ok");
     
     av_image_fill_arrays(pictureRgb->data, pictureRgb->linesize, frameBufferFoo, AV_PIX_FMT_RGB24, videoCodecCtx->width, videoCodecCtx->height, 1);
-    logMessage("setupVideoStreamer >>> av_image_fill_arrays >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> av_image_fill_arrays >> ok");
     
     av_free(frameBufferFoo);
-    logMessage("setupVideoStreamer >>> free(frameBufferFoo) >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> free(frameBufferFoo) >> ok");
     
     frameRawData[0] = new uint8_t[frameSize];
-    logMessage("setupVideoStreamer >>> frameRawData >> ok");
+    LOG_DEBUG("setupVideoStreamer >>> frameRawData >> ok");
     
     return true;
 }
@@ -221,24 +523,30 @@ bool VideoAndAudioObtainer::setupAudioStreamer()
     //    RAK5270 -> audio id: AV_CODEC_ID_AAC
     audioCodec = avcodec_find_decoder(formatCtx->streams[audioStreamIndex]->codecpar->codec_id);
     if (!audioCodec) { updateState(StreamErrorAvcodecFindDecoderAudio, -1); return false; }
-    logMessage("setupAudioStreamers >>> avcodec_find_decoder >> ok >> codec: " + std::to_string(formatCtx->streams[audioStreamIndex]->codecpar->codec_id));
+    LOG_DEBUG("setupAudioStreamers >>> avcodec_find_decoder >> ok >> codec: " + std::to_string(formatCtx->streams[audioStreamIndex]->codecpar->codec_id));
     
     /// Add this to allocate the context by codec
     audioDecCtx = avcodec_alloc_context3(audioCodec);
     retVal = avcodec_parameters_to_context(audioDecCtx, formatCtx->streams[audioStreamIndex]->codecpar);
     if (retVal < 0) { updateState(StreamErrorAvcodecParametersToContextAudio, retVal); return false; }
-    logMessage("setupAudioStreamers >>> avcodec_alloc_context3 >> ok");
+    LOG_DEBUG("setupAudioStreamers >>> avcodec_alloc_context3 >> ok");
     
     retVal = avcodec_open2(audioDecCtx, audioCodec, NULL);
     if (retVal < 0) { updateState(StreamErrorAvcodecOpen2Audio, retVal); return false; }
-    logMessage("setupAudioStreamers >>> avcodec_open2 >> ok");
+    LOG_DEBUG("setupAudioStreamers >>> avcodec_open2 >> ok");
     
     return true;
 }
 
 void VideoAndAudioObtainer::run()
 {
-    logMessage("run >>> started");
+    /// Stream is read again on the same thread after every successful reconnection
+    while (readStream()) {}
+}
+
+bool VideoAndAudioObtainer::readStream()
+{
+    LOG_INFO("run >>> started");
     
     if (stateType == StreamStateNotStarted) {
         stateType = StreamStateRunning;
@@ -248,61 +556,71 @@ void VideoAndAudioObtainer::run()
         updateState(stateType, -1);
         stop();
         closeStreams();
-        return;
+        return false;
     }
     
-    SharedMemory::getInstance()->unblockWritters();
+    sharedMemory->unblockWritters();
     isReadingNextFrame = true;
+    readBeginTime = std::chrono::steady_clock::now();
+    waitingForFirstFrame = true;
     
     /// Load first packet before while loop and every next we are reading at the end of while loop.
     /// This mechanism is used to take adventage of `interruptFunction` and break reading of frame if it exceeds time limit.
+    std::chrono::steady_clock::time_point readBegin = std::chrono::steady_clock::now();
     int avReadFrameResponse = av_read_frame(formatCtx, &packet);
+    sharedMemory->statistics.record(RobotStatistics::StagePacketRead, readBegin);
     
-    whileLoopIsRunning = true;
-    while (avReadFrameResponse >= 0 && isRunning()) {
+    while (avReadFrameResponse >= 0 && isRunning() && !streamParametersMismatch) {
         isReadingNextFrame = false;
         
+        if (realTimePacing) {
+            paceToPresentationTime(&packet);
+        }
+        packetTime = std::chrono::steady_clock::now();
+        
         if (packet.stream_index == videoStreamIndex) {
             /// decode video packet
-            logMessage("run >>> video packet");
+            LOG_TRACE("run >>> video packet");
+            sharedMemory->statistics.count(RobotStatistics::CounterVideoPackets);
             processVideoPacket(packet);
             
         } else if (packet.stream_index == audioStreamIndex && !audioBlocked) {
             /// decode audio packet
-            logMessage("run >>> audio packet");
+            LOG_TRACE("run >>> audio packet");
+            sharedMemory->statistics.count(RobotStatistics::CounterAudioPackets);
             processAudioPacket(packet);
         }
-        logMessage("run >>> packet processing finished");
+        LOG_TRACE("run >>> packet processing finished");
         
         av_packet_unref(&packet);
-        logMessage("run >>> av_packet_unref(&packet);");
+        LOG_TRACE("run >>> av_packet_unref(&packet);");
         
         /// Start measuring time for reading frame, to take action if it exceeds limit. @See interruptFunction function.
         beginTime = std::chrono::system_clock::now();
         isReadingNextFrame = true;
+        readBegin = std::chrono::steady_clock::now();
         avReadFrameResponse = av_read_frame(formatCtx, &packet);
-        logMessage("run >>> avReadFrameResponse = av_read_frame(formatCtx, &packet);");
+        sharedMemory->statistics.record(RobotStatistics::StagePacketRead, readBegin);
+        LOG_TRACE("run >>> avReadFrameResponse = av_read_frame(formatCtx, &packet);");
     }
-    whileLoopIsRunning = false;
     long long elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - beginTime).count();
     
-    logMessage("run >>> End of run()");
+    LOG_INFO("run >>> End of run()");
     
     closeStreams();
     
-    if (avReadFrameResponse < 0 && isRunning()) {
-        /// Error occurred
-        updateState(StreamStateTimeOutWhileReceivingFrame, avReadFrameResponse);
+    if ((avReadFrameResponse < 0 || streamParametersMismatch) && isRunning()) {
+        /// Error occurred, or stream has to be opened again with full probing
+        if (!streamParametersMismatch) {
+            updateState(StreamStateTimeOutWhileReceivingFrame, avReadFrameResponse);
+        }
         
-        logMessage("run >>> End of run error >>> reading time: " + std::to_string(elapsedTime) + " >>> trying to reconnect");
+        LOG_WARNING("run >>> End of run error >>> reading time: " + std::to_string(elapsedTime) + " >>> trying to reconnect");
         
         if (setupStreamers()) {
-            logMessage("run >>> Trying to reconnect >>> reset done");
-            
-            std::thread processThread(&VideoAndAudioObtainer::run, this);
-            processThread.detach();
-            
-//            run();
+            LOG_INFO("run >>> Trying to reconnect >>> reset done");
+            sharedMemory->statistics.count(RobotStatistics::CounterStreamReconnects);
+            return true;
         } else {
             /// Cannot recover connection
             updateState(StreamErrorCannotReconnect, -1);
@@ -312,46 +630,100 @@ void VideoAndAudioObtainer::run()
     } else {
         /// Stop called
         stop();
-        semaphore.signal();
     }
+    return false;
 }
 
 void VideoAndAudioObtainer::processVideoPacket(AVPacket packet_)
 {
     int check = 0;
+    RobotStatistics &statistics = sharedMemory->statistics;
 
+    std::chrono::steady_clock::time_point stageBegin = std::chrono::steady_clock::now();
     decode(videoCodecCtx, frame, &check, &packet_);
+    statistics.record(RobotStatistics::StageVideoDecode, stageBegin);
+
+    if (check != 0 && (videoCodecCtx->width != (int)sharedMemory->videoWidth || videoCodecCtx->height != (int)sharedMemory->videoHeight)) {
+        /// Frame buffers are sized by parameters from opening, which can come from a previous connection
+        LOG_WARNING("processVideoPacket >>> frame size " + std::to_string(videoCodecCtx->width) + "x" + std::to_string(videoCodecCtx->height) + " differs from opened stream >>> reconnecting");
+        forgetCachedStreamParameters(url);
+        streamParametersMismatch = true;
+        return;
+    }
 
     if (check != 0) {
+        stageBegin = std::chrono::steady_clock::now();
         imgConvertCtx = sws_getCachedContext(imgConvertCtx, videoCodecCtx->width, videoCodecCtx->height, videoCodecCtx->pix_fmt, videoCodecCtx->width, videoCodecCtx->height, AV_PIX_FMT_RGB24, SWS_BICUBIC, NULL, NULL, NULL);
         sws_scale(imgConvertCtx, frame->data, frame->linesize, 0, videoCodecCtx->height, frameRawData, pictureRgb->linesize);
+        statistics.record(RobotStatistics::StageConvert, stageBegin);
     
-        SharedMemory::getInstance()->writeFrame(frameRawData[0], frameSize);
+        stageBegin = std::chrono::steady_clock::now();
+        bool hasVisualPreferences = colorBlobs.process(frameRawData[0], videoCodecCtx->width, videoCodecCtx->height, visualPreferences);
+        if (hasVisualPreferences) {
+            statistics.record(RobotStatistics::StageColorBlobs, stageBegin);
+        }
+        
+        stageBegin = std::chrono::steady_clock::now();
+        sharedMemory->writeFrame(frameRawData[0], frameSize, packetTime, hasVisualPreferences ? visualPreferences : NULL);
+        statistics.record(RobotStatistics::StagePublish, stageBegin);
+        
+        if (waitingForFirstFrame) {
+            /// Time between opening and `start()` is not counted
+            waitingForFirstFrame = false;
+            statistics.record(RobotStatistics::StageFirstFrame, readBeginTime - openDuration);
+            LOG_INFO("processVideoPacket >>> first frame after " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - readBeginTime + openDuration).count()) + " ms" + (fastStarted ? " >>> fast start" : ""));
+        }
     } else {
-        logMessage("processVideoPacket >>> Error with decoding video packet");
+        statistics.count(RobotStatistics::CounterDecodeErrors);
+        LOG_WARNING("processVideoPacket >>> Error with decoding video packet");
     }
 }
 
 void VideoAndAudioObtainer::processAudioPacket(AVPacket packet_)
 {
     int check = 0;
+    RobotStatistics &statistics = sharedMemory->statistics;
 
+    std::chrono::steady_clock::time_point stageBegin = std::chrono::steady_clock::now();
     decode(audioDecCtx, frame, &check, &packet_);
+    statistics.record(RobotStatistics::StageAudioDecode, stageBegin);
     
-    logMessage("processAudioPacket >>> frame->nb_samples: " + std::to_string(frame->nb_samples));
-    logMessage("processAudioPacket >>> frame->sample_rate: " + std::to_string(frame->sample_rate));
-    logMessage("processAudioPacket >>> frame->linesize[0]: " + std::to_string(frame->linesize[0]));
-    logMessage("processAudioPacket >>> frame->pkt_size: " + std::to_string(frame->pkt_size));
-    logMessage("processAudioPacket >>> frame->channels: " + std::to_string(frame->channels));
+    LOG_TRACE("processAudioPacket >>> frame->nb_samples: " + std::to_string(frame->nb_samples));
+    LOG_TRACE("processAudioPacket >>> frame->sample_rate: " + std::to_string(frame->sample_rate));
+    LOG_TRACE("processAudioPacket >>> frame->linesize[0]: " + std::to_string(frame->linesize[0]));
+    LOG_TRACE("processAudioPacket >>> frame->pkt_size: " + std::to_string(frame->pkt_size));
+    LOG_TRACE("processAudioPacket >>> frame->channels: " + std::to_string(frame->channels));
     
-    SharedMemory::getInstance()->audioSampleRate = frame->sample_rate;
+    sharedMemory->audioSampleRate = frame->sample_rate;
     if (check != 0) {
         unsigned short bytesPerSample = (unsigned short)av_get_bytes_per_sample(AVSampleFormat(frame->format));
-        SharedMemory::getInstance()->writeAudio(frame->extended_data[0], (size_t)frame->nb_samples, bytesPerSample);
+        stageBegin = std::chrono::steady_clock::now();
+        sharedMemory->writeAudio(frame->extended_data[0], (size_t)frame->nb_samples, bytesPerSample);
+        statistics.record(RobotStatistics::StagePublish, stageBegin);
         
-        logMessage("processAudioPacket >>> bytesPerSample: " + std::to_string(bytesPerSample));
+        LOG_TRACE("processAudioPacket >>> bytesPerSample: " + std::to_string(bytesPerSample));
     } else {
-        logMessage("processAudioPacket >>> Error with decoding audio packet");
+        statistics.count(RobotStatistics::CounterDecodeErrors);
+        LOG_WARNING("processAudioPacket >>> Error with decoding audio packet");
+    }
+}
+
+void VideoAndAudioObtainer::paceToPresentationTime(AVPacket* packet_)
+{
+    if (packet_->pts == AV_NOPTS_VALUE) { return; }
+    
+    AVRational microseconds = { 1, 1000000 };
+    int64_t ptsUs = av_rescale_q(packet_->pts, formatCtx->streams[packet_->stream_index]->time_base, microseconds);
+    
+    if (pacingStartPts == AV_NOPTS_VALUE) {
+        pacingStartPts = ptsUs;
+        pacingStartTime = std::chrono::steady_clock::now();
+        return;
+    }
+    
+    std::chrono::steady_clock::time_point due = pacingStartTime + std::chrono::microseconds(ptsUs - pacingStartPts);
+    if (due > std::chrono::steady_clock::now() && sleepUntil(due)) {
+        sharedMemory->statistics.record(RobotStatistics::StageWakeUp, due);
     }
 }
 
@@ -384,8 +756,8 @@ void VideoAndAudioObtainer::closeStreams()
     if (stateType == StreamStateStopped) { return; }
     updateState(StreamStateStopped, -1);
     
-    logMessage("closeStreams >>> entered");
-    SharedMemory::getInstance()->blockWritters();
+    LOG_INFO("closeStreams >>> entered");
+    sharedMemory->blockWritters();
     
     av_frame_free(&frame);
     av_frame_free(&pictureRgb);
@@ -399,7 +771,7 @@ void VideoAndAudioObtainer::closeStreams()
     
     imgConvertCtx = NULL;
     
-    logMessage("closeStreams >>> finished");
+    LOG_INFO("closeStreams >>> finished");
 }
 
 void VideoAndAudioObtainer::updateState(StreamStateType stateType_, int errorCode)
@@ -411,7 +783,7 @@ void VideoAndAudioObtainer::updateState(StreamStateType stateType_, int errorCod
         av_strerror(errorCode, buf, sizeof(buf));
     }
     
-    logMessage("updateState >>> state: '" + std::string(getStreamStateMessage(stateType)) + "' >>> " + std::string(buf));
+    LOG_INFO("updateState >>> state: '" + std::string(getStreamStateMessage(stateType)) + "' >>> " + std::string(buf));
     if (errorCallback && stateType >= 100) {
         errorCallback(stateType);
     }
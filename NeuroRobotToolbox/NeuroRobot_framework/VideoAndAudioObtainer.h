@@ -14,7 +14,10 @@
 #include "Macros.h"
 #include "SharedMemory.h"
 #include "Log.h"
-#include "Core/Semaphore.h"
+#include "Vision/ColorBlobs.h"
+
+#include <chrono>
+#include <vector>
 
 #ifdef MATLAB
     #include "TypeDefs.h"
@@ -57,18 +60,67 @@ private:
     AVCodec* audioCodec = NULL;
     int audioStreamIndex = -1;
     
+    /// Storage for decoded data. Owned by `NeuroRobotManager`.
+    SharedMemory *sharedMemory = NULL;
+    
+    /// Used for `interruptFunction`.
+    std::chrono::system_clock::time_point beginTime;
+    
+    /// Used to derermine whether is process of reading new packet running.
+    bool isReadingNextFrame = false;
+    
+    /// Used to deremine if initial setup of streamers is done.
+    bool initDone = false;
+    
+    /// Time when the last packet was read from the stream.
+    std::chrono::steady_clock::time_point packetTime;
+    
+    /// Flag whether packets have to be delayed to their presentation time.
+    /// Set for local (replayed) sources, which can be read much faster than the robot streams.
+    bool realTimePacing = false;
+    
+    /// Wall time and presentation time (in us) of the first paced packet.
+    std::chrono::steady_clock::time_point pacingStartTime;
+    int64_t pacingStartPts = AV_NOPTS_VALUE;
+    
+    /// Flag whether stream is opened with minimal probing and parameters of the last connection to the same url.
+    /// Parameters are kept on disk, so they are used also after restart of the process.
+    bool fastStart = false;
+    
+    /// Whether current connection is opened with fast start
+    bool fastStarted = false;
+    
+    /// SDP of current connection, see `describeSession()`
+    std::string sessionDescription;
+    static const size_t sessionDescriptionCapacity = 16384;
+    
+    /// Set when decoded frame does not match parameters from opening, stream is then opened again with full probing
+    bool streamParametersMismatch = false;
+    
+    /// Duration of opening of current connection and start of its reading, for time to the first frame
+    std::chrono::steady_clock::duration openDuration = std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point readBeginTime;
+    bool waitingForFirstFrame = false;
+    
     bool tryingToReconnect = false;
     bool audioBlocked = false;
-    bool whileLoopIsRunning = false;
     std::string url = std::string();
     int frameSize = 0;
     
-    /// Sync mechanism
-    Semaphore semaphore;
+    /// Colour preferences of the last decoded frame
+    double visualPreferences[ColorBlobs::numberOfValues * ColorBlobs::numberOfEyes];
+    
+    /// Read packets until stream ends, fails or worker is stopped.
+    /// @return True if stream failed and was opened again, so it has to be read again
+    bool readStream();
     
     /// Close video and audio stream.
     void closeStreams();
     
+    /// Interrupt function used for determining if some critical point in code are blocking other parts more then expected.
+    /// @param ctx Pointer to `VideoAndAudioObtainer` object
+    static int interruptFunction(void* ctx);
+    
     
     int decode(AVCodecContext* avctx, AVFrame* frame, int* got_frame, AVPacket* pkt);
     
@@ -81,6 +133,22 @@ private:
     /// @return Whether is setup succeeded
     bool setupStreamers();
     
+    /// Open stream and probe its parameters.
+    /// @param minimalProbing Flag whether to probe only the first packets, used by fast start
+    /// @param knownSessionDescription Session of the last connection, probing is skipped if the source announces the same one
+    /// @param failedState Set to state of the failed step
+    /// @return 0 on success, error code of ffmpeg otherwise
+    int openStream(bool minimalProbing, const std::string &knownSessionDescription, StreamStateType *failedState);
+    
+    /// SDP of opened stream, created from parameters announced by the source before probing.
+    /// @return Empty string if it cannot be created
+    std::string describeSession();
+    
+    /// Fill parameters which minimal probing did not find from the last connection.
+    /// @param cachedParameters Parameters of all streams of the last connection
+    /// @return False if streams differ from the last connection
+    bool applyCachedParameters(const std::vector<AVCodecParameters *> &cachedParameters);
+    
     /// Making all setup for video stream.
     /// @return Whether is setup succeeded
     bool setupVideoStreamer();
@@ -89,6 +157,10 @@ private:
     /// @return Whether is setup succeeded
     bool setupAudioStreamer();
     
+    /// Sleep until presentation time of the packet, used only with `realTimePacing`.
+    /// @param packet_ Obtained packet
+    void paceToPresentationTime(AVPacket* packet_);
+    
     /// Try to decode packet and if succeed save decoded frame to shared memory.
     /// @param packet_ Obtained video packet
     void processVideoPacket(AVPacket packet_);
@@ -102,9 +174,12 @@ public:
     
     /// Init method.
     /// @param ipAddress IP address of robot
+    /// @param sharedMemory Storage for decoded video and audio data
     /// @param callback Callback in case or occured errors. Used to notify caller
     /// @param audioBlocked Flag whether audio both ways is blocked
-    VideoAndAudioObtainer(std::string ipAddress, StreamErrorOccurredCallback callback, bool audioBlocked);
+    /// @param url URL or file path of the stream. If empty, robot's RTSP url is created from `ipAddress`
+    /// @param fastStart Flag whether to open stream with minimal probing, using parameters of the last connection to the same url
+    VideoAndAudioObtainer(std::string ipAddress, SharedMemory *sharedMemory, StreamErrorOccurredCallback callback, bool audioBlocked, std::string url = "", bool fastStart = false);
     
     /// Destructor.
     ~VideoAndAudioObtainer();
@@ -114,6 +189,9 @@ public:
     
     /// Current state of the object.
     StreamStateType stateType = StreamStateNotInitialized;
+    
+    /// Colour preferences computed from every decoded frame, published with the frame once configured.
+    ColorBlobs colorBlobs;
 };
 
 
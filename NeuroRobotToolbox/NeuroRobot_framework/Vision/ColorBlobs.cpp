@@ -0,0 +1,306 @@
+//
+//  ColorBlobs.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+//  Resize along rows and masks use AVX2 when the compiler targets it (`-mavx2`, `/arch:AVX2`), otherwise scalar loops.
+//  Both do the same operations in the same order, so preferences do not depend on the instruction set.
+//
+
+#include "ColorBlobs.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
+
+/// Minimum value of colour channel in mask.
+const static float minimumIntensity = 50;
+
+/// Ratio to both other channels, per colour, red, green and blue.
+const static float colorRatios[3] = { 1.8f, 1.2f, 1.5f };
+
+/// Width used in temporal score, `process_visual_input.m` uses 227 for every network input size.
+const static double temporalWidth = 227;
+
+/// `sigmoid.m`
+static double sigmoid(double x, double c, double a)
+{
+    return 1 / (1 + std::exp(-a * (x - c)));
+}
+
+/// Bicubic kernel of `imresize`.
+static double cubic(double x)
+{
+    const double absx = std::fabs(x);
+    const double absx2 = absx * absx;
+    const double absx3 = absx2 * absx;
+    return (1.5 * absx3 - 2.5 * absx2 + 1) * (absx <= 1)
+        + (-0.5 * absx3 + 2.5 * absx2 - 4 * absx + 2) * ((1 < absx) && (absx <= 2));
+}
+
+void ColorBlobs::computeWeights(unsigned int inputSize, unsigned int outputSize, ResizeWeights &resizeWeights)
+{
+    const double scale = (double)outputSize / inputSize;
+    const bool antialiasing = scale < 1;
+    const double kernelWidth = antialiasing ? 4 / scale : 4;
+    const unsigned int taps = (unsigned int)std::ceil(kernelWidth) + 2;
+
+    std::vector<double> weights(outputSize * taps);
+    std::vector<unsigned int> indices(outputSize * taps);
+    for (unsigned int i = 0; i < outputSize; i++) {
+        /// Same arithmetic as `contributions()` of `imresize`, with 1-based coordinates
+        const double u = (i + 1) / scale + 0.5 * (1 - 1 / scale);
+        const double left = std::floor(u - kernelWidth / 2);
+        double sum = 0;
+        for (unsigned int k = 0; k < taps; k++) {
+            const double distance = u - (left + k);
+            const double weight = antialiasing ? scale * cubic(scale * distance) : cubic(distance);
+            weights[i * taps + k] = weight;
+            sum += weight;
+        }
+        for (unsigned int k = 0; k < taps; k++) {
+            weights[i * taps + k] /= sum;
+
+            /// Out of image indices are mirrored, `[1:n n:-1:1]`
+            const long long period = 2 * (long long)inputSize;
+            long long index = ((long long)left + k - 1) % period;
+            if (index < 0) { index += period; }
+            indices[i * taps + k] = (unsigned int)(index < inputSize ? index : period - 1 - index);
+        }
+    }
+
+    /// Taps which are zero for every output pixel are dropped, like `imresize` does it
+    std::vector<bool> used(taps, false);
+    for (unsigned int i = 0; i < outputSize; i++) {
+        for (unsigned int k = 0; k < taps; k++) {
+            if (weights[i * taps + k] != 0) { used[k] = true; }
+        }
+    }
+    resizeWeights.inputSize = inputSize;
+    resizeWeights.outputSize = outputSize;
+    resizeWeights.taps = (unsigned int)std::count(used.begin(), used.end(), true);
+    resizeWeights.weights.clear();
+    resizeWeights.indices.clear();
+    for (unsigned int i = 0; i < outputSize; i++) {
+        for (unsigned int k = 0; k < taps; k++) {
+            if (!used[k]) { continue; }
+            resizeWeights.weights.push_back(weights[i * taps + k]);
+            resizeWeights.indices.push_back(indices[i * taps + k]);
+        }
+    }
+}
+
+/// Adds weighted row to accumulator.
+static void accumulateRow(double *accumulator, const uint8_t *row, double weight, size_t length)
+{
+    size_t j = 0;
+#ifdef __AVX2__
+    const __m256d weights = _mm256_set1_pd(weight);
+    for (; j + 4 <= length; j += 4) {
+        int32_t packed;
+        memcpy(&packed, row + j, sizeof(int32_t));
+        const __m256d values = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+        _mm256_storeu_pd(&accumulator[j], _mm256_add_pd(_mm256_loadu_pd(&accumulator[j]), _mm256_mul_pd(weights, values)));
+    }
+#endif
+    for (; j < length; j++) {
+        accumulator[j] += weight * row[j];
+    }
+}
+
+/// Adds weighted row to accumulator.
+static void accumulateRow(double *accumulator, const float *row, double weight, size_t length)
+{
+    size_t j = 0;
+#ifdef __AVX2__
+    const __m256d weights = _mm256_set1_pd(weight);
+    for (; j + 4 <= length; j += 4) {
+        const __m256d values = _mm256_cvtps_pd(_mm_loadu_ps(row + j));
+        _mm256_storeu_pd(&accumulator[j], _mm256_add_pd(_mm256_loadu_pd(&accumulator[j]), _mm256_mul_pd(weights, values)));
+    }
+#endif
+    for (; j < length; j++) {
+        accumulator[j] += weight * row[j];
+    }
+}
+
+template <typename Pixel>
+void ColorBlobs::resizeRows(const Pixel *input, size_t inputStride, unsigned int width, const ResizeWeights &resizeWeights, float *output)
+{
+    const size_t rowSize = (size_t)width * 3;
+    accumulator.resize(rowSize);
+    for (unsigned int i = 0; i < resizeWeights.outputSize; i++) {
+        std::fill(accumulator.begin(), accumulator.end(), 0.0);
+        for (unsigned int k = 0; k < resizeWeights.taps; k++) {
+            const double weight = resizeWeights.weights[i * resizeWeights.taps + k];
+            accumulateRow(accumulator.data(), input + resizeWeights.indices[i * resizeWeights.taps + k] * inputStride, weight, rowSize);
+        }
+        float *outputRow = output + i * rowSize;
+        for (size_t j = 0; j < rowSize; j++) {
+            outputRow[j] = (float)accumulator[j];
+        }
+    }
+}
+
+template <typename Pixel>
+void ColorBlobs::resizeColumns(const Pixel *input, size_t inputStride, unsigned int height, const ResizeWeights &resizeWeights, float *output)
+{
+    const unsigned int taps = resizeWeights.taps;
+    for (unsigned int row = 0; row < height; row++) {
+        const Pixel *inputRow = input + row * inputStride;
+        float *outputRow = output + (size_t)row * resizeWeights.outputSize * 3;
+        for (unsigned int i = 0; i < resizeWeights.outputSize; i++) {
+            double sum[3] = { 0, 0, 0 };
+            for (unsigned int k = 0; k < taps; k++) {
+                const double weight = resizeWeights.weights[i * taps + k];
+                const Pixel *pixel = inputRow + resizeWeights.indices[i * taps + k] * 3;
+                sum[0] += weight * pixel[0];
+                sum[1] += weight * pixel[1];
+                sum[2] += weight * pixel[2];
+            }
+            outputRow[i * 3] = (float)sum[0];
+            outputRow[i * 3 + 1] = (float)sum[1];
+            outputRow[i * 3 + 2] = (float)sum[2];
+        }
+    }
+}
+
+void ColorBlobs::resizeEye(const uint8_t *frame, unsigned int frameWidth, unsigned int eyeIndex)
+{
+    const Cut &cut = cuts[eyeIndex];
+    const unsigned int height = cut.lastRow - cut.firstRow + 1;
+    const unsigned int width = cut.lastColumn - cut.firstColumn + 1;
+
+    /// First pass reads eye directly from frame, `single(eye_frame)` is exact
+    const uint8_t *eyeFrame = frame + ((size_t)(cut.firstRow - 1) * frameWidth + cut.firstColumn - 1) * 3;
+    const size_t frameStride = (size_t)frameWidth * 3;
+
+    /// `imresize` resizes the dimension which shrinks more first, rows if both shrink the same
+    const ResizeWeights &rows = rowWeights[eyeIndex];
+    const ResizeWeights &columns = columnWeights[eyeIndex];
+    resized.resize((size_t)outputHeight * outputWidth * 3);
+    if ((double)outputHeight / height <= (double)outputWidth / width) {
+        halfResized.resize((size_t)outputHeight * width * 3);
+        resizeRows(eyeFrame, frameStride, width, rows, halfResized.data());
+        resizeColumns(halfResized.data(), (size_t)width * 3, outputHeight, columns, resized.data());
+    } else {
+        halfResized.resize((size_t)height * outputWidth * 3);
+        resizeColumns(eyeFrame, frameStride, height, columns, halfResized.data());
+        resizeRows(halfResized.data(), (size_t)outputWidth * 3, outputWidth, rows, resized.data());
+    }
+
+    const size_t numberOfPixels = (size_t)outputHeight * outputWidth;
+    for (unsigned int color = 0; color < 3; color++) {
+        planes[color].resize(numberOfPixels);
+        for (size_t i = 0; i < numberOfPixels; i++) {
+            planes[color][i] = resized[i * 3 + color];
+        }
+    }
+}
+
+void ColorBlobs::threshold(unsigned int color, float ratio, float minimum)
+{
+    const size_t numberOfPixels = (size_t)outputHeight * outputWidth;
+    const float *main = planes[color].data();
+    const float *other1 = planes[(color + 1) % 3].data();
+    const float *other2 = planes[(color + 2) % 3].data();
+    mask.resize(numberOfPixels);
+
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256 ratios = _mm256_set1_ps(ratio);
+    const __m256 minimums = _mm256_set1_ps(minimum);
+    for (; i + 8 <= numberOfPixels; i += 8) {
+        const __m256 value = _mm256_loadu_ps(&main[i]);
+        __m256 inMask = _mm256_cmp_ps(value, _mm256_mul_ps(_mm256_loadu_ps(&other1[i]), ratios), _CMP_GT_OQ);
+        inMask = _mm256_and_ps(inMask, _mm256_cmp_ps(value, _mm256_mul_ps(_mm256_loadu_ps(&other2[i]), ratios), _CMP_GT_OQ));
+        inMask = _mm256_and_ps(inMask, _mm256_cmp_ps(value, minimums, _CMP_GE_OQ));
+        const int bits = _mm256_movemask_ps(inMask);
+        for (size_t j = 0; j < 8; j++) {
+            mask[i + j] = (uint8_t)((bits >> j) & 1);
+        }
+    }
+#endif
+    for (; i < numberOfPixels; i++) {
+        mask[i] = main[i] > other1[i] * ratio && main[i] > other2[i] * ratio && main[i] >= minimum;
+    }
+}
+
+bool ColorBlobs::largestBlob(uint32_t &numberOfPixels, double &meanColumn)
+{
+    /// Equal blobs are ordered like `bwconncomp` numbers them, so the first one is taken like `max` does it
+    const std::vector<ConnectedComponents::Component> &largest = blobs.label(mask.data(), outputWidth, outputHeight, 1);
+    if (largest.empty()) { return false; }
+
+    numberOfPixels = largest[0].area;
+    meanColumn = largest[0].centroidColumn + 1;
+    return true;
+}
+
+bool ColorBlobs::configure(const Cut cuts_[numberOfEyes], unsigned int height, unsigned int width, std::string &error)
+{
+    if (!height || !width) {
+        error = "Network input size must not be empty.";
+        return false;
+    }
+    for (unsigned int eyeIndex = 0; eyeIndex < numberOfEyes; eyeIndex++) {
+        const Cut &cut = cuts_[eyeIndex];
+        if (!cut.firstRow || !cut.firstColumn || cut.lastRow < cut.firstRow || cut.lastColumn < cut.firstColumn) {
+            error = "Cuts must be [first row, last row, first column, last column], 1-based.";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (unsigned int eyeIndex = 0; eyeIndex < numberOfEyes; eyeIndex++) {
+        const Cut &cut = cuts_[eyeIndex];
+        cuts[eyeIndex] = cut;
+        computeWeights(cut.lastRow - cut.firstRow + 1, height, rowWeights[eyeIndex]);
+        computeWeights(cut.lastColumn - cut.firstColumn + 1, width, columnWeights[eyeIndex]);
+    }
+    outputHeight = height;
+    outputWidth = width;
+    configured = true;
+    return true;
+}
+
+void ColorBlobs::disable()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    configured = false;
+}
+
+bool ColorBlobs::process(const uint8_t *frame, unsigned int frameWidth, unsigned int frameHeight, double values[numberOfValues * numberOfEyes])
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!configured || !frame) { return false; }
+    for (unsigned int eyeIndex = 0; eyeIndex < numberOfEyes; eyeIndex++) {
+        if (cuts[eyeIndex].lastRow > frameHeight || cuts[eyeIndex].lastColumn > frameWidth) { return false; }
+    }
+
+    for (unsigned int eyeIndex = 0; eyeIndex < numberOfEyes; eyeIndex++) {
+        resizeEye(frame, frameWidth, eyeIndex);
+
+        for (unsigned int color = 0; color < 3; color++) {
+            threshold(color, colorRatios[color], minimumIntensity);
+
+            double score = 0;
+            double temporalScore = 0;
+            uint32_t numberOfPixels;
+            double meanColumn;
+            if (largestBlob(numberOfPixels, meanColumn)) {
+                score = sigmoid(numberOfPixels, 1000, 0.01) * 50;
+                const double side = eyeIndex == 0 ? (temporalWidth - meanColumn) / temporalWidth : meanColumn / temporalWidth;
+                temporalScore = sigmoid(side, 0.95, 5) * score;
+            }
+            values[eyeIndex * numberOfValues + color * 2] = score;
+            values[eyeIndex * numberOfValues + color * 2 + 1] = temporalScore;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,122 @@
+//
+//  ColorBlobs.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ColorBlobs_h
+#define ColorBlobs_h
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ConnectedComponents.h"
+
+/// Colour preferences of both eyes, computed from decoded frame the way `process_visual_input.m` computes them.
+///
+/// Every eye is cut from the frame and resized to network input size like `imresize` does it (bicubic, antialiased).
+/// Red, green and blue masks are thresholded from the resized eye, and the largest 8-connected blob of every mask
+/// gives the score from its number of pixels and the temporal score from its mean column.
+/// Results are rows 1-6 of `vis_pref_vals`: red, red temporal, green, green temporal, blue, blue temporal.
+///
+/// `configure()` and `process()` can be called from different threads.
+class ColorBlobs {
+
+public:
+
+    const static unsigned int numberOfEyes = 2;
+
+    /// Rows of `vis_pref_vals` per eye, score and temporal score of every colour.
+    const static unsigned int numberOfValues = 6;
+
+    /// Part of frame seen by one eye, like `left_cut` and `right_cut`, 1-based and inclusive.
+    struct Cut {
+        unsigned int firstRow;
+        unsigned int lastRow;
+        unsigned int firstColumn;
+        unsigned int lastColumn;
+    };
+
+private:
+
+    /// Contributions of input pixels to every output pixel along one dimension, `taps` per output pixel.
+    struct ResizeWeights {
+        unsigned int inputSize = 0;
+        unsigned int outputSize = 0;
+        unsigned int taps = 0;
+        std::vector<unsigned int> indices;
+        std::vector<double> weights;
+    };
+
+    std::mutex mutex;
+
+    bool configured = false;
+    Cut cuts[numberOfEyes];
+    unsigned int outputHeight = 0;
+    unsigned int outputWidth = 0;
+    ResizeWeights rowWeights[numberOfEyes];
+    ResizeWeights columnWeights[numberOfEyes];
+
+    /// Buffers reused for every frame
+    std::vector<float> halfResized;
+    std::vector<float> resized;
+    std::vector<double> accumulator;
+    std::vector<float> planes[3];
+    std::vector<uint8_t> mask;
+    ConnectedComponents blobs;
+
+    /// Computes weights of MATLAB `imresize` bicubic kernel, antialiased when shrinking.
+    static void computeWeights(unsigned int inputSize, unsigned int outputSize, ResizeWeights &resizeWeights);
+
+    /// Resizes interleaved RGB image along rows (first dimension).
+    /// @param inputStride Distance between input rows in values
+    template <typename Pixel>
+    void resizeRows(const Pixel *input, size_t inputStride, unsigned int width, const ResizeWeights &resizeWeights, float *output);
+
+    /// Resizes interleaved RGB image along columns (second dimension).
+    /// @param inputStride Distance between input rows in values
+    template <typename Pixel>
+    static void resizeColumns(const Pixel *input, size_t inputStride, unsigned int height, const ResizeWeights &resizeWeights, float *output);
+
+    /// Cuts eye from frame and resizes it to `outputHeight` x `outputWidth` planes.
+    void resizeEye(const uint8_t *frame, unsigned int frameWidth, unsigned int eyeIndex);
+
+    /// Fills `mask` with pixels where `planes[color]` is above `ratio` times both other planes and at least `minimum`.
+    void threshold(unsigned int color, float ratio, float minimum);
+
+    /// Finds the largest 8-connected blob of `mask`.
+    /// @param meanColumn Mean column of blob, 1-based like in MATLAB
+    /// @return False if mask is empty
+    bool largestBlob(uint32_t &numberOfPixels, double &meanColumn);
+
+public:
+
+    ColorBlobs() {}
+    ColorBlobs(const ColorBlobs &) = delete;
+    ColorBlobs &operator=(const ColorBlobs &) = delete;
+
+    /// Sets eyes and network input size, weights of resize are computed once here.
+    /// @param cuts Part of frame of left and right eye
+    /// @param height Height of resized eye, `net_input_size(1)`
+    /// @param width Width of resized eye, `net_input_size(2)`
+    /// @param error Reason when settings are invalid
+    /// @return True on success
+    bool configure(const Cut cuts[numberOfEyes], unsigned int height, unsigned int width, std::string &error);
+
+    /// Stops computing preferences, `process()` returns false until next `configure()`.
+    void disable();
+
+    /// Computes preferences of both eyes.
+    /// @param frame Packed RGB frame, row after row
+    /// @param frameWidth Frame width in px
+    /// @param frameHeight Frame height in px
+    /// @param values `numberOfValues` x `numberOfEyes` column-major output, like `vis_pref_vals(1:6, :)`
+    /// @return False if not configured or eyes do not fit in frame
+    bool process(const uint8_t *frame, unsigned int frameWidth, unsigned int frameHeight, double values[numberOfValues * numberOfEyes]);
+};
+
+#endif /* ColorBlobs_h */
@@ -0,0 +1,180 @@
+//
+//  ConnectedComponents.cpp
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#include "ConnectedComponents.h"
+
+#include <algorithm>
+#include <cstring>
+
+/// Sum of 0, 1 ... `last`.
+static uint64_t sumTo(uint64_t last)
+{
+    return last * (last + 1) / 2;
+}
+
+/// Sum of squares of 0, 1 ... `last`.
+static uint64_t sumOfSquaresTo(uint64_t last)
+{
+    return last * (last + 1) * (2 * last + 1) / 6;
+}
+
+/// Larger components first, equal ones in `bwconncomp` order.
+static bool isLarger(const ConnectedComponents::Component &component, const ConnectedComponents::Component &other)
+{
+    return component.area != other.area ? component.area > other.area : component.firstIndex < other.firstIndex;
+}
+
+static bool isFirst(const ConnectedComponents::Component &component, const ConnectedComponents::Component &other)
+{
+    return component.firstIndex < other.firstIndex;
+}
+
+void ConnectedComponents::setConnectivity(unsigned int connectivity_)
+{
+    connectivity = connectivity_ == 4 ? 4 : 8;
+}
+
+void ConnectedComponents::encodeRow(const uint8_t *row, unsigned int width, uint32_t rowIndex)
+{
+    unsigned int x = 0;
+    while (x < width) {
+        /// Masks are mostly empty, 8 pixels are skipped at once
+        while (x + 8 <= width) {
+            uint64_t block;
+            memcpy(&block, row + x, sizeof(uint64_t));
+            if (block) { break; }
+            x += 8;
+        }
+        while (x < width && !row[x]) { x++; }
+        if (x == width) { break; }
+
+        Run run;
+        run.row = rowIndex;
+        run.begin = x;
+        while (x < width && row[x]) { x++; }
+        run.end = x;
+        runs.push_back(run);
+    }
+}
+
+uint32_t ConnectedComponents::findRoot(uint32_t run)
+{
+    while (parents[run] != run) {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+void ConnectedComponents::join(uint32_t run, uint32_t otherRun)
+{
+    const uint32_t root = findRoot(run);
+    const uint32_t otherRoot = findRoot(otherRun);
+
+    /// Root is always the first run of component
+    if (root < otherRoot) {
+        parents[otherRoot] = root;
+    } else if (otherRoot < root) {
+        parents[root] = otherRoot;
+    }
+}
+
+const std::vector<ConnectedComponents::Component> &ConnectedComponents::label(const uint8_t *mask, unsigned int width, unsigned int height, size_t maxComponents)
+{
+    runs.clear();
+    parents.clear();
+    componentOfRun.clear();
+    sums.clear();
+    components.clear();
+
+    /// Runs of previous row touch runs of current row if they overlap, or also if they touch diagonally
+    const uint32_t reach = connectivity == 8 ? 1 : 0;
+
+    size_t previousBegin = 0;
+    for (unsigned int y = 0; y < height; y++) {
+        const size_t currentBegin = runs.size();
+        encodeRow(mask + (size_t)y * width, width, y);
+        for (size_t i = currentBegin; i < runs.size(); i++) {
+            parents.push_back((uint32_t)i);
+        }
+
+        size_t j = previousBegin;
+        for (size_t i = currentBegin; i < runs.size(); i++) {
+            const Run &run = runs[i];
+            while (j < currentBegin && runs[j].end + reach <= run.begin) { j++; }
+            /// Last touching run can also touch next run of current row, so `j` stays on it
+            for (size_t k = j; k < currentBegin && runs[k].begin < run.end + reach; k++) {
+                join((uint32_t)i, (uint32_t)k);
+            }
+        }
+        previousBegin = currentBegin;
+    }
+
+    /// Roots come before other runs of their component, so components are numbered in one ascending pass
+    componentOfRun.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        const Run &run = runs[i];
+        const uint32_t root = findRoot((uint32_t)i);
+        if (root == i) {
+            componentOfRun[i] = (uint32_t)sums.size();
+            Sums empty;
+            memset(&empty, 0, sizeof(Sums));
+            empty.firstRow = run.row;
+            empty.firstColumn = UINT32_MAX;
+            empty.firstIndex = UINT64_MAX;
+            sums.push_back(empty);
+        } else {
+            componentOfRun[i] = componentOfRun[root];
+        }
+
+        Sums &component = sums[componentOfRun[i]];
+        const uint64_t length = run.end - run.begin;
+        const uint64_t columns = sumTo(run.end - 1) - (run.begin ? sumTo(run.begin - 1) : 0);
+        component.area += length;
+        component.columns += columns;
+        component.rows += length * run.row;
+        component.squaredColumns += sumOfSquaresTo(run.end - 1) - (run.begin ? sumOfSquaresTo(run.begin - 1) : 0);
+        component.squaredRows += length * run.row * run.row;
+        component.products += columns * run.row;
+        component.lastRow = run.row;
+        component.firstColumn = std::min(component.firstColumn, run.begin);
+        component.lastColumn = std::max(component.lastColumn, run.end - 1);
+        component.firstIndex = std::min(component.firstIndex, (uint64_t)run.begin * height + run.row);
+    }
+
+    for (const Sums &component : sums) {
+        Component result;
+        const double area = (double)component.area;
+        result.area = (uint32_t)component.area;
+        result.firstRow = component.firstRow;
+        result.lastRow = component.lastRow;
+        result.firstColumn = component.firstColumn;
+        result.lastColumn = component.lastColumn;
+        result.centroidRow = component.rows / area;
+        result.centroidColumn = component.columns / area;
+        result.rowVariance = component.squaredRows / area - result.centroidRow * result.centroidRow;
+        result.columnVariance = component.squaredColumns / area - result.centroidColumn * result.centroidColumn;
+        result.covariance = component.products / area - result.centroidRow * result.centroidColumn;
+        result.firstIndex = component.firstIndex;
+        components.push_back(result);
+    }
+
+    if (maxComponents && maxComponents < components.size()) {
+        std::partial_sort(components.begin(), components.begin() + maxComponents, components.end(), isLarger);
+        components.resize(maxComponents);
+    } else if (maxComponents) {
+        std::sort(components.begin(), components.end(), isLarger);
+    } else {
+        std::sort(components.begin(), components.end(), isFirst);
+    }
+    return components;
+}
+
+size_t ConnectedComponents::numberOfRuns() const
+{
+    return runs.size();
+}
@@ -0,0 +1,105 @@
+//
+//  ConnectedComponents.h
+//  NeuroRobot-Framework
+//
+//  Copyright © 2026 Backyard Brains. All rights reserved.
+//
+
+#ifndef ConnectedComponents_h
+#define ConnectedComponents_h
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Connected components of binary mask, like `bwconncomp` followed by `regionprops`, without label image.
+///
+/// Every row of mask is encoded as runs of set pixels, and touching runs of neighbouring rows are joined with union-find,
+/// so work depends on number of runs instead of number of pixels. Area, bounding box and moments are added per run
+/// in closed form. Buffers are kept between calls, so labelling masks of the same size does not allocate memory.
+class ConnectedComponents {
+
+public:
+
+    /// Statistics of one component, coordinates are 0-based pixel centres, row is y and column is x.
+    struct Component {
+        uint32_t area;
+
+        /// Bounding box, inclusive
+        uint32_t firstRow;
+        uint32_t lastRow;
+        uint32_t firstColumn;
+        uint32_t lastColumn;
+
+        double centroidRow;
+        double centroidColumn;
+
+        /// Central second moments, without 1/12 which `regionprops` adds for pixel area
+        double rowVariance;
+        double columnVariance;
+        double covariance;
+
+        /// Column-major index of first pixel, `bwconncomp` numbers components in this order
+        uint64_t firstIndex;
+    };
+
+private:
+
+    /// Set pixels of one row from `begin` to `end` (not included).
+    struct Run {
+        uint32_t row;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /// Sums of one component, exact integers.
+    struct Sums {
+        uint64_t area;
+        uint64_t columns;
+        uint64_t rows;
+        uint64_t squaredColumns;
+        uint64_t squaredRows;
+        uint64_t products;
+        uint32_t firstRow;
+        uint32_t lastRow;
+        uint32_t firstColumn;
+        uint32_t lastColumn;
+        uint64_t firstIndex;
+    };
+
+    unsigned int connectivity = 8;
+
+    std::vector<Run> runs;
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> componentOfRun;
+    std::vector<Sums> sums;
+    std::vector<Component> components;
+
+    /// Appends runs of one row.
+    void encodeRow(const uint8_t *row, unsigned int width, uint32_t rowIndex);
+
+    uint32_t findRoot(uint32_t run);
+
+    void join(uint32_t run, uint32_t otherRun);
+
+public:
+
+    ConnectedComponents() {}
+
+    /// Sets whether diagonal pixels are connected.
+    /// @param connectivity 8 like `bwconncomp` default, or 4
+    void setConnectivity(unsigned int connectivity);
+
+    /// Finds components of mask.
+    /// @param mask Row-major mask, nonzero for set pixel
+    /// @param width Mask width in px
+    /// @param height Mask height in px
+    /// @param maxComponents Only this many largest components are kept, ordered by area, 0 keeps all in `bwconncomp` order
+    /// @return Components, valid until next call
+    const std::vector<Component> &label(const uint8_t *mask, unsigned int width, unsigned int height, size_t maxComponents = 0);
+
+    /// Number of runs of last mask.
+    size_t numberOfRuns() const;
+};
+
+#endif /* ConnectedComponents_h */
@@ -7,12 +7,12 @@ if ~exist('NeuroRobot_MatlabBridge.mexw64', 'file') && ispc
     % Windows
     
     % FFMPEG - Libraries (*.dll) must be in root folder. So copy from libraries/windows/ffmpeg/lib/bin to root.
-    mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -Llibraries\windows\ffmpeg\bin -Ilibraries\windows\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
+    mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -Llibraries\windows\ffmpeg\bin -Ilibraries\windows\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibmat -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
 elseif ~isfile('NeuroRobot_MatlabBridge.mexmaci64') && ismac
     % macOS
     
     % FFMPEG - Libraries (*.dylib) must be in /usr/lib. If the error occurs, rebuild the ffmpeg.
-    mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp -Ilibraries/mac/boost/1.70.0/include -Llibraries/mac/boost/1.70.0/lib -Ilibraries/mac/ffmpeg/include -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale
+    mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -Ilibraries/mac/boost/1.70.0/include -Llibraries/mac/boost/1.70.0/lib -Ilibraries/mac/ffmpeg/include -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale -lmat
 end
 
 if ~exist('rak', 'var')
@@ -137,10 +137,23 @@ fprintf(fid, 'average send audio: %f\n', mean(sendAudioDurations));
 fprintf(fid, 'average receive serial: %f\n', mean(receiveSerialDurations));
 fprintf(fid, '\ntotal average: %f\n', mean(videoDurations) + mean(audioDurations) + mean(writeSerialDurations) + mean(sendAudioDurations) + mean(receiveSerialDurations));
 fprintf(fid, '\n');
+
+% Printing framework latencies [us]
+stats = rak.readStats();
+for i = 1:length(stats.stages)
+    stage = stats.stages(i);
+    fprintf(fid, '%s: count %d mean %.1f p50 %d p90 %d p99 %d p99.9 %d max %d\n', stage.name, stage.count, stage.meanUs, stage.p50Us, stage.p90Us, stage.p99Us, stage.p999Us, stage.maxUs);
+end
+counterNames = fieldnames(stats.counters);
+for i = 1:length(counterNames)
+    fprintf(fid, '%s: %d\n', counterNames{i}, stats.counters.(counterNames{i}));
+end
+fprintf(fid, '\n');
 fclose(fid);
 
+sampleRate = rak.readAudioSampleRate();
 rak.stop();
 pause(2);
-audiowrite('test.wav', audioMat, rak.readAudioSampleRate());
+audiowrite('test.wav', audioMat, sampleRate);
 close all;
 serialData;
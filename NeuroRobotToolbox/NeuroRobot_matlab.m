@@ -1,45 +1,175 @@
 classdef NeuroRobot_matlab
    
+    properties
+        % Handle of the robot inside mex, several robots can run in one MATLAB
+        handle
+    end
+    
     methods
         
-        % Constructor
-        function robotObject = NeuroRobot_matlab(ipAddress, port)
-            NeuroRobot_MatlabBridge( 'init' ,  ipAddress, port);
+        % Constructor, with fastStart the stream is opened with minimal probing and parameters of the last
+        % connection to the same robot, kept in Logs/cache between sessions, see firstFrame in readStats
+        function robotObject = NeuroRobot_matlab(ipAddress, port, fastStart)
+            if nargin < 3
+                fastStart = false;
+            end
+            robotObject.handle = NeuroRobot_MatlabBridge( 'init' ,  ipAddress, port, fastStart);
         end
         
         % Starts all threads
         function start(this)
-            NeuroRobot_MatlabBridge( 'start' );
+            NeuroRobot_MatlabBridge( 'start', this.handle );
+        end
+        
+        % Scheduling of worker threads used by the next start, struct with optional fields decode and socket,
+        % each a struct with cpu (-1 for any), priority (SCHED_FIFO 1-99, 0 for normal) and nice
+        % e.g. rak.setThreadSettings(struct('decode', struct('cpu', 2, 'priority', 50)))
+        function setThreadSettings(this, settings)
+            NeuroRobot_MatlabBridge( 'setThreadSettings', this.handle, settings );
         end
         
         % Reads last ~1sec of audio from shared memory
         function audioFrames = readAudio(this)
-            audioFrames = NeuroRobot_MatlabBridge( 'readAudio' );
+            audioFrames = NeuroRobot_MatlabBridge( 'readAudio', this.handle );
+        end
+        
+        % Reads last ~1sec of audio into preallocated single buffer, no new array is allocated
+        % Only the first numberOfSamples values are valid, newest samples are kept if the buffer is too small
+        % Warning: the buffer is written in place, so every variable sharing its data (e.g. b2 = b) changes too
+        function [audioFrames, numberOfSamples] = readAudioInto(this, audioFrames)
+            numberOfSamples = NeuroRobot_MatlabBridge( 'readAudio', this.handle, audioFrames );
         end
         
         % Reads current frame from shared memory
         function videoFrames = readVideo(this)
-            videoFrames = NeuroRobot_MatlabBridge( 'readVideo' );
+            videoFrames = NeuroRobot_MatlabBridge( 'readVideo', this.handle );
+        end
+        
+        % Reads current frame into preallocated uint8 buffer, no new array is allocated
+        % Warning: the buffer is written in place, so every variable sharing its data (e.g. b2 = b) changes too
+        function videoFrames = readVideoInto(this, videoFrames)
+            NeuroRobot_MatlabBridge( 'readVideo', this.handle, videoFrames );
+        end
+        
+        % Reads frame, audio, serial data and state in one call, as one consistent snapshot
+        % Optionally sends serial command (motors, LEDs) first and fills preallocated uint8 frame buffer in place,
+        % then frame field is empty and frameBytes tells whether the buffer was filled (0 if it is smaller than the frame)
+        % Warning: the buffer is written in place, so every variable sharing its data (e.g. b2 = b) changes too
+        % isRunning is read right after the snapshot, it is not a part of it
+        function state = step(this, command, videoBuffer)
+            if nargin < 2
+                state = NeuroRobot_MatlabBridge( 'step', this.handle );
+            elseif nargin < 3
+                state = NeuroRobot_MatlabBridge( 'step', this.handle, command );
+            else
+                state = NeuroRobot_MatlabBridge( 'step', this.handle, command, videoBuffer );
+            end
+        end
+        
+        % Computes colour preferences (vis_pref_vals rows 1-6) of both eyes from every frame, right after decoding
+        % Cuts are [first row, last row, first column, last column] of frame, size is net_input_size
+        % Without inputs preferences are not computed anymore
+        function setColorBlobs(this, leftCut, rightCut, inputSize)
+            if nargin < 4
+                NeuroRobot_MatlabBridge( 'setColorBlobs', this.handle );
+            else
+                NeuroRobot_MatlabBridge( 'setColorBlobs', this.handle, double(leftCut), double(rightCut), double(inputSize) );
+            end
+        end
+        
+        % Reads colour preferences of the last frame, 6 x 2, empty if they were not computed for it
+        function [visPrefVals, frameSequence] = readVisualPreferences(this)
+            [visPrefVals, frameSequence] = NeuroRobot_MatlabBridge( 'readVisualPreferences', this.handle );
+        end
+        
+        % Starts native loop which senses, steps the brain and sends motor commands every pulse_period on its own thread
+        % Brain is loaded from brain image (.nrb), settings is optional struct with fields pulse_period, ms_per_step,
+        % ltp_recency_th_in_sec, deadlines ([sense features brain motor] in ms), learning, bg_brain, threads, seed and
+        % loop thread cpu, priority and nice
+        % Colour preferences are taken from setColorBlobs, so it has to be set
+        function startLoop(this, brainFileName, settings)
+            if nargin < 3
+                NeuroRobot_MatlabBridge( 'startLoop', this.handle, brainFileName );
+            else
+                NeuroRobot_MatlabBridge( 'startLoop', this.handle, brainFileName, settings );
+            end
+        end
+        
+        % Stops native loop, returns its final statistics
+        function statistics = stopLoop(this)
+            statistics = NeuroRobot_MatlabBridge( 'stopLoop', this.handle );
+        end
+        
+        % Reads timing of native loop: steps, period overruns, skipped steps, jitter and step duration ([last; mean; max] ms),
+        % deadline overruns and durations ([last; mean; max] ms) of sense, features, brain and motor stage
+        function statistics = readLoopStatistics(this)
+            statistics = NeuroRobot_MatlabBridge( 'readLoopStatistics', this.handle );
+        end
+        
+        % Reads the last step of native loop: firing, motor command, colour preferences, distance and selected network
+        % With withNeurons also v and u, which waits for the running brain step to finish
+        function state = readLoopState(this, withNeurons)
+            if nargin < 2
+                withNeurons = 0;
+            end
+            state = NeuroRobot_MatlabBridge( 'readLoopState', this.handle, double(withNeurons) );
+        end
+        
+        % Reads connectome of native loop brain
+        function connectome = readLoopConnectome(this)
+            connectome = NeuroRobot_MatlabBridge( 'readLoopConnectome', this.handle );
+        end
+        
+        % Replaces connectome of native loop brain before its next step, plastic synapses keep what they learned
+        function setLoopConnectome(this, connectome)
+            NeuroRobot_MatlabBridge( 'setLoopConnectome', this.handle, full(double(connectome)) );
+        end
+        
+        % Reward of the next step of native loop
+        function setLoopReward(this, reward)
+            NeuroRobot_MatlabBridge( 'setLoopReward', this.handle, double(reward) );
+        end
+        
+        % Blocks until frame newer than lastSequence arrives or timeoutMs expires
+        % Returns sequence of the newest frame, equal to lastSequence on timeout
+        function sequence = waitForFrame(this, lastSequence, timeoutMs)
+            sequence = NeuroRobot_MatlabBridge( 'waitForFrame', this.handle, lastSequence, timeoutMs );
+        end
+        
+        % Reads latency of every stage (count, mean, max and p50/p90/p99/p99.9 in us) and counters of framework events
+        % With reset statistics start again after reading
+        function stats = readStats(this, reset)
+            if nargin < 2
+                reset = 0;
+            end
+            stats = NeuroRobot_MatlabBridge( 'readStats', this.handle, double(reset) );
         end
         
         % Stops all threads
         function stop(this)
-            NeuroRobot_MatlabBridge( 'stop' );
+            NeuroRobot_MatlabBridge( 'stop', this.handle );
         end
         
         % Queries whether the video/audio thread is running
         function isRunning = isRunning(this)
-            isRunning = NeuroRobot_MatlabBridge( 'isRunning' );
+            isRunning = NeuroRobot_MatlabBridge( 'isRunning', this.handle );
         end
         
         % Writes serial data through socket
         function writeSerial(this, data)
-            NeuroRobot_MatlabBridge( 'writeSerial' , data);
+            NeuroRobot_MatlabBridge( 'writeSerial', this.handle, data);
         end
         
         % Reads all serial data from shared memory
         function data = readSerial(this)
-            data = NeuroRobot_MatlabBridge( 'readSerial' );
+            data = NeuroRobot_MatlabBridge( 'readSerial', this.handle );
+        end
+        
+        % Reads serial data into preallocated uint8 buffer, no new array is allocated
+        % Only the first numberOfBytes values are valid, char(serialBuffer(1:numberOfBytes)) is the line
+        % Warning: the buffer is written in place, so every variable sharing its data (e.g. b2 = b) changes too
+        function [serialBuffer, numberOfBytes] = readSerialInto(this, serialBuffer)
+            numberOfBytes = NeuroRobot_MatlabBridge( 'readSerial', this.handle, serialBuffer );
         end
         
         % Sends audio data through socket
@@ -55,39 +185,39 @@ classdef NeuroRobot_matlab
             
             % Scale to 14bit
             data = int16(data * 8158);
-            NeuroRobot_MatlabBridge( 'sendAudio' , data);
+            NeuroRobot_MatlabBridge( 'sendAudio', this.handle, data);
         end
         
         % Sends audio data through socket
         function sendAudio2(this, data)
             % Scale to 14bit
             data = int16(data * 8158);
-            NeuroRobot_MatlabBridge( 'sendAudio' , data);
+            NeuroRobot_MatlabBridge( 'sendAudio', this.handle, data);
         end
         
         % Reads stream error
         function data = readStreamState(this)
-            data = NeuroRobot_MatlabBridge( 'readStreamState' );
+            data = NeuroRobot_MatlabBridge( 'readStreamState', this.handle );
         end
         
         % Reads socket error
         function data = readSocketState(this)
-            data = NeuroRobot_MatlabBridge( 'readSocketState' );
+            data = NeuroRobot_MatlabBridge( 'readSocketState', this.handle );
         end
         
         % Reads audio sample rate
         function data = readAudioSampleRate(this)
-            data = NeuroRobot_MatlabBridge( 'readAudioSampleRate' );
+            data = NeuroRobot_MatlabBridge( 'readAudioSampleRate', this.handle );
         end
 
         % Reads video width
         function data = readVideoWidth(this)
-            data = NeuroRobot_MatlabBridge( 'readVideoWidth' );
+            data = NeuroRobot_MatlabBridge( 'readVideoWidth', this.handle );
         end
 
         % Reads video height
         function data = readVideoHeight(this)
-            data = NeuroRobot_MatlabBridge( 'readVideoHeight' );
+            data = NeuroRobot_MatlabBridge( 'readVideoHeight', this.handle );
         end
     end
 end
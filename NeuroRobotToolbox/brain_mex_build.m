@@ -0,0 +1,9 @@
+
+%% Native brain simulation, no external libraries
+mex NeuroRobot_framework/NeuroRobot_BrainBridge.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework
+
+%% Optimized build with AVX2 kernels (macOS/Linux), no -mfma so results stay equal to MATLAB
+% mex CXXOPTIMFLAGS="-O3 -DNDEBUG -mavx2" NeuroRobot_framework/NeuroRobot_BrainBridge.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework
+
+%% Optimized build with AVX2 kernels (Windows)
+% mex COMPFLAGS="$COMPFLAGS /arch:AVX2" NeuroRobot_framework/NeuroRobot_BrainBridge.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework
@@ -0,0 +1,14 @@
+
+%% Convert all .mat brains to brain images (.nrb), loaded by load_or_initialize_brain without reading whole file
+% Needs NeuroRobot_BrainBridge, build it with brain_mex_build
+
+brain_directory = './Brains/*.mat';
+available_brains = dir(brain_directory);
+nbrains = size(available_brains, 1);
+for nbrain = 1:nbrains
+    brain_name = available_brains(nbrain).name(1:end-4);
+    load(strcat('./Brains/', brain_name, '.mat'))
+    
+    NeuroRobot_brain.saveImage(strcat('./Brains/', brain_name, '.nrb'), brain)
+    disp(num2str(nbrain / nbrains))
+end
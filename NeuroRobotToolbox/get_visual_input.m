@@ -1,9 +1,22 @@
 rak_fail = 0;
 try
     if rak_only
-        large_frame = rak_cam.readVideo();
-%         large_frame = flip(permute(reshape(large_frame, 3, 1280, 720),[3,2,1]), 3);
-        large_frame = permute(reshape(large_frame, 3, rak_cam.readVideoWidth(), rak_cam.readVideoHeight()),[3,2,1]);
+        % Frame was read into rak_frame_buffer by rak_cam.step in runtime_pulse_code.m
+        % Size of the frame is the one the stream has, not the requested one
+        if rak_state.width > 0 && rak_state.height > 0
+            rak_cam_w = rak_state.width;
+            rak_cam_h = rak_state.height;
+        end
+        if rak_state.frameBytes == 3 * rak_cam_w * rak_cam_h && numel(rak_frame_buffer) == rak_state.frameBytes
+%             large_frame = flip(permute(reshape(large_frame, 3, 1280, 720),[3,2,1]), 3);
+            large_frame = permute(reshape(rak_frame_buffer, 3, rak_cam_w, rak_cam_h),[3,2,1]);
+        else
+            large_frame = zeros(rak_cam_h, rak_cam_w, 3, 'uint8');
+        end
+        % Reuse the same buffer every step, it is resized only when the stream size changes
+        if numel(rak_frame_buffer) ~= 3 * rak_cam_w * rak_cam_h
+            rak_frame_buffer = zeros(1, 3 * rak_cam_w * rak_cam_h, 'uint8');
+        end
     elseif ~use_webcam
 %         large_frame = getsnapshot(rak_cam);
         large_frame = zeros(rak_cam_h, rak_cam_w, 3, 'uint8');
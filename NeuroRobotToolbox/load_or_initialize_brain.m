@@ -1,6 +1,16 @@
 %% Load or initialize brain
 if brain_selection_val > 1
-    load(strcat('./Brains/', load_name, '.mat'))
+    % Brain image is mapped instead of read, it is used while it is not older than .mat brain
+    mat_file = dir(strcat('./Brains/', load_name, '.mat'));
+    image_file = dir(strcat('./Brains/', load_name, '.nrb'));
+    try
+        if isempty(image_file) || (~isempty(mat_file) && image_file.datenum < mat_file.datenum)
+            error('Brain image is missing or old')
+        end
+        brain = NeuroRobot_brain.loadImage(strcat('./Brains/', load_name, '.nrb'));
+    catch
+        load(strcat('./Brains/', load_name, '.mat'))
+    end
     nneurons = brain.nneurons;
     neuron_xys = brain.neuron_xys;
     connectome = brain.connectome;
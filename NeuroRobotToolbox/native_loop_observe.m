@@ -0,0 +1,41 @@
+
+% Reads the last step of the native loop (rak_cam.startLoop), which senses, steps the brain and sends motor commands on its own
+% Only drawing and recording run here, reward is forwarded to the loop
+
+if reward
+    rak_cam.setLoopReward(reward);
+end
+
+loop_state = rak_cam.readLoopState(1);
+firing = loop_state.firing;
+v = loop_state.v;
+u = loop_state.u;
+if ~isempty(loop_state.visPrefVals)
+    vis_pref_vals(1:6, :) = loop_state.visPrefVals;
+end
+this_distance = loop_state.distance;
+motor_command(1, 1:4) = loop_state.motorCommand;
+
+% Plot brain
+xfiring = double(firing);
+if brain_view_tiled
+    for nnetwork = 1:nnetworks
+        these_neurons = network_ids == nnetwork;
+        temp1 = [1 - xfiring 1 - (xfiring * 0.25) 1 - xfiring];
+        network(nnetwork).draw_neuron_core.CData = temp1(these_neurons, :) .* neuron_cols(these_neurons, :);
+    end
+else
+    draw_neuron_core.CData = [1 - xfiring 1 - (xfiring * 0.25) 1 - xfiring] .* neuron_cols;
+end
+
+% Timing of the loop
+if nstep == nsteps_per_loop
+    loop_statistics = rak_cam.readLoopStatistics();
+    disp(horzcat('Native loop: step = ', num2str(loop_statistics.stepMs(2), 3), ' ms, jitter (mean/max) = ', num2str(loop_statistics.jitterMs(2), 3), '/', num2str(loop_statistics.jitterMs(3), 3), ...
+        ' ms, period overruns = ', num2str(loop_statistics.periodOverruns), ', stage overruns [sense features brain motor] = ', mat2str(loop_statistics.stageOverruns)))
+end
+
+% Stop reward
+if reward
+    reward = 0;
+end
@@ -26,6 +26,14 @@ save_data_and_commands = 1;
 save_brain_jpg = 0; % main only
 use_profile = 0;
 bg_brain = 1;
+native_brain = 0; % run update_brain simulation loop in NeuroRobot_BrainBridge mex (build with brain_mex_build)
+native_brain_threads = 1; % threads of native brain simulation, worth it for brains with thousands of neurons
+native_brain_single = 0; % float32 native brain simulation, faster, spikes differ from float64 within rounding
+native_brain_seed = []; % noise seed of native brain, empty for new seed every run, seed printed at start replays that run
+native_brain_matlab_noise = 0; % native brain uses MATLAB randn instead of its own noise, results equal to MATLAB loop
+native_color_blobs = 0; % colour preferences computed in NeuroRobot_MatlabBridge mex right after frame decoding (rak_only, build with rak_mex_build)
+native_loop = 0; % sensing, brain steps and motor commands run at pulse_period in NeuroRobot_MatlabBridge mex, MATLAB only draws and edits the brain (rak_only, build with rak_mex_build)
+native_brain_spike_retention = 10 * 60 * 1000; % ms of compressed spikes native brain keeps in memory, whole run goes to ./Data with save_data_and_commands
 draw_synapse_strengths = 1;
 draw_neuron_numbers = 1;
 manual_controls = 0;
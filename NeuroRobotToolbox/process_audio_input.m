@@ -2,7 +2,8 @@
 if rak_only
     
     % Get audio data from RAK
-    this_audio = double(rak_cam.readAudio());
+    % Audio was read by rak_cam.step in runtime_pulse_code.m, in the same snapshot as the frame
+    this_audio = double(rak_state.audio);
 %     disp(num2str(length(this_audio)))
 
     if isempty(this_audio)
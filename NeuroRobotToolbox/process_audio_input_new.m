@@ -2,7 +2,12 @@
 if rak_only
     
     % Get audio data from RAK
-    this_audio = double(rak_cam.readAudio());
+    % Reuse the same buffer every step instead of allocating a new array, 2 s at 32 kHz
+    if ~exist('rak_audio_buffer', 'var')
+        rak_audio_buffer = zeros(1, 64000, 'single');
+    end
+    [rak_audio_buffer, rak_audio_samples] = rak_cam.readAudioInto(rak_audio_buffer);
+    this_audio = double(rak_audio_buffer(1:rak_audio_samples));
     disp(num2str(length(this_audio)))
 
     if isempty(this_audio)
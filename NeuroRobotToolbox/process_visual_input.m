@@ -1,88 +1,101 @@
 
 % I2 = illumgray(large_frame, 5);
 
+% Colour preferences computed by NeuroRobot_MatlabBridge right after the frame was decoded
+native_vis_pref_vals = [];
+if native_color_blobs && rak_only && ~rak_fail
+    native_vis_pref_vals = rak_cam.readVisualPreferences();
+end
+if ~isempty(native_vis_pref_vals)
+    vis_pref_vals(1:6, :) = native_vis_pref_vals;
+end
+
 for ncam = 1:2
 
-    if ncam == 1
-        frame = single(left_eye_frame);
-    else
-        frame = single(right_eye_frame);
+    if isempty(native_vis_pref_vals) || use_cnn || use_rcnn
+        if ncam == 1
+            frame = single(left_eye_frame);
+        else
+            frame = single(right_eye_frame);
+        end
+
+        frame = imresize(frame, net_input_size);
     end
-    
-    frame = imresize(frame, net_input_size);
 
 %     if sum(I2)
 %         frame = chromadapt(frame, I2, 'ColorSpace', 'linear-rgb');
 %         frame = lin2rgb(frame);    
 %     end
 
-    % Red
-    red = frame(:,:,1) > frame(:,:,2) * 1.8 & frame(:,:,1) > frame(:,:,3) * 1.8;
-    red(frame(:,:,1) < 50) = 0;
+    if isempty(native_vis_pref_vals)
+        % Red
+        red = frame(:,:,1) > frame(:,:,2) * 1.8 & frame(:,:,1) > frame(:,:,3) * 1.8;
+        red(frame(:,:,1) < 50) = 0;
     
-    blob = bwconncomp(red);
-    if blob.NumObjects
-        [i, j] = max(cellfun(@numel,blob.PixelIdxList));
-        npx = i;
-        [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
-        this_score = sigmoid(npx, 1000, 0.01) * 50;
-        if ncam == 1
-            temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
+        blob = bwconncomp(red);
+        if blob.NumObjects
+            [i, j] = max(cellfun(@numel,blob.PixelIdxList));
+            npx = i;
+            [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
+            this_score = sigmoid(npx, 1000, 0.01) * 50;
+            if ncam == 1
+                temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
 %             temporal_score = ((227 - mean(x)) / 227) * this_score;
-        elseif ncam == 2
-            temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
+            elseif ncam == 2
+                temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
 %             temporal_score = (mean(x) / 227) * this_score;
-        end        
-    else
-        this_score = 0;
-        temporal_score = 0;
-    end
-    vis_pref_vals(1, ncam) = this_score;
-    vis_pref_vals(2, ncam) = temporal_score;
+            end        
+        else
+            this_score = 0;
+            temporal_score = 0;
+        end
+        vis_pref_vals(1, ncam) = this_score;
+        vis_pref_vals(2, ncam) = temporal_score;
     
-    % Green
-    green = frame(:,:,2) > frame(:,:,1) * 1.2 & frame(:,:,2) > frame(:,:,3) * 1.2;
-    green(frame(:,:,2) < 50) = 0;
+        % Green
+        green = frame(:,:,2) > frame(:,:,1) * 1.2 & frame(:,:,2) > frame(:,:,3) * 1.2;
+        green(frame(:,:,2) < 50) = 0;
     
-    blob = bwconncomp(green);
-    if blob.NumObjects
-        [i, j] = max(cellfun(@numel,blob.PixelIdxList));
-        npx = i;
-        [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
-        this_score = sigmoid(npx, 1000, 0.01) * 50;
-        if ncam == 1
-            temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
-        elseif ncam == 2
-            temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
-        end         
-    else
-        this_score = 0;
-        temporal_score = 0;
-    end
-    vis_pref_vals(3, ncam) = this_score;
-    vis_pref_vals(4, ncam) = temporal_score;
+        blob = bwconncomp(green);
+        if blob.NumObjects
+            [i, j] = max(cellfun(@numel,blob.PixelIdxList));
+            npx = i;
+            [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
+            this_score = sigmoid(npx, 1000, 0.01) * 50;
+            if ncam == 1
+                temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
+            elseif ncam == 2
+                temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
+            end         
+        else
+            this_score = 0;
+            temporal_score = 0;
+        end
+        vis_pref_vals(3, ncam) = this_score;
+        vis_pref_vals(4, ncam) = temporal_score;
     
-    % Blue
-    blue = frame(:,:,3) > frame(:,:,2) * 1.5 & frame(:,:,3) > frame(:,:,1) * 1.5;
-    blue(frame(:,:,3) < 50) = 0;
+        % Blue
+        blue = frame(:,:,3) > frame(:,:,2) * 1.5 & frame(:,:,3) > frame(:,:,1) * 1.5;
+        blue(frame(:,:,3) < 50) = 0;
     
-    blob = bwconncomp(blue);
-    if blob.NumObjects
-        [i, j] = max(cellfun(@numel,blob.PixelIdxList));
-        npx = i;
-        [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
-        this_score = sigmoid(npx, 1000, 0.01) * 50;
-        if ncam == 1
-            temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
-        elseif ncam == 2
-            temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
-        end        
-    else
-        this_score = 0;
-        temporal_score = 0;
+        blob = bwconncomp(blue);
+        if blob.NumObjects
+            [i, j] = max(cellfun(@numel,blob.PixelIdxList));
+            npx = i;
+            [y, x] = ind2sub(blob.ImageSize, blob.PixelIdxList{j});
+            this_score = sigmoid(npx, 1000, 0.01) * 50;
+            if ncam == 1
+                temporal_score = sigmoid(((227 - mean(x)) / 227), 0.95, 5) * this_score;
+            elseif ncam == 2
+                temporal_score = sigmoid((mean(x) / 227), 0.95, 5) * this_score;
+            end        
+        else
+            this_score = 0;
+            temporal_score = 0;
+        end
+        vis_pref_vals(5, ncam) = this_score;
+        vis_pref_vals(6, ncam) = temporal_score;
     end
-    vis_pref_vals(5, ncam) = this_score;
-    vis_pref_vals(6, ncam) = temporal_score;
 
     % Get object classification scores
     if use_cnn
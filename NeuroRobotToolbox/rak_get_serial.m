@@ -1,5 +1,6 @@
 
-serial_receive = rak_cam.readSerial();
+% Serial data was read by rak_cam.step in runtime_pulse_code.m, in the same snapshot as the frame
+serial_receive = rak_state.serial;
 % disp(serial_receive)
 % serial_receive
 serial_data = strsplit(serial_receive, ',');
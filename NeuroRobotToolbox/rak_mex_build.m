@@ -3,13 +3,16 @@
 % mex RAK_MatlabBridge.cpp RAK5206.cpp SharedMemory.cpp Log.cpp VideoAndAudioObtainer.cpp Socket.cpp -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -LC:\ffmpeg\bin -IC:\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
 
 %% Chris' build after 8/5/2020
-mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -LC:\ffmpeg\bin -IC:\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
+mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -LC:\ffmpeg\bin -IC:\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibmat -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
 
 %% Stanislav's build after 8/17/2019
 % mex -v RAK_MatlabBridge.cpp RAK5206.cpp SharedMemory.cpp Log.cpp VideoAndAudioObtainer.cpp Socket.cpp -IC:\Users\Stanislav\Downloads\boost_1_69_0-1\boost_1_69_0 -LC:\Users\Stanislav\Desktop\ffmpeg-djordje\install\bin -LC:\Users\Stanislav\Downloads\boost_1_69_0-1\boost_1_69_0\stage\lib -LC:\Users\Stanislav\Desktop\ffmpeg-djordje\install\lib -IC:\Users\Stanislav\Desktop\ffmpeg-djordje\install\include -lavcodec -lavformat -lavutil -lswscale -llibboost_system-vc140-mt-x64-1_69 -llibboost_chrono-vc140-mt-x64-1_69 -llibboost_date_time-vc140-mt-x64-1_69 -D_WIN32_WINNT=0x0601
 
 %% Djordje's macOS build after 8/5/2020
-% mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp -Ilibraries/mac/boost/1.70.0/include -Llibraries/mac/boost/1.70.0/lib -Ilibraries/mac/ffmpeg/include -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale
+% mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -Ilibraries/mac/boost/1.70.0/include -Llibraries/mac/boost/1.70.0/lib -Ilibraries/mac/ffmpeg/include -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale -lmat
 
 %% Djordje's Windows build after 8/5/2020
-% mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -Llibraries\windows\ffmpeg\bin -Ilibraries\windows\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
\ No newline at end of file
+% mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -IC:\boost_1_69_0 -LC:\boost_1_69_0\stage\lib -Llibraries\windows\ffmpeg\bin -Ilibraries\windows\ffmpeg\include -lavcodec -lavformat -lavutil -lswscale -llibmat -llibboost_system-vc141-mt-x64-1_69 -llibboost_chrono-vc141-mt-x64-1_69 -llibboost_filesystem-vc141-mt-x64-1_69 -D_WIN32_WINNT=0x0A00
+
+%% Linux build (boost and ffmpeg from system packages)
+% mex NeuroRobot_framework/NeuroRobot_MatlabBridge.cpp NeuroRobot_framework/NeuroRobotManager.cpp NeuroRobot_framework/SharedMemory.cpp NeuroRobot_framework/Log.cpp NeuroRobot_framework/Core/LogWriter.cpp NeuroRobot_framework/VideoAndAudioObtainer.cpp NeuroRobot_framework/Socket.cpp NeuroRobot_framework/Core/Semaphore.cpp NeuroRobot_framework/Core/ThreadPool.cpp NeuroRobot_framework/Core/ThreadSettings.cpp NeuroRobot_framework/Core/LatencyHistogram.cpp NeuroRobot_framework/Core/RobotStatistics.cpp NeuroRobot_framework/Vision/ColorBlobs.cpp NeuroRobot_framework/Vision/ConnectedComponents.cpp NeuroRobot_framework/Loop/ControlLoop.cpp NeuroRobot_framework/Batch/BrainFile.cpp NeuroRobot_framework/Batch/SensoryInput.cpp NeuroRobot_framework/Brain/BrainSimulation.cpp NeuroRobot_framework/Brain/NeuronKernels.cpp NeuroRobot_framework/Brain/NoiseGenerator.cpp NeuroRobot_framework/Brain/SynapticPlasticity.cpp NeuroRobot_framework/Brain/BasalGanglia.cpp NeuroRobot_framework/Brain/BrainImage.cpp NeuroRobot_framework/Brain/SpikeRecorder.cpp NeuroRobot_framework/Core/Barrier.cpp -INeuroRobot_framework -lboost_system -lboost_chrono -lboost_thread -lboost_filesystem -lavcodec -lavformat -lavutil -lswscale -lmat -lpthread
@@ -6,7 +6,7 @@
 % rak_cam.writeSerial('l:-50;r:-50;s:0;')
 % rak_cam.writeSerial('l:30;r:30;s:0;')
 
-large_frame = rak_cam.readVideo();
-large_frame = permute(reshape(large_frame, 3, rak_cam.readVideoWidth(), rak_cam.readVideoHeight()),[3,2,1]);
-this_audio = double(rak_cam.readAudio());
-serial_receive = rak_cam.readSerial();
+rak_state = rak_cam.step();
+large_frame = permute(reshape(rak_state.frame, 3, rak_state.width, rak_state.height),[3,2,1]);
+this_audio = double(rak_state.audio);
+serial_receive = rak_state.serial;
@@ -31,6 +31,13 @@ else
 end
 left_yx = [length(left_cut(1):left_cut(2)) length(left_cut(3):left_cut(4))];
 right_yx = [length(right_cut(1):right_cut(2)) length(right_cut(3):right_cut(4))];
+if rak_only && exist('rak_cam', 'var')
+    if native_color_blobs || native_loop
+        rak_cam.setColorBlobs(left_cut, right_cut, net_input_size);
+    else
+        rak_cam.setColorBlobs();
+    end
+end
 large_frame = zeros(rak_cam_h, rak_cam_w, 3, 'uint8');
 left_eye_frame = large_frame(left_cut(1):left_cut(2), left_cut(3):left_cut(4), :);
 right_eye_frame = large_frame(right_cut(1):right_cut(2), right_cut(3):right_cut(4), :);
@@ -53,6 +60,10 @@ end
 
 
 %% Prepare
+if exist('brain_engine', 'var') && ~isempty(brain_engine)
+    brain_engine.release(); % brain may have changed since last run, update_brain creates new native brain
+end
+brain_engine = [];
 run_button = 0;
 nstep = 0;
 vis_pref_vals = zeros(n_vis_prefs, 2);
@@ -95,6 +106,8 @@ if ~exist('rak_cam_h')
     rak_cam_h = 720;
     rak_cam_w = 1280; 
 end
+send_this = ''; % motor command sent by the next rak_cam.step
+rak_frame_buffer = zeros(1, 3 * rak_cam_w * rak_cam_h, 'uint8');
 
 if save_for_ai
     this_time = string(datetime('now', 'Format', 'yyyy-MM-dd-hh-mm-ss-ms'));
@@ -108,6 +121,7 @@ if save_data_and_commands
     this_time = string(datetime('now', 'Format', 'yyyy-MM-dd-hh-mm-ss-ms'));
 
     data_file_name = strcat('./Data/', this_time, '-', brain_name, '.mat');
+    spike_file_name = strcat('./Data/', this_time, '-', brain_name, '-spikes.nrs'); % Written by native brain, read with NeuroRobot_brain.readSpikeFile
     data = struct;
     data.computer_name = computer_name;
     data.start_time = this_time;
@@ -139,6 +153,18 @@ end
 %         end
 %     end
 % end
+native_loop_running = 0;
+if native_loop && rak_only && exist('rak_cam', 'var')
+    % Brain as it is now, the loop loads it from brain image
+    loop_brain = struct('nneurons', nneurons, 'a', a, 'b', b, 'c', c, 'd', d, 'connectome', connectome, 'da_connectome', da_connectome, ...
+        'neuron_contacts', neuron_contacts, 'vis_prefs', vis_prefs, 'dist_prefs', dist_prefs, 'network_ids', network_ids, 'bg_neurons', bg_neurons, 'network_drive', network_drive);
+    loop_brain_file_name = fullfile(tempdir, 'native_loop_brain.nrb');
+    NeuroRobot_brain.saveImage(loop_brain_file_name, loop_brain)
+    loop_settings = struct('pulse_period', pulse_period, 'ms_per_step', ms_per_step, 'ltp_recency_th_in_sec', ltp_recency_th_in_sec, 'bg_brain', bg_brain, 'threads', native_brain_threads, 'seed', native_brain_seed);
+    rak_cam.startLoop(loop_brain_file_name, loop_settings);
+    native_loop_running = 1;
+    disp('Native loop started, sensing, brain and motors run in NeuroRobot_MatlabBridge')
+end
 if exist('rak_pulse', 'var') && isvalid(rak_pulse)
     stop(rak_pulse)
     delete(rak_pulse)
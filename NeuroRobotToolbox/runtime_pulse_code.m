@@ -12,24 +12,49 @@ elseif lifetime >= 5 * 60 * 60
     disp(horzcat('Lifetime = ', num2str(round(lifetime/60/60)), ' hrs'))
 end
 
+%% Read robot
+% One step call sends the motor command of the previous pulse and reads frame, audio, serial data and state as one snapshot
+if rak_only
+    try
+        if native_loop_running
+            rak_state = rak_cam.step('', rak_frame_buffer); % native loop sends its own motor commands
+        else
+            rak_state = rak_cam.step(send_this, rak_frame_buffer);
+        end
+    catch
+        disp('Cannot step RAK')
+        rak_state = struct('width', 0, 'height', 0, 'frameBytes', 0, 'audio', single([]), 'serial', '', 'isRunning', false);
+    end
+end
+
 %% Get visual input
 get_visual_input
 
 %% Process visual input
 % disp('4')
-process_visual_input
+if ~native_loop_running
+    process_visual_input
+end
     
 %% Process audio input
 % disp('5')
-process_audio_input
+if ~native_loop_running
+    process_audio_input
+end
 
 %% Update brain
-update_brain
+if native_loop_running
+    native_loop_observe % brain stepped in the native loop, only its last step is read and drawn
+else
+    update_brain
+end
 draw_step
 
 %% Update motors
 % disp('3')
-update_motors
+if ~native_loop_running
+    update_motors
+end
 left_eye_frame = large_frame(left_cut(1):left_cut(2), left_cut(3):left_cut(4), :);
 right_eye_frame = large_frame(right_cut(1):right_cut(2), right_cut(3):right_cut(4), :);    
 show_left_eye.CData = left_eye_frame;
@@ -91,7 +116,7 @@ if nstep == nsteps_per_loop %% Happens again below
     end
     
 end
-if ~camera_present && rak_only && ~rak_cam.isRunning() % This screws with DIY no?
+if ~camera_present && rak_only && ~rak_state.isRunning % This screws with DIY no?
     disp('error: rak_cam exists but is not running')
     sound(flipud(gong), 8192 * 7)
     disp('solution 1: make sure you are connected to the correct wifi network')
@@ -113,6 +138,8 @@ if save_data_and_commands
         rec_timer = tic;
 %         data.firing(:,xstep) = firing;
 %         data.connectome(:,:,xstep) = connectome;
+        data.vis_pref_vals(:,:,xstep) = vis_pref_vals; % Sensor input, replayed by BrainBatch --input
+        data.this_distance(xstep) = this_distance;
         data.rec_time(xstep) = toc(rec_timer);
         data.timestamp(xstep) = string(datetime('now', 'Format', 'yyyy-MM-dd-hh-mm-ss-ms'));
     end
@@ -5,6 +5,14 @@ lifetime = toc(life_timer);
 disp(horzcat('Life time = ', num2str(round(lifetime/60)), ' min'))
 
 
+%% Stop native loop, it drives motors until stopped
+if exist('native_loop_running', 'var') && native_loop_running
+    loop_statistics = rak_cam.stopLoop();
+    native_loop_running = 0;
+    disp(horzcat('Native loop: ', num2str(loop_statistics.steps), ' steps, ', num2str(loop_statistics.periodOverruns), ' period overruns, ', num2str(loop_statistics.skippedSteps), ' skipped steps'))
+end
+
+
 %% Stop and reset motors
 if rak_only
 %     try % I think this is to avoid hard crash if runtime pulse detects
@@ -37,6 +45,10 @@ if save_data_and_commands
     data.stop_time  = this_time;
     data.brain = brain;
     data.xstep = xstep;
+    if native_brain && exist('brain_engine', 'var') && ~isempty(brain_engine)
+        brain_engine.setRecording(0); % Writes last spikes to spike_file_name
+        data.spike_file_name = spike_file_name;
+    end
     save(data_file_name, 'data')
 
     if run_button == 4 
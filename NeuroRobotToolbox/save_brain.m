@@ -39,6 +39,11 @@ brain.bg_neurons = bg_neurons;
 % Save brain
 brain_file_name = strcat('./Brains/', brain_name, '.mat');
 save(brain_file_name, 'brain')
+try
+    NeuroRobot_brain.saveImage(strcat('./Brains/', brain_name, '.nrb'), brain)
+catch
+    disp('Brain image not saved, build NeuroRobot_BrainBridge with brain_mex_build')
+end
 if exist('button_save', 'var') && isvalid(button_save) && ~restarting
     for ii = 1:-0.05:0.8
         button_save.BackgroundColor = [0.8 ii 0.8];
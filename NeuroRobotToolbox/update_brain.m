@@ -74,108 +74,166 @@ if nneurons
 
 
 % Run brain simulation
-    for t = 1:ms_per_step
+    if native_brain
+        if ~exist('brain_engine', 'var') || isempty(brain_engine)
+            brain_engine = NeuroRobot_brain();
+            brain_engine.setNumberOfThreads(native_brain_threads);
+            brain_engine.setSinglePrecision(native_brain_single);
+            if ~isempty(native_brain_seed)
+                brain_engine.setSeed(native_brain_seed);
+            end
+            disp(horzcat('Native brain noise seed: ', num2str(brain_engine.getSeed())))
+            
+            % Synapses are pushed once, learning runs in the native brain and clamps only plastic synapses,
+            % so the whole connectome is clamped here like every step of the MATLAB branch
+            connectome = min(connectome, max_w);
+            brain_engine.setNeurons(a, b, c, d, v, u);
+            brain_engine.setConnectome(connectome);
+            native_plastic_index = brain_engine.setPlasticity(da_connectome);
+            brain_engine.setBasalGanglia(network_ids, bg_neurons, network_drive, bg_brain);
+            if save_data_and_commands
+                brain_engine.setRecording(1, native_brain_spike_retention, spike_file_name);
+            else
+                brain_engine.setRecording(1, native_brain_spike_retention);
+            end
+        end
+        
+        % Neurons stay editable in MATLAB, they are cheap to push every step
+        brain_engine.setNeurons(a, b, c, d, v, u);
+        if native_brain_matlab_noise
+            [spikes_step, I_step] = brain_engine.step(ms_per_step, [vis_I dist_I audio_I], randn(nneurons, ms_per_step), reward);
+        else
+            [spikes_step, I_step] = brain_engine.step(ms_per_step, [vis_I dist_I audio_I], [], reward);
+        end
+        [v, u] = brain_engine.getState();
+    else
+        for t = 1:ms_per_step
 
-        % Add noise
-        I = 5 * randn(nneurons, 1);       
+            % Add noise
+            I = 5 * randn(nneurons, 1);       
 
-         % Find spiking neurons
-        fired_now = v >= 30;
-        spikes_step(fired_now, t) = 1;
+             % Find spiking neurons
+            fired_now = v >= 30;
+            spikes_step(fired_now, t) = 1;
 
-        % Reset spiking v to c
-        v(fired_now) = c(fired_now);
+            % Reset spiking v to c
+            v(fired_now) = c(fired_now);
 
-        % Adjust spiking u to d
-        u(fired_now) = u(fired_now) + d(fired_now);
+            % Adjust spiking u to d
+            u(fired_now) = u(fired_now) + d(fired_now);
 
-        % Add spiking synaptic weights to neuronal inputs
-        I = I + sum(connectome(fired_now,:), 1)';
+            % Add spiking synaptic weights to neuronal inputs
+            I = I + sum(connectome(fired_now,:), 1)';
 
-        % Add sensory input currents
-        I = I + vis_I + dist_I + audio_I;
-        I_step(:, t) = I;
+            % Add sensory input currents
+            I = I + vis_I + dist_I + audio_I;
+            I_step(:, t) = I;
 
-        % Update v
-        v = v + 0.5 * (0.04 * v.^2 + 5 * v + 140 - u + I);
-        v = v + 0.5 * (0.04 * v.^2 + 5 * v + 140 - u + I);
+            % Update v
+            v = v + 0.5 * (0.04 * v.^2 + 5 * v + 140 - u + I);
+            v = v + 0.5 * (0.04 * v.^2 + 5 * v + 140 - u + I);
 
-        % Update u
-        u = u + a .* (b .* v - u);
+            % Update u
+            u = u + a .* (b .* v - u);
 
-        % Avoid nans
-        v(isnan(v)) = c(isnan(v));
+            % Avoid nans
+            v(isnan(v)) = c(isnan(v));
 
+        end
+    
     end
     
     try
     % BG select
 %     disp('2')
-    this_network = 0;
-    if bg_brain
-        th = 50 + randn * 15;
+    if native_brain
+        % Selection and gating of spikes_step ran in the native step
+        [this_network, network_drive, activity_changes, down_neurons] = brain_engine.getSelection();
+        if bg_brain
+            if brain_view_tiled
+                for nnetwork = find(activity_changes == 1)'
+                    brain_multiax(nnetwork).ax.XColor = 'k';
+                    brain_multiax(nnetwork).ax.YColor = 'k';
+                    brain_multiax(nnetwork).ax.LineWidth = 4;
+                    brain_multiax(nnetwork).ax.Box = 'on';
+                end
+                for nnetwork = find(activity_changes == -1)'
+                    brain_multiax(nnetwork).ax.XColor = fig_bg_col;
+                    brain_multiax(nnetwork).ax.YColor = fig_bg_col;
+                    brain_multiax(nnetwork).ax.LineWidth = 0.05;
+                    brain_multiax(nnetwork).ax.Box = 'off';
+                end
+            end
+            drive_bar.YData = network_drive(2:end,1);
+        end
+    else
+        this_network = 0;
+        if bg_brain
+            th = 50 + randn * 15;
         
-        for nnetwork = 2:nnetworks
+            for nnetwork = 2:nnetworks
             
-            % Sensory boost
-            these_neurons = bg_neurons & network_ids == nnetwork;
-            if sum(these_neurons)
-                this_drive = sum(mean(I_step(these_neurons, :), 2)) * 0.5;
-                network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + this_drive;
-            end
+                % Sensory boost
+                these_neurons = bg_neurons & network_ids == nnetwork;
+                if sum(these_neurons)
+                    this_drive = sum(mean(I_step(these_neurons, :), 2)) * 0.5;
+                    network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + this_drive;
+                end
             
-            if network_drive(nnetwork, 2) == 0 % if the network is not active
-                network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + rand * 2; % add a little to the network's drive
-                if network_drive(nnetwork, 1) > th && ~sum(network_drive(:, 2) ~= 0) % if the network crosses threshold and no network is active
-                    network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + 150; % add a lot to the network's drive
-                    network_drive(nnetwork, 2) = 1; % mark the network as active
-                    if brain_view_tiled
-                        brain_multiax(nnetwork).ax.XColor = 'k';
-                        brain_multiax(nnetwork).ax.YColor = 'k';
-                        brain_multiax(nnetwork).ax.LineWidth = 4;
-                        brain_multiax(nnetwork).ax.Box = 'on';
+                if network_drive(nnetwork, 2) == 0 % if the network is not active
+                    network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + rand * 2; % add a little to the network's drive
+                    if network_drive(nnetwork, 1) > th && ~sum(network_drive(:, 2) ~= 0) % if the network crosses threshold and no network is active
+                        network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + 150; % add a lot to the network's drive
+                        network_drive(nnetwork, 2) = 1; % mark the network as active
+                        if brain_view_tiled
+                            brain_multiax(nnetwork).ax.XColor = 'k';
+                            brain_multiax(nnetwork).ax.YColor = 'k';
+                            brain_multiax(nnetwork).ax.LineWidth = 4;
+                            brain_multiax(nnetwork).ax.Box = 'on';
+                        end
                     end
-                end
-            elseif network_drive(nnetwork, 2) == 1 % if the network is active
-                other_nets = 1:nnetworks;
-                other_nets(nnetwork) = [];
-                network_drive(other_nets, 1) = network_drive(other_nets, 1) - rand * 2.5; % inhibit the other nets
-                network_drive(nnetwork, 1) = network_drive(nnetwork, 1) - rand * 3.5; % and withdraw some of the network's drive
-                network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + reward * 2.5; % tonic reward
-                if network_drive(nnetwork, 1) < th % if the network's drive falls below threshold
-                    network_drive(nnetwork, 1) = 0; % set its drive to zero
-                    network_drive(nnetwork, 2) = 0; % and set it as no longer active
-                    if brain_view_tiled
-                        brain_multiax(nnetwork).ax.XColor = fig_bg_col;
-                        brain_multiax(nnetwork).ax.YColor = fig_bg_col;
-                        brain_multiax(nnetwork).ax.LineWidth = 0.05;
-                        brain_multiax(nnetwork).ax.Box = 'off';               
+                elseif network_drive(nnetwork, 2) == 1 % if the network is active
+                    other_nets = 1:nnetworks;
+                    other_nets(nnetwork) = [];
+                    network_drive(other_nets, 1) = network_drive(other_nets, 1) - rand * 2.5; % inhibit the other nets
+                    network_drive(nnetwork, 1) = network_drive(nnetwork, 1) - rand * 3.5; % and withdraw some of the network's drive
+                    network_drive(nnetwork, 1) = network_drive(nnetwork, 1) + reward * 2.5; % tonic reward
+                    if network_drive(nnetwork, 1) < th % if the network's drive falls below threshold
+                        network_drive(nnetwork, 1) = 0; % set its drive to zero
+                        network_drive(nnetwork, 2) = 0; % and set it as no longer active
+                        if brain_view_tiled
+                            brain_multiax(nnetwork).ax.XColor = fig_bg_col;
+                            brain_multiax(nnetwork).ax.YColor = fig_bg_col;
+                            brain_multiax(nnetwork).ax.LineWidth = 0.05;
+                            brain_multiax(nnetwork).ax.Box = 'off';               
+                        end
                     end
+                    network_drive(nnetwork, 3) = network_drive(nnetwork, 3) + reward; 
                 end
-                network_drive(nnetwork, 3) = network_drive(nnetwork, 3) + reward; 
             end
-        end
-        network_drive(network_drive(:,1) < 0, 1) = 0; 
-        network_drive(network_drive(:,1) > 250, 1) = 250; 
+            network_drive(network_drive(:,1) < 0, 1) = 0; 
+            network_drive(network_drive(:,1) > 250, 1) = 250; 
 
-        this_network = find(network_drive(:, 2)); % find the active network
+            this_network = find(network_drive(:, 2)); % find the active network
         
-%         disp('3')
+    %         disp('3')
         
-        [~, j] = max(network_drive(1:nnetworks, 1)); % find the network with highest drive
-        if this_network ~= j % if the active network is not the network with the highest drive 
-            network_drive(:, 1) = network_drive(:, 1) - 30 * rand; % reduce the active network's drive significantly
-        end
+            [~, j] = max(network_drive(1:nnetworks, 1)); % find the network with highest drive
+            if this_network ~= j % if the active network is not the network with the highest drive 
+                network_drive(:, 1) = network_drive(:, 1) - 30 * rand; % reduce the active network's drive significantly
+            end
         
-        if isempty(this_network)
-            this_network = -1;
+            if isempty(this_network)
+                this_network = -1;
+            end
+            down_neurons = network_ids ~= this_network(1) & network_ids ~= 1;
+            spikes_step(down_neurons, :) = 0; % note, this means down neurons still spike to synapses during t
+            drive_bar.YData = network_drive(2:end,1);
         end
-        down_neurons = network_ids ~= this_network(1) & network_ids ~= 1;
-        spikes_step(down_neurons, :) = 0; % note, this means down neurons still spike to synapses during t
-        drive_bar.YData = network_drive(2:end,1);
+        spikes_step(bg_neurons & network_ids ~= this_network, :) = 0;
+        spikes_step(bg_neurons & network_ids == this_network, :) = 1;
+    
     end
-    spikes_step(bg_neurons & network_ids ~= this_network, :) = 0;
-    spikes_step(bg_neurons & network_ids == this_network, :) = 1;
     
     % Step data
     firing = sum(spikes_step, 2) > 0;
@@ -191,109 +249,148 @@ if nneurons
 %     msn_vals = msn_vals / 250;
 %     xfiring(logical(bg_neurons)) = msn_vals;
     
-    % Learning (STDP)
-    for nneuron = find(firing)' % for each spiking neuron
-        presynaptic_neurons = connectome(:, nneuron) > 0; % find its presynaptic neurons
-        recent_spikers = steps_since_last_spike < ltp_recency_th_in_steps; % find recently active neurons
-        if reward
-            plastic_synapses = da_connectome(:, nneuron, 1) > 0; % find plastic synapses
-        else
-            plastic_synapses = da_connectome(:, nneuron, 1) == 1; % find plastic synapses
-        end
-        these_neurons = presynaptic_neurons & recent_spikers & plastic_synapses; % reinforce these
-        da_connectome(these_neurons, nneuron, 3) = da_connectome(these_neurons, nneuron, 3) + 1; % update learning intensity vector
-        reinforcement = pulse_period * sigmoid(da_connectome(these_neurons, nneuron, 3), 100, 0.02) * 5 + (reward * 2 * pulse_period); % sigmoid learning
-        
-%         % until synapse-specific learning rate has been implemented
-%         xx = find(these_neurons);
-%         if ~isempty(xx)
-%             xx = find(xx == 25);
-%             if ~isempty(xx)
-%                 reinforcement(xx) = reinforcement(xx) * 0.5;
-%             end
-%         end
-%         %
-        
-        connectome(these_neurons, nneuron) = connectome(these_neurons, nneuron) + round(reinforcement * 100) / 100;
-        if sum(these_neurons)
-            for presyn = find(these_neurons)'
-                w = connectome(presyn, nneuron);
-                w = round(w);
-                if brain_view_tiled
-                    this_network = network_ids(presyn);
-                    network(this_network).plot_neuron_synapses(presyn, nneuron, 1).LineWidth = (abs(w) / 12) + 1;
-                    if draw_synapse_strengths
-                        try
-                            network(this_network).plot_neuron_synapses(presyn, nneuron, 3).String = num2str(w); 
-                        catch
-                            disp('Failed to edit network(this_network).plot_neuron_synapses String property in update_brain')
-                        end
-                    end                    
-                else
-                    if draw_synapses
-                        plot_neuron_synapses(presyn, nneuron, 1).LineWidth = (abs(w) / 12) + 1;
+    if native_brain
+        % Learning (STDP) and forgetting of plastic synapses, only synapses which rounded weight changed are redrawn
+        [changes, plastic_w, plastic_intensity] = brain_engine.learn(firing, steps_since_last_spike, reward, pulse_period, ltp_recency_th_in_steps, permanent_memory_th, max_w);
+        connectome(native_plastic_index) = plastic_w;
+        da_connectome(native_plastic_index + 2 * nneurons^2) = plastic_intensity;
+        for nchange = 1:size(changes, 1)
+            presyn = changes(nchange, 1);
+            postsyn = changes(nchange, 2);
+            w = round(changes(nchange, 3));
+            if changes(nchange, 4) == 1
+                line_scale = 12; % reinforcement
+            else
+                line_scale = 15; % forgetting
+            end
+            if brain_view_tiled
+                this_network = network_ids(presyn);
+                network(this_network).plot_neuron_synapses(presyn, postsyn, 1).LineWidth = (abs(w) / line_scale) + 1;
+                if draw_synapse_strengths
+                    try
+                        network(this_network).plot_neuron_synapses(presyn, postsyn, 3).String = num2str(w);
+                    catch
+                        disp('No string property error')
+                    end
+                end
+            else
+                if draw_synapses
+                    plot_neuron_synapses(presyn, postsyn, 1).LineWidth = (abs(w) / line_scale) + 1;
+                end
+                if draw_synapses && draw_synapse_strengths
+                    try
+                        plot_neuron_synapses(presyn, postsyn, 3).String = num2str(w);
+                    catch
+                        disp('No string property error')
                     end
-                    if draw_synapses && draw_synapse_strengths
-                        try
-                            plot_neuron_synapses(presyn, nneuron, 3).String = num2str(w);
-                        catch
-                            disp('Failed to edit plot_neuron_synapses String property in update_brain')                            
-                        end
-                    end                    
                 end
             end
         end
-    end
-%     disp('5')
-    connectome = min(connectome, max_w); % enforce max weight
-    da_connectome(:, :, 3) = da_connectome(:, :, 3) - 0.5;
-    xx = da_connectome(:, :, 3);
-    xx(xx < 0) = 0;
-    da_connectome(:, :, 3) = xx;
-
-    % Forgetting
-    for nneuron = 1:nneurons % for each neuron
-        plastic_synapses = find(da_connectome(nneuron, :, 1)); % find its plastic synapses
-        for postsyn = plastic_synapses % for each plastic synapse
-            current_w = connectome(nneuron, postsyn);
-            original_w = da_connectome(nneuron, postsyn, 2);
-            reinforcement = current_w - original_w;
-            if reinforcement
-                
-%                 % until I develop a way for highly active neurons to forget
-%                 if nneuron == 25
-%                     loss_delay = 50 - da_connectome(nneuron, postsyn, 3) * 2;
-%                 else
-                    loss_delay = steps_since_last_spike(nneuron) - ltp_recency_th_in_steps;
-                    loss_delay(loss_delay < 0) = 0;
-%                 end
-                
-                this_loss = floor(permanent_memory_th / reinforcement) * pulse_period * 0.1 * min(loss_delay/((1/pulse_period)*10), 1);
-                this_loss = min(this_loss, reinforcement);
-                connectome(nneuron, postsyn) = current_w - this_loss;
-                if this_loss
-                    w = connectome(nneuron, postsyn);
+    else
+        % Learning (STDP)
+        for nneuron = find(firing)' % for each spiking neuron
+            presynaptic_neurons = connectome(:, nneuron) > 0; % find its presynaptic neurons
+            recent_spikers = steps_since_last_spike < ltp_recency_th_in_steps; % find recently active neurons
+            if reward
+                plastic_synapses = da_connectome(:, nneuron, 1) > 0; % find plastic synapses
+            else
+                plastic_synapses = da_connectome(:, nneuron, 1) == 1; % find plastic synapses
+            end
+            these_neurons = presynaptic_neurons & recent_spikers & plastic_synapses; % reinforce these
+            da_connectome(these_neurons, nneuron, 3) = da_connectome(these_neurons, nneuron, 3) + 1; % update learning intensity vector
+            reinforcement = pulse_period * sigmoid(da_connectome(these_neurons, nneuron, 3), 100, 0.02) * 5 + (reward * 2 * pulse_period); % sigmoid learning
+        
+    %         % until synapse-specific learning rate has been implemented
+    %         xx = find(these_neurons);
+    %         if ~isempty(xx)
+    %             xx = find(xx == 25);
+    %             if ~isempty(xx)
+    %                 reinforcement(xx) = reinforcement(xx) * 0.5;
+    %             end
+    %         end
+    %         %
+        
+            connectome(these_neurons, nneuron) = connectome(these_neurons, nneuron) + round(reinforcement * 100) / 100;
+            if sum(these_neurons)
+                for presyn = find(these_neurons)'
+                    w = connectome(presyn, nneuron);
                     w = round(w);
                     if brain_view_tiled
-                        this_network = network_ids(nneuron); 
-                        network(this_network).plot_neuron_synapses(nneuron,postsyn,1).LineWidth = (abs(w) / 15) + 1;
+                        this_network = network_ids(presyn);
+                        network(this_network).plot_neuron_synapses(presyn, nneuron, 1).LineWidth = (abs(w) / 12) + 1;
                         if draw_synapse_strengths
                             try
-                                network(this_network).plot_neuron_synapses(nneuron, postsyn, 3).String = num2str(w);    
+                                network(this_network).plot_neuron_synapses(presyn, nneuron, 3).String = num2str(w); 
                             catch
-                                disp('No string property error')
+                                disp('Failed to edit network(this_network).plot_neuron_synapses String property in update_brain')
                             end
-                        end
+                        end                    
                     else
                         if draw_synapses
-                            plot_neuron_synapses(nneuron,postsyn,1).LineWidth = (abs(w) / 15) + 1;
+                            plot_neuron_synapses(presyn, nneuron, 1).LineWidth = (abs(w) / 12) + 1;
                         end
                         if draw_synapses && draw_synapse_strengths
                             try
-                                plot_neuron_synapses(nneuron, postsyn, 3).String = num2str(w);
+                                plot_neuron_synapses(presyn, nneuron, 3).String = num2str(w);
                             catch
-                                disp('No string property error')
-                            end                                
+                                disp('Failed to edit plot_neuron_synapses String property in update_brain')                            
+                            end
+                        end                    
+                    end
+                end
+            end
+        end
+    %     disp('5')
+        connectome = min(connectome, max_w); % enforce max weight
+        da_connectome(:, :, 3) = da_connectome(:, :, 3) - 0.5;
+        xx = da_connectome(:, :, 3);
+        xx(xx < 0) = 0;
+        da_connectome(:, :, 3) = xx;
+
+        % Forgetting
+        for nneuron = 1:nneurons % for each neuron
+            plastic_synapses = find(da_connectome(nneuron, :, 1)); % find its plastic synapses
+            for postsyn = plastic_synapses % for each plastic synapse
+                current_w = connectome(nneuron, postsyn);
+                original_w = da_connectome(nneuron, postsyn, 2);
+                reinforcement = current_w - original_w;
+                if reinforcement
+                
+    %                 % until I develop a way for highly active neurons to forget
+    %                 if nneuron == 25
+    %                     loss_delay = 50 - da_connectome(nneuron, postsyn, 3) * 2;
+    %                 else
+                        loss_delay = steps_since_last_spike(nneuron) - ltp_recency_th_in_steps;
+                        loss_delay(loss_delay < 0) = 0;
+    %                 end
+                
+                    this_loss = floor(permanent_memory_th / reinforcement) * pulse_period * 0.1 * min(loss_delay/((1/pulse_period)*10), 1);
+                    this_loss = min(this_loss, reinforcement);
+                    connectome(nneuron, postsyn) = current_w - this_loss;
+                    if this_loss
+                        w = connectome(nneuron, postsyn);
+                        w = round(w);
+                        if brain_view_tiled
+                            this_network = network_ids(nneuron); 
+                            network(this_network).plot_neuron_synapses(nneuron,postsyn,1).LineWidth = (abs(w) / 15) + 1;
+                            if draw_synapse_strengths
+                                try
+                                    network(this_network).plot_neuron_synapses(nneuron, postsyn, 3).String = num2str(w);    
+                                catch
+                                    disp('No string property error')
+                                end
+                            end
+                        else
+                            if draw_synapses
+                                plot_neuron_synapses(nneuron,postsyn,1).LineWidth = (abs(w) / 15) + 1;
+                            end
+                            if draw_synapses && draw_synapse_strengths
+                                try
+                                    plot_neuron_synapses(nneuron, postsyn, 3).String = num2str(w);
+                                catch
+                                    disp('No string property error')
+                                end                                
+                            end
                         end
                     end
                 end
@@ -305,7 +402,9 @@ if nneurons
         error('plasticity bug here')
     end
     % Store long activity
-    spikes_loop(:, 1 + (nstep - 1) * ms_per_step : nstep * ms_per_step) = spikes_step;
+    if ~native_brain
+        spikes_loop(:, 1 + (nstep - 1) * ms_per_step : nstep * ms_per_step) = spikes_step;
+    end
 
 %     disp('6')
     % Plot brain
@@ -335,7 +434,15 @@ if nneurons
 %     disp('7')
     
     % Plot activity
-    [y, x] = find(spikes_loop);
+    if native_brain
+        % Native brain records spikes compressed, last loop is placed where spikes_loop would have it
+        loop_ms = ms_per_step * nsteps_per_loop;
+        recorded_ms = brain_engine.getRecordedMs();
+        [y, x] = brain_engine.getSpikes(recorded_ms - loop_ms + 1, recorded_ms);
+        x = mod(nstep * ms_per_step - (recorded_ms - x) - 1, loop_ms) + 1;
+    else
+        [y, x] = find(spikes_loop);
+    end
     vplot.XData = x;
     vplot.YData = y;
     
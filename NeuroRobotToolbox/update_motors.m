@@ -155,12 +155,8 @@ end
 
 %% Sending serial to RAK
 if rak_only      
+    % Sent by rak_cam.step at the start of the next pulse, in the same call which reads the robot
     send_this = horzcat('l:', num2str(l_torque * l_dir), ';', 'r:', num2str(r_torque * r_dir),';', 's:', num2str(speaker_tone), ';');
-    try
-        rak_cam.writeSerial(send_this)
-    catch
-        disp('Cannot send RAK serial')
-    end
 elseif bluetooth_present && ~isequal(motor_command, prev_motor_command)
     bluetooth_send_motor_command
     prev_motor_command = motor_command;